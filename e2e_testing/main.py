@@ -7,9 +7,17 @@ import argparse
 import re
 import sys
 
+from torch_mlir_e2e_test.benchmarking import (
+    benchmark_results_to_json,
+    read_benchmark_json,
+    report_benchmarks,
+    run_benchmarks,
+    write_benchmark_json,
+)
+from torch_mlir_e2e_test.artifact_cache import ArtifactCache
 from torch_mlir_e2e_test.framework import run_tests
 from torch_mlir_e2e_test.reporting import report_results
-from torch_mlir_e2e_test.registry import GLOBAL_TEST_REGISTRY
+from torch_mlir_e2e_test.registry import GLOBAL_BENCHMARK_REGISTRY, GLOBAL_TEST_REGISTRY
 
 
 # Available test configs.
@@ -65,6 +73,33 @@ which make it easier to attach a debugger or get a stack trace.""")
     parser.add_argument("--crashing_tests_to_not_attempt_to_run_and_a_bug_is_filed",
                         metavar="TEST", type=str, nargs="+",
                         help="A set of tests to not attempt to run, since they crash and cannot be XFAILed.")
+    parser.add_argument("--artifact_cache", metavar="DIR",
+                        help="""Cache the artifacts compiled by the linalg, tosa and
+mhlo backends in DIR, keyed by their input IR, and reuse them across test
+processes and runs.""")
+    parser.add_argument("--benchmark",
+                        default=False,
+                        action="store_true",
+                        help="""Measure compile time, first-call latency and
+steady-state latency of each test instead of checking its results. Tests are
+always run sequentially in this mode.""")
+    parser.add_argument("--benchmark_suite",
+                        default=False,
+                        action="store_true",
+                        help="""Benchmark the production-scale workloads in
+torch_mlir_e2e_test/benchmark_suite instead of the tests. Implies --benchmark.""")
+    parser.add_argument("--benchmark_warmup", type=int, default=3,
+                        help="number of untimed runs before the steady-state runs")
+    parser.add_argument("--benchmark_repetitions", type=int, default=10,
+                        help="number of timed steady-state runs")
+    parser.add_argument("--benchmark_output", metavar="FILE",
+                        help="write the benchmark results to FILE as JSON")
+    parser.add_argument("--benchmark_baseline", metavar="FILE",
+                        help="""compare against the JSON results in FILE (as
+written by --benchmark_output) and fail on regressions""")
+    parser.add_argument("--benchmark_regression_threshold", type=float, default=0.1,
+                        help="""slowdown relative to the baseline, as a fraction,
+above which a metric counts as a regression""")
     return parser
 
 def main():
@@ -73,15 +108,19 @@ def main():
     all_test_unique_names = set(
         test.unique_name for test in GLOBAL_TEST_REGISTRY)
 
+    artifact_cache = None
+    if args.artifact_cache:
+        artifact_cache = ArtifactCache(args.artifact_cache)
+
     # Find the selected config.
     if args.config == "linalg":
-        config = LinalgOnTensorsBackendTestConfig(RefBackendLinalgOnTensorsBackend())
+        config = LinalgOnTensorsBackendTestConfig(RefBackendLinalgOnTensorsBackend(), artifact_cache)
         xfail_set = LINALG_XFAIL_SET
     if args.config == "tosa":
-        config = TosaBackendTestConfig(LinalgOnTensorsTosaBackend())
+        config = TosaBackendTestConfig(LinalgOnTensorsTosaBackend(), artifact_cache)
         xfail_set = all_test_unique_names - TOSA_PASS_SET
     if args.config == "mhlo":
-        config = MhloBackendTestConfig(LinalgOnTensorsMhloBackend())
+        config = MhloBackendTestConfig(LinalgOnTensorsMhloBackend(), artifact_cache)
         xfail_set = all_test_unique_names - MHLO_PASS_SET
     elif args.config == "native_torch":
         config = NativeTorchTestConfig()
@@ -96,8 +135,19 @@ def main():
         config = TorchDynamoTestConfig()
         xfail_set = TORCHDYNAMO_XFAIL_SET
 
+    registry = GLOBAL_TEST_REGISTRY
+    if args.benchmark_suite:
+        from torch_mlir_e2e_test.benchmark_suite import register_all_benchmarks
+        register_all_benchmarks()
+        registry = GLOBAL_BENCHMARK_REGISTRY
+        args.benchmark = True
+        all_test_unique_names = set(test.unique_name for test in registry)
+        # The xfail sets above only list tests. Benchmark workloads that a
+        # config cannot run are reported as failed benchmarks instead.
+        xfail_set = set()
+
     do_not_attempt = set(args.crashing_tests_to_not_attempt_to_run_and_a_bug_is_filed or [])
-    available_tests = [test for test in GLOBAL_TEST_REGISTRY if test.unique_name not in do_not_attempt]
+    available_tests = [test for test in registry if test.unique_name not in do_not_attempt]
     if args.crashing_tests_to_not_attempt_to_run_and_a_bug_is_filed is not None:
         for arg in args.crashing_tests_to_not_attempt_to_run_and_a_bug_is_filed:
             if arg not in all_test_unique_names:
@@ -118,6 +168,27 @@ def main():
             print(test.unique_name)
         sys.exit(1)
 
+    if args.benchmark:
+        # Tests that are expected to fail are not benchmarked.
+        skipped = [test.unique_name for test in tests
+                   if test.unique_name in xfail_set]
+        tests = [test for test in tests if test.unique_name not in xfail_set]
+        results = run_benchmarks(tests, config, args.benchmark_warmup,
+                                 args.benchmark_repetitions, args.verbose,
+                                 isolate=not args.sequential)
+        results = benchmark_results_to_json(results, args.config,
+                                            args.benchmark_warmup,
+                                            args.benchmark_repetitions)
+        if args.benchmark_output:
+            write_benchmark_json(results, args.benchmark_output)
+        baseline = None
+        if args.benchmark_baseline:
+            baseline = read_benchmark_json(args.benchmark_baseline)
+        failed = report_benchmarks(results, baseline,
+                                   args.benchmark_regression_threshold,
+                                   args.verbose, skipped)
+        sys.exit(1 if failed else 0)
+
     # Run the tests.
     results = run_tests(tests, config, args.sequential, args.verbose)
 
@@ -53,6 +53,10 @@ TORCHDYNAMO_XFAIL_SET = {
     # %6:4 = torch.operator "aten._embedding_bag_forward_only"(%1, %3, %5, %false, %int0, %false, %none, %false, %int-1) : (!torch.tensor<*,f32>, !torch.tensor<*,si64>, !torch.tensor<*,si64>, !torch.bool, !torch.int, !torch.bool, !torch.none, !torch.bool, !torch.int) -> (!torch.tensor, !torch.tensor, !torch.tensor, !torch.tensor)
     # See also: https://github.com/pytorch/torchdynamo/issues/327
     "AtenEmbeddingBagSumExample_basic",
+    "AtenEmbeddingBagMeanExample_basic",
+    "AtenEmbeddingBagMaxExample_basic",
+    "AtenEmbeddingBagMaxEmptyBagExample_basic",
+    "AtenEmbeddingBagPerSampleWeightsExample_basic",
     # %1 = torch.operator "aten.scalar_tensor"(%float8.000000e00, %int6, %int0, %cpu, %none) : (!torch.float, !torch.int, !torch.int, !torch.Device, !torch.none) -> !torch.tensor
     "ElementwiseWhereScalarModule_basic",
     "ElementwiseWhereScalarOtherModule_basic",
@@ -760,6 +764,10 @@ LTC_XFAIL_SET = {
     "UnsafeViewCollapseDynamicWithAtenSizeIntModule_basic",
     "ViewCollapseDynamicWithAtenSizeIntModule_basic",
     "AtenEmbeddingBagSumExample_basic",
+    "AtenEmbeddingBagMeanExample_basic",
+    "AtenEmbeddingBagMaxExample_basic",
+    "AtenEmbeddingBagMaxEmptyBagExample_basic",
+    "AtenEmbeddingBagPerSampleWeightsExample_basic",
     "Aten_EmbeddingBagExample_basic",
     "ElementwiseRemainderScalarModule_Int_Float_basic",
     "ElementwiseRemainderScalarModule_Float_basic",
@@ -0,0 +1,35 @@
+/*===-- torch-mlir-c/Telemetry.h - Compile-time telemetry ---------*- C -*-===*\
+|*                                                                            *|
+|* Part of the LLVM Project, under the Apache License v2.0 with LLVM          *|
+|* Exceptions.                                                                *|
+|* See https://llvm.org/LICENSE.txt for license information.                  *|
+|* SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception                    *|
+|*                                                                            *|
+\*===----------------------------------------------------------------------===*/
+
+#ifndef TORCHMLIR_C_TELEMETRY_H
+#define TORCHMLIR_C_TELEMETRY_H
+
+#include "mlir-c/IR.h"
+#include "mlir-c/Support.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Sets the callback that receives the telemetry records of the passes that
+ * run in `context`, such as one record per iteration of
+ * torch-lower-to-backend-contract. Each record is passed to `callback` as a
+ * serialized JSON object, along with `userData`. Passing a null `callback`
+ * disables telemetry, which must be done before `context` is destroyed.
+ */
+MLIR_CAPI_EXPORTED void
+torchMlirContextSetTelemetryCallback(MlirContext context,
+                                     MlirStringCallback callback,
+                                     void *userData);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TORCHMLIR_C_TELEMETRY_H
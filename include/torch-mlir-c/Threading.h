@@ -0,0 +1,32 @@
+/*===-- torch-mlir-c/Threading.h - Threading configuration --------*- C -*-===*\
+|*                                                                            *|
+|* Part of the LLVM Project, under the Apache License v2.0 with LLVM          *|
+|* Exceptions.                                                                *|
+|* See https://llvm.org/LICENSE.txt for license information.                  *|
+|* SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception                    *|
+|*                                                                            *|
+\*===----------------------------------------------------------------------===*/
+
+#ifndef TORCHMLIR_C_THREADING_H
+#define TORCHMLIR_C_THREADING_H
+
+#include "mlir-c/IR.h"
+#include "mlir-c/Support.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Sets the number of threads that passes run on in `context`.
+ * A value of 1 disables multithreading, and a value of 0 uses all the hardware
+ * threads. Contexts configured with the same number of threads share one
+ * thread pool, which is kept alive until the process exits.
+ */
+MLIR_CAPI_EXPORTED void torchMlirContextSetNumThreads(MlirContext context,
+                                                      intptr_t numThreads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TORCHMLIR_C_THREADING_H
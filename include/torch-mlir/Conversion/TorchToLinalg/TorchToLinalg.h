@@ -18,6 +18,9 @@
 namespace mlir {
 namespace torch {
 std::unique_ptr<OperationPass<func::FuncOp>> createConvertTorchToLinalgPass();
+std::unique_ptr<OperationPass<func::FuncOp>>
+createConvertTorchToLinalgPass(bool useNhwcLayout);
+std::unique_ptr<OperationPass<func::FuncOp>> createPropagateLinalgLayoutPass();
 }
 } // namespace mlir
 
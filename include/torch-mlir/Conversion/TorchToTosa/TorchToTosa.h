@@ -17,6 +17,7 @@
 namespace mlir {
 namespace torch {
 std::unique_ptr<OperationPass<func::FuncOp>> createConvertTorchToTosaPass();
+std::unique_ptr<OperationPass<func::FuncOp>> createPropagateTosaLayoutPass();
 }
 } // namespace mlir
 
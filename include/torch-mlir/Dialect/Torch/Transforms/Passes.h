@@ -57,6 +57,20 @@ struct TorchLoweringPipelineOptions
   ListOption<std::string> backendLegalOps{
       *this, "backend-legal-ops",
       llvm::cl::desc("List of ops to be considered legal for the backend.")};
+  // If this option is true, weights are passed to the public functions as
+  // arguments instead of being inlined into them as literals.
+  Option<bool> liftWeightsToArguments{
+      *this, "lift-weights-to-arguments",
+      llvm::cl::desc("Pass weights as function arguments."),
+      llvm::cl::init(false)};
+  // The minimum number of elements of a weight for it to be lifted when
+  // `liftWeightsToArguments` is true. Smaller weights are still inlined, which
+  // lets the compiler simplify using their values.
+  Option<int64_t> liftWeightsMinElements{
+      *this, "lift-weights-min-elements",
+      llvm::cl::desc(
+          "Minimum number of elements of a weight passed as an argument."),
+      llvm::cl::init(1024)};
 };
 
 /// Creates a pipeline that lowers the object graph IR that is produced by
@@ -77,6 +91,16 @@ void createTorchFunctionToTorchBackendPipeline(
 void createTorchSimplificationPipeline(
     OpPassManager &pm, const TorchLoweringPipelineOptions &options);
 
+/// A named part of the simplification pipeline.
+struct TorchSimplificationStage {
+  StringRef name;
+  void (*build)(OpPassManager &pm, const TorchLoweringPipelineOptions &options);
+};
+
+/// Returns the stages that make up the simplification pipeline, in order.
+/// LowerToBackendContract runs them one at a time to time each of them.
+ArrayRef<TorchSimplificationStage> getTorchSimplificationStages();
+
 /// Creates a pipeline that refines shapes of tensor operations in the program.
 void createTorchShapeRefinementPipeline(OpPassManager &pm);
 
@@ -89,6 +113,9 @@ std::unique_ptr<OperationPass<func::FuncOp>> createRefineTypesPass();
 
 std::unique_ptr<OperationPass<ModuleOp>> createInlineGlobalSlotsPass();
 
+std::unique_ptr<OperationPass<ModuleOp>>
+createLiftWeightsToArgumentsPass(int64_t minElements);
+
 std::unique_ptr<OperationPass<func::FuncOp>> createReduceOpVariantsPass();
 
 std::unique_ptr<OperationPass<func::FuncOp>> createMaximizeValueSemanticsPass();
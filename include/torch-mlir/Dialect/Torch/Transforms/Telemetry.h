@@ -0,0 +1,51 @@
+//===------------------------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef TORCHMLIR_DIALECT_TORCH_TRANSFORMS_TELEMETRY_H
+#define TORCHMLIR_DIALECT_TORCH_TRANSFORMS_TELEMETRY_H
+
+#include "mlir/IR/MLIRContext.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/JSON.h"
+
+#include <functional>
+
+namespace mlir {
+namespace torch {
+namespace Torch {
+
+/// Receives the telemetry records of the passes that run in a context. Each
+/// record is a JSON object whose "event" member says what it describes.
+using TelemetryCallback = std::function<void(const llvm::json::Object &)>;
+
+/// Sets the callback that receives the telemetry records of `context`, or
+/// disables telemetry for `context` if `callback` is empty. Passes only
+/// collect telemetry while a callback is set.
+void setTelemetryCallback(MLIRContext *context, TelemetryCallback callback);
+
+/// Returns true if a telemetry callback is set for `context`.
+bool isTelemetryEnabled(MLIRContext *context);
+
+/// Sends `record` to the telemetry callback of `context`, if any.
+void emitTelemetry(MLIRContext *context, llvm::json::Object record);
+
+/// Adds to the number of times each op was decomposed by DecomposeComplexOps,
+/// keyed by op name. This can be called concurrently.
+void recordDecompositions(MLIRContext *context,
+                          const llvm::StringMap<int64_t> &counts);
+
+/// Returns the decomposition counts recorded in `context` since the last call,
+/// and resets them.
+llvm::StringMap<int64_t> takeDecompositions(MLIRContext *context);
+
+} // namespace Torch
+} // namespace torch
+} // namespace mlir
+
+#endif // TORCHMLIR_DIALECT_TORCH_TRANSFORMS_TELEMETRY_H
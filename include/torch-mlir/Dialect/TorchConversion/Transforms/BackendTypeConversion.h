@@ -25,6 +25,14 @@ void getBackendTypeConversionDependentDialects(DialectRegistry &registry);
 /// boundary (which currently consist only of builtin types).
 void setupBackendTypeConversion(ConversionTarget &target,
                                 TypeConverter &typeConverter);
+
+/// Extend a TypeConverter set up by `setupBackendTypeConversion` to convert
+/// quantized tensors to builtin tensors of their integer representation.
+/// This drops the scale and zero point, so it is only meant for patterns that
+/// read them from the op producing the tensor. Without it, the conversion of
+/// quantized tensors fails.
+void setupQuantizedTensorToBuiltinTensorConversion(
+    TypeConverter &typeConverter);
 } // namespace TorchConversion
 } // namespace torch
 } // namespace mlir
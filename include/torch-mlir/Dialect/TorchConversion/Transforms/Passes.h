@@ -22,9 +22,21 @@ class ModuleOp;
 namespace torch {
 namespace TorchConversion {
 
+struct LinalgOnTensorsBackendPipelineOptions
+    : public PassPipelineOptions<LinalgOnTensorsBackendPipelineOptions> {
+  // If this option is true, 2D convolutions and pooling ops are lowered to
+  // their NHWC named ops, and the layout transposes between them are
+  // cancelled.
+  Option<bool> useNhwcLayout{
+      *this, "use-nhwc-layout",
+      llvm::cl::desc("Lower convolutions and pooling ops in NHWC layout."),
+      llvm::cl::init(false)};
+};
+
 /// Creates a pipeline that lowers from the torch backend contract to the
 /// linalg-on-tensors backend contract.
-void createTorchBackendToLinalgOnTensorsBackendPipeline(OpPassManager &pm);
+void createTorchBackendToLinalgOnTensorsBackendPipeline(
+    OpPassManager &pm, const LinalgOnTensorsBackendPipelineOptions &options);
 
 /// Creates a pipeline that lowers from the torch backend contract to the
 /// TOSA backend contract.
@@ -29,9 +29,15 @@ std::unique_ptr<OperationPass<func::FuncOp>> createExpandOpsForLLVMPass();
 
 std::unique_ptr<OperationPass<ModuleOp>> createMLProgramBufferizePass();
 
+std::unique_ptr<OperationPass<ModuleOp>> createInsertRngStateArgumentPass();
+
 std::unique_ptr<OperationPass<func::FuncOp>> createMungeMemrefCopyPass();
 
+std::unique_ptr<OperationPass<func::FuncOp>> createFoldConvPaddingPass();
+
 std::unique_ptr<OperationPass<func::FuncOp>> createGeneralizeTensorPadPass();
+
+std::unique_ptr<OperationPass<func::FuncOp>> createElideInsertSliceCopiesPass();
 } // namespace RefBackend
 } // namespace torch
 } // namespace mlir
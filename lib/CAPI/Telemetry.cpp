@@ -0,0 +1,33 @@
+//===- Telemetry.cpp - C Interface for compile-time telemetry -------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "torch-mlir-c/Telemetry.h"
+
+#include "mlir/CAPI/IR.h"
+#include "mlir/CAPI/Support.h"
+#include "torch-mlir/Dialect/Torch/Transforms/Telemetry.h"
+
+#include <string>
+
+void torchMlirContextSetTelemetryCallback(MlirContext context,
+                                          MlirStringCallback callback,
+                                          void *userData) {
+  if (!callback) {
+    mlir::torch::Torch::setTelemetryCallback(unwrap(context), nullptr);
+    return;
+  }
+  mlir::torch::Torch::setTelemetryCallback(
+      unwrap(context), [callback, userData](const llvm::json::Object &record) {
+        std::string json;
+        llvm::raw_string_ostream os(json);
+        os << llvm::json::Value(llvm::json::Object(record));
+        os.flush();
+        callback(wrap(llvm::StringRef(json)), userData);
+      });
+}
@@ -0,0 +1,42 @@
+//===- Threading.cpp - C Interface for threading configuration ------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "torch-mlir-c/Threading.h"
+
+#include "mlir/CAPI/IR.h"
+#include "mlir/IR/MLIRContext.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
+
+#include <memory>
+#include <mutex>
+
+static llvm::ThreadPool &getSharedThreadPool(unsigned numThreads) {
+  static std::mutex mutex;
+  // Intentionally leaked: contexts owned by Python may outlive static
+  // destructors.
+  static auto *pools =
+      new llvm::DenseMap<unsigned, std::unique_ptr<llvm::ThreadPool>>();
+  std::lock_guard<std::mutex> lock(mutex);
+  std::unique_ptr<llvm::ThreadPool> &pool = (*pools)[numThreads];
+  if (!pool)
+    pool = std::make_unique<llvm::ThreadPool>(
+        llvm::hardware_concurrency(numThreads));
+  return *pool;
+}
+
+void torchMlirContextSetNumThreads(MlirContext context, intptr_t numThreads) {
+  mlir::MLIRContext *ctx = unwrap(context);
+  // A thread pool can only be attached while multithreading is disabled.
+  ctx->disableMultithreading();
+  if (numThreads == 1)
+    return;
+  ctx->setThreadPool(getSharedThreadPool(numThreads));
+}
@@ -16,6 +16,7 @@
 #include "mlir/Dialect/ControlFlow/IR/ControlFlowOps.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Math/IR/Math.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/IR/Matchers.h"
 #include "torch-mlir/Conversion/Utils/Utils.h"
@@ -171,41 +172,33 @@ public:
 } // namespace
 
 namespace {
-// AtenEmbeddingPaddingIdxOp
-// SUM mode == integer 0
-// Sums bags of embeddings together from a weight tensor based on an index and
-// offset Vector. Example arguments weight = [[1, 3, 5, 3],
-//           [3, 4, 2, 1],
-//           [2, 2, 3, 2],
-//           [0, 4, 2, 1]]
+// AtenEmbeddingBagPaddingIdxOp
+// Reduces bags of embeddings from a weight tensor, where the bags are given
+// by an index and an offset vector. Example arguments:
+//   weight = [[1, 3, 5, 3],
+//             [3, 4, 2, 1],
+//             [2, 2, 3, 2],
+//             [0, 4, 2, 1]]
+//   indices = [0, 2, 3, 1, 2, 3, 2, 1, 0, 1]
+//   offsets = [0, 3, 5]
+// describe the bags [0, 2, 3], [1, 2] and [3, 2, 1, 0, 1].
 //
-// indices = [0, 2, 3, 1, 2, 3, 2, 1, 0, 1]
-// offsets = [0, 3, 5]
+// The lowering is a segmented reduction: each element of the output is
+// computed independently, looping only over the indices of its own bag.
 //
-// output_tensor = initZeroTensor(offsets_length, embedding_size)
+// for i in range(num_bags):                    <- dim0, parallel
+//     for k in range(embedding_size):          <- dim1, parallel
+//         acc = 0
+//         for j in range(offsets[i], offsets[i + 1]):  <- scf.for
+//             if indices[j] != padding_idx:
+//                 acc = combine(acc,
+//                               weight[indices[j]][k] * per_sample_weights[j])
+//         output[i][k] = acc
 //
-// for i in range(offsets_length):         <- dim0
-//     for j in range(indices_length):     <- dim1
-//         for k in range(embedding_size): <- dim2
-//             if(offsets[i] <= j and j < offsets[i+1]):
-//                 output_tensor[i][k] = output_tensor[i][k] +
-//                 weight[indices[j]][k]
-//             else:
-//                 break
-//
-// Indexing maps for linalg::Generic ops
-//
-//
-// indices_indexing_map  = (d0, d1, d2) -> (d1)
-// offset_indexing_map   = (d0, d1, d2) -> (d0)
-// output_indexing_map   = (d0, d1, d2) -> (d0, d2)
-//
-// TODO: Find an optimal lowering.
-//       current lowering is not optimal for bags of large embeddings.
-//       Since it traverses the output tensor multiple times. 
-//      
-//
-
+// where `combine` is a sum for the SUM and MEAN modes, divided by the bag size
+// for MEAN, and a max for the MAX mode, which also records the index of the
+// maximum. Both linalg loops are parallel, with the contiguous embedding
+// dimension innermost, and the total work is linear in the number of indices.
 class ConvertAtenEmbeddingBagPaddingIdxOp
     : public OpConversionPattern<AtenEmbeddingBagPaddingIdxOp> {
 public:
@@ -216,10 +209,10 @@ public:
     if (failed(verifyLinalgCompatibleTypes(op, rewriter)))
       return failure();
     Location loc = op->getLoc();
-    auto context = op->getContext();
     Value weight = adaptor.getWeight();
     Value indices = adaptor.getIndices();
     Value offsets = adaptor.getOffsets();
+    Value perSampleWeights = adaptor.getPerSampleWeights();
     Value scaleGradByFreq = op.getScaleGradByFreq();
     Value mode = op.getMode();
     Value sparse = op.getSparse();
@@ -243,10 +236,10 @@ public:
           op, "mode is expected to be a constant integer value.");
     }
 
-    if (modeInt != torch_upstream::EmbeddingBagMode::MODE_SUM) {
-      return rewriter.notifyMatchFailure(
-          op,
-          "Unimplemented: Mean and Max mode are not supported yet for EmbeddingBag.");
+    if (modeInt != torch_upstream::EmbeddingBagMode::MODE_SUM &&
+        modeInt != torch_upstream::EmbeddingBagMode::MODE_MEAN &&
+        modeInt != torch_upstream::EmbeddingBagMode::MODE_MAX) {
+      return rewriter.notifyMatchFailure(op, "invalid mode for EmbeddingBag");
     }
 
     bool isSparse;
@@ -261,14 +254,36 @@ public:
           "Unimplemented: Sparse mode is not supported yet for EmbeddingBag.");
     }
 
-    bool discardLastOffset;
+    bool includeLastOffsetBool;
     if (!matchPattern(includeLastOffset,
-                      m_TorchConstantBool(&discardLastOffset))) {
+                      m_TorchConstantBool(&includeLastOffsetBool))) {
       return rewriter.notifyMatchFailure(
           op,
           "include_last_offset is expected to be a constant boolean value.");
     }
 
+    // `torch.nn.functional.embedding_bag` passes -1 when there is no padding
+    // index.
+    std::optional<int64_t> paddingIdx;
+    if (!op.getPaddingIdx().getType().isa<Torch::NoneType>()) {
+      int64_t paddingIdxInt;
+      if (!matchPattern(op.getPaddingIdx(),
+                        m_TorchConstantInt(&paddingIdxInt))) {
+        return rewriter.notifyMatchFailure(
+            op, "padding_idx is expected to be a constant integer value.");
+      }
+      if (paddingIdxInt >= 0)
+        paddingIdx = paddingIdxInt;
+    }
+
+    bool hasPerSampleWeights =
+        !perSampleWeights.getType().isa<Torch::NoneType>();
+    if (hasPerSampleWeights &&
+        modeInt != torch_upstream::EmbeddingBagMode::MODE_SUM) {
+      return rewriter.notifyMatchFailure(
+          op, "per_sample_weights are only supported with the SUM mode.");
+    }
+
     auto weightTy = weight.getType().cast<RankedTensorType>();
     if (weightTy.getRank() != 2)
       return rewriter.notifyMatchFailure(op, "weight must be rank 2");
@@ -281,161 +296,284 @@ public:
     if (offsetsTy.getRank() != 1)
       return rewriter.notifyMatchFailure(op, "offsets much be a vector");
 
-    Type weightElemTy = weightTy.getElementType();
-
-    int64_t iterationMapDimension = weightTy.getRank() + indicesTy.getRank();
-    SmallVector<AffineExpr> indicesExpr;
-    indicesExpr.push_back(mlir::getAffineDimExpr(1, context));
-    auto indicesIndexingMap =
-          AffineMap::get(/*dimCount=*/iterationMapDimension, /*symbolCount=*/0,
-                         indicesExpr, context);
-
-    SmallVector<AffineExpr> offsetsExpr;
-    offsetsExpr.push_back(mlir::getAffineDimExpr(0, context));
-
-    auto offsetIndexingMap =
-          AffineMap::get(/*dimCount=*/iterationMapDimension, /*symbolCount=*/0,
-                         offsetsExpr, context);
+    if (hasPerSampleWeights &&
+        perSampleWeights.getType().cast<RankedTensorType>().getRank() != 1)
+      return rewriter.notifyMatchFailure(
+          op, "per_sample_weights must be a vector");
 
-    SmallVector<AffineExpr> outputExpr;
-    outputExpr.push_back(mlir::getAffineDimExpr(0, context));
-    outputExpr.push_back(mlir::getAffineDimExpr(2, context));
+    Type weightElemTy = weightTy.getElementType();
+    Type indicesElemTy = indicesTy.getElementType();
+    Type offsetElemTy = offsetsTy.getElementType();
 
-    auto outputIndexingMap =
-          AffineMap::get(/*dimCount=*/iterationMapDimension, /*symbolCount=*/0,
-                         outputExpr, context);
+    Value c0 = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+    Value c1 = rewriter.create<arith::ConstantIndexOp>(loc, 1);
+    Value embeddingDim = getDimOp(rewriter, loc, weight, 1);
+    Value offsetsLength = getDimOp(rewriter, loc, offsets, 0);
+    Value indicesLength = getDimOp(rewriter, loc, indices, 0);
+    // With `include_last_offset`, the last offset only marks the end of the
+    // last bag.
+    Value numBags = offsetsLength;
+    if (includeLastOffsetBool)
+      numBags = rewriter.create<arith::SubIOp>(loc, offsetsLength, c1);
+
+    // Returns the [start, end) range of `bag` in `indices`.
+    auto getBagBounds = [&](OpBuilder &b, Location loc,
+                            Value bag) -> std::pair<Value, Value> {
+      Value start = castIntToIndex(
+          b, loc, b.create<tensor::ExtractOp>(loc, offsets, bag));
+      Value nextBag = b.create<arith::AddIOp>(loc, bag, c1);
+      if (includeLastOffsetBool) {
+        Value end = castIntToIndex(
+            b, loc, b.create<tensor::ExtractOp>(loc, offsets, nextBag));
+        return {start, end};
+      }
+      // The last bag ends with the indices. Clamp the position of the next
+      // offset so that it is not read out of bounds.
+      Value isLast = b.create<arith::CmpIOp>(loc, arith::CmpIPredicate::eq,
+                                             nextBag, offsetsLength);
+      Value nextOffsetPos =
+          b.create<arith::SelectOp>(loc, isLast, bag, nextBag);
+      Value nextOffset = castIntToIndex(
+          b, loc, b.create<tensor::ExtractOp>(loc, offsets, nextOffsetPos));
+      Value end =
+          b.create<arith::SelectOp>(loc, isLast, indicesLength, nextOffset);
+      return {start, end};
+    };
 
-    SmallVector<AffineMap, 3> indexingMaps = {
-          indicesIndexingMap,
-          offsetIndexingMap,
-          outputIndexingMap,
+    // Creates a loop over the indices of `bag` carrying `init`, in which
+    // `combine` computes the next iteration values for each entry that is not
+    // the padding index.
+    using CombineFn = function_ref<SmallVector<Value>(
+        OpBuilder &, Location, Value /*pos*/, Value /*row*/, ValueRange)>;
+    auto createBagLoop = [&](OpBuilder &b, Location loc, Value bag,
+                             ValueRange init, CombineFn combine) {
+      auto [start, end] = getBagBounds(b, loc, bag);
+      auto loop = b.create<scf::ForOp>(
+          loc, start, end, c1, init,
+          [&](OpBuilder &b, Location loc, Value pos, ValueRange iterArgs) {
+            Value row = b.create<tensor::ExtractOp>(loc, indices, pos);
+            SmallVector<Value> results = combine(b, loc, pos, row, iterArgs);
+            if (paddingIdx) {
+              Value isPadding = b.create<arith::CmpIOp>(
+                  loc, arith::CmpIPredicate::eq, row,
+                  getConstant(b, loc, *paddingIdx, indicesElemTy));
+              for (auto [result, iterArg] : llvm::zip(results, iterArgs))
+                result =
+                    b.create<arith::SelectOp>(loc, isPadding, iterArg, result);
+            }
+            b.create<scf::YieldOp>(loc, results);
+          });
+      return loop.getResults();
     };
 
-    // Reduce along the indices dim
-    SmallVector<utils::IteratorType> iteratorTypes(
-        {utils::IteratorType::parallel, utils::IteratorType::reduction,
-         utils::IteratorType::parallel});
+    bool isMaxMode = modeInt == torch_upstream::EmbeddingBagMode::MODE_MAX;
+    bool isMeanMode = modeInt == torch_upstream::EmbeddingBagMode::MODE_MEAN;
+    SmallVector<Value> outputSizes{numBags, embeddingDim};
+    SmallVector<Value> outputInits{rewriter.create<tensor::EmptyOp>(
+        loc, getAsOpFoldResult(outputSizes), weightElemTy)};
+    if (isMaxMode)
+      outputInits.push_back(rewriter.create<tensor::EmptyOp>(
+          loc, getAsOpFoldResult(outputSizes), indicesElemTy));
+    SmallVector<Type> outputTypes;
+    for (Value init : outputInits)
+      outputTypes.push_back(init.getType());
+    SmallVector<AffineMap> outputMaps(outputInits.size(),
+                                      rewriter.getMultiDimIdentityMap(2));
+    SmallVector<utils::IteratorType> outputIteratorTypes(
+        2, utils::IteratorType::parallel);
+
+    auto embeddingBag = rewriter.create<linalg::GenericOp>(
+        loc, outputTypes, ValueRange{}, outputInits, outputMaps,
+        outputIteratorTypes, [&](OpBuilder &b, Location loc, ValueRange) {
+          Value bag = b.create<linalg::IndexOp>(loc, 0);
+          Value col = b.create<linalg::IndexOp>(loc, 1);
+          Value zero =
+              b.create<arith::ConstantOp>(loc, b.getZeroAttr(weightElemTy));
+          // Empty bags, and bags with only padding entries, produce zeros in
+          // every mode, and a max index of 0.
+          SmallVector<Value> init{zero, c0};
+          if (isMaxMode)
+            init.push_back(getConstant(b, loc, 0, indicesElemTy));
+
+          auto combine = [&](OpBuilder &b, Location loc, Value pos, Value row,
+                             ValueRange iterArgs) -> SmallVector<Value> {
+            Value acc = iterArgs[0];
+            Value count = iterArgs[1];
+            Value elem = b.create<tensor::ExtractOp>(
+                loc, weight, ValueRange{castIntToIndex(b, loc, row), col});
+            if (hasPerSampleWeights) {
+              Value scale =
+                  b.create<tensor::ExtractOp>(loc, perSampleWeights, pos);
+              elem = b.create<arith::MulFOp>(loc, elem, scale);
+            }
+            Value newCount = b.create<arith::AddIOp>(loc, count, c1);
+            if (!isMaxMode)
+              return {b.create<arith::AddFOp>(loc, acc, elem), newCount};
+            // The first entry of the bag initializes the max, and ties keep
+            // the earlier entry. Like PyTorch, a NaN entry becomes the max and
+            // is kept from then on.
+            Value isFirst = b.create<arith::CmpIOp>(
+                loc, arith::CmpIPredicate::eq, count, c0);
+            Value accIsNotNan = b.create<arith::CmpFOp>(
+                loc, arith::CmpFPredicate::ORD, acc, acc);
+            Value isGreaterOrNan = b.create<arith::CmpFOp>(
+                loc, arith::CmpFPredicate::UGT, elem, acc);
+            Value takeNew = b.create<arith::OrIOp>(
+                loc, isFirst,
+                b.create<arith::AndIOp>(loc, accIsNotNan, isGreaterOrNan));
+            return {b.create<arith::SelectOp>(loc, takeNew, elem, acc),
+                    newCount,
+                    b.create<arith::SelectOp>(loc, takeNew, row, iterArgs[2])};
+          };
+          SmallVector<Value> results =
+              llvm::to_vector(createBagLoop(b, loc, bag, init, combine));
+
+          if (isMeanMode) {
+            // Empty bags produce zeros rather than dividing by zero.
+            Value count = b.create<arith::MaxUIOp>(loc, results[1], c1);
+            Value countFloat = b.create<arith::SIToFPOp>(
+                loc, weightElemTy, castIndexToInt64(b, loc, count));
+            results[0] = b.create<arith::DivFOp>(loc, results[0], countFloat);
+          }
+          results.erase(results.begin() + 1);
+          b.create<linalg::YieldOp>(loc, results);
+        });
 
-    Value embeddingDim = getDimOp(rewriter, loc, weight, 1);
-    Value initTensor;
-    Value offsetsLength;
-    Value indicesLength;
-    if (!discardLastOffset) {
-      SmallVector<Value> sizes{getDimOp(rewriter, loc, offsets, 0),
-                                 embeddingDim};
-
-      initTensor = createZeroInitTensor(rewriter, loc, sizes, weightElemTy);
-      offsetsLength = getDimOp(rewriter, loc, offsets, 0);
-      indicesLength = getDimOp(rewriter, loc, indices, 0);
-    } else {
-      return rewriter.notifyMatchFailure(
-            op, "Unimplemented: include last offset is not yet "
-                "supported for EmbeddingBag.");
-    }
+    auto resultType0 = typeConverter->convertType(op->getResult(0).getType());
+    Value castedEmbeddingBagResult = rewriter.create<tensor::CastOp>(
+        loc, resultType0, embeddingBag.getResult(0));
 
-    Value embeddingBagResult =
-        rewriter
-            .create<linalg::GenericOp>(
-                loc, initTensor.getType(), ValueRange{indices, offsets},
-                initTensor,
-                /*indexingMaps=*/indexingMaps,
-                /*iteratorTypes=*/iteratorTypes,
-                [&](OpBuilder &b, Location loc, ValueRange args) {
-                  Value indexInIndices = args[0];
-                  Value offsetsI = args[1];
-                  Value initTensorElem = args[2];
-
-                  Value indexI = b.create<linalg::IndexOp>(loc, /*value=*/0);
-                  Value indexIToInt = castIndexToInt64(b, loc, indexI);
-                  Value one = getConstant(
-                      b, loc, 1,
-                      mlir::IntegerType::get(getContext(), 64,
-                                             IntegerType::Signless));
-                  Value offsetIndexPlusOneInt =
-                      b.create<arith::AddIOp>(loc, indexIToInt, one);
-
-                  Value offsetIndexPlusOne =
-                      castIntToIndex(b, loc, offsetIndexPlusOneInt);
-                  Value checkLast = b.create<arith::CmpIOp>(
-                      loc, arith::CmpIPredicate::eq,
-                      castIndexToInt64(b, loc, offsetsLength),
-                      offsetIndexPlusOneInt);
-                  Value nextOffset = b.create<arith::SelectOp>(
-                      loc, checkLast, castIndexToInt64(b, loc, indicesLength),
-                      b.create<tensor::ExtractOp>(loc, offsets,
-                                                  offsetIndexPlusOne));
-
-                  Value indicesIndex = castIndexToInt64(
-                      b, loc, b.create<linalg::IndexOp>(loc, /*value=*/1));
-
-                  Value offsetLessThanIndicesIndex = b.create<arith::CmpIOp>(
-                      loc, arith::CmpIPredicate::slt, offsetsI, indicesIndex);
-                  Value offsetEqualToIndicesIndex = b.create<arith::CmpIOp>(
-                      loc, arith::CmpIPredicate::eq, offsetsI, indicesIndex);
-                  Value offsetLessThanOrEqualToIndicesIndex =
-                      b.create<arith::OrIOp>(loc, offsetLessThanIndicesIndex,
-                                               offsetEqualToIndicesIndex);
-
-                  Value indicesIndexLessThanNextOffset =
-                      b.create<arith::CmpIOp>(loc, arith::CmpIPredicate::slt,
-                                              indicesIndex, nextOffset);
-
-                  Value indicesIndexWithinBounds = b.create<arith::AndIOp>(
-                      loc, offsetLessThanOrEqualToIndicesIndex,
-                      indicesIndexLessThanNextOffset);
-
-                  SmallVector<Value> indexIntoWeight;
-                  indexIntoWeight.push_back(
-                      castIntToIndex(b, loc, indexInIndices));
-                  indexIntoWeight.push_back(
-                      b.create<linalg::IndexOp>(loc, /*value=*/2));
-                  Value weightElem = b.create<tensor::ExtractOp>(
-                      loc, weight, indexIntoWeight);
-
-                  Value addResult = b.create<arith::AddFOp>(loc, weightElem,
-                                                            initTensorElem);
-                  Value select =
-                      b.create<arith::SelectOp>(loc, indicesIndexWithinBounds,
-                                                  addResult, initTensorElem);
-                  b.create<linalg::YieldOp>(loc, select);
-              })
-          .getResult(0);
-
-      // cast outputType.
-    auto restulType0 = typeConverter->convertType(op->getResult(0).getType());
-    Value castedEmbeddingBagResult =
-        rewriter.create<tensor::CastOp>(loc, restulType0, embeddingBagResult);
-
-    // offset2 tensor, this should be an empty tensor for the sum mode
-    SmallVector<Value> offsetResultSize;
-    Type offsetElemTy = offsetsTy.getElementType();
-    Value zeroDim = rewriter.create<arith::ConstantIndexOp>(loc, /*value=*/0);
-    offsetResultSize.push_back(zeroDim);
-    Value offsetResult = rewriter.create<tensor::EmptyOp>(
-        loc, getAsOpFoldResult(offsetResultSize), offsetElemTy);
+    // offset2bag, the bag of each index. It is empty in the MEAN mode.
     auto resultType1 = typeConverter->convertType(op->getResult(1).getType());
+    Value offsetResult;
+    if (isMeanMode) {
+      offsetResult = rewriter.create<tensor::EmptyOp>(
+          loc, SmallVector<OpFoldResult>{rewriter.getIndexAttr(0)},
+          offsetElemTy);
+    } else {
+      // The bag of index `j` is the number of offsets at or before `j`, minus
+      // one. The offsets are sorted, so each index finds its bag with a
+      // binary search, running `bit_width(offsets_length)` steps.
+      Value offset2bagInit = rewriter.create<tensor::EmptyOp>(
+          loc, getAsOpFoldResult(indicesLength), offsetElemTy);
+      Value lastOffsetPos = rewriter.create<arith::SubIOp>(
+          loc, rewriter.create<arith::MaxUIOp>(loc, offsetsLength, c1), c1);
+      Value offsetsLengthInt = castIndexToInt64(rewriter, loc, offsetsLength);
+      Value numSteps = rewriter.create<arith::SubIOp>(
+          loc, rewriter.create<arith::ConstantIndexOp>(loc, 64),
+          rewriter.create<arith::IndexCastOp>(
+              loc, rewriter.getIndexType(),
+              rewriter.create<math::CountLeadingZerosOp>(loc,
+                                                         offsetsLengthInt)));
+      offsetResult =
+          rewriter
+              .create<linalg::GenericOp>(
+                  loc, offset2bagInit.getType(), ValueRange{}, offset2bagInit,
+                  SmallVector<AffineMap>{rewriter.getMultiDimIdentityMap(1)},
+                  SmallVector<utils::IteratorType>{
+                      utils::IteratorType::parallel},
+                  [&](OpBuilder &b, Location loc, ValueRange) {
+                    Value pos = b.create<arith::IndexCastOp>(
+                        loc, offsetElemTy, b.create<linalg::IndexOp>(loc, 0));
+                    // Finds the first offset after `pos` in [lo, hi).
+                    auto search = b.create<scf::ForOp>(
+                        loc, c0, numSteps, c1, ValueRange{c0, offsetsLength},
+                        [&](OpBuilder &b, Location loc, Value,
+                            ValueRange bounds) {
+                          Value lo = bounds[0], hi = bounds[1];
+                          Value isActive = b.create<arith::CmpIOp>(
+                              loc, arith::CmpIPredicate::ult, lo, hi);
+                          Value mid = b.create<arith::AddIOp>(
+                              loc, lo,
+                              b.create<arith::ShRUIOp>(
+                                  loc, b.create<arith::SubIOp>(loc, hi, lo),
+                                  c1));
+                          // `mid` is `hi` once the search is done, which may
+                          // be past the last offset.
+                          Value offset = b.create<tensor::ExtractOp>(
+                              loc, offsets,
+                              ValueRange{b.create<arith::MinUIOp>(
+                                  loc, mid, lastOffsetPos)});
+                          Value isStarted = b.create<arith::CmpIOp>(
+                              loc, arith::CmpIPredicate::sle, offset, pos);
+                          Value isNotStarted = b.create<arith::CmpIOp>(
+                              loc, arith::CmpIPredicate::sgt, offset, pos);
+                          Value moveLo =
+                              b.create<arith::AndIOp>(loc, isActive, isStarted);
+                          Value moveHi = b.create<arith::AndIOp>(
+                              loc, isActive, isNotStarted);
+                          Value midPlusOne =
+                              b.create<arith::AddIOp>(loc, mid, c1);
+                          Value newLo = b.create<arith::SelectOp>(
+                              loc, moveLo, midPlusOne, lo);
+                          Value newHi =
+                              b.create<arith::SelectOp>(loc, moveHi, mid, hi);
+                          b.create<scf::YieldOp>(loc, ValueRange{newLo, newHi});
+                        });
+                    Value bag = b.create<arith::SubIOp>(
+                        loc, search.getResult(0), c1);
+                    b.create<linalg::YieldOp>(
+                        loc, ValueRange{b.create<arith::IndexCastOp>(
+                                 loc, offsetElemTy, bag)});
+                  })
+              .getResult(0);
+    }
     Value castedOffsetResult =
         rewriter.create<tensor::CastOp>(loc, resultType1, offsetResult);
 
+    // bag_size, the number of non-padding entries of each bag in the MEAN and
+    // MAX modes, and zeros in the SUM mode. It has one entry per offset.
     SmallVector<Value> offsetSize = getTensorSizes(rewriter, loc, offsets);
-    // bagsize, vector of size offset with zeros, I think this is always just
-    // a vector of zeros in the sum mode
-    Value bagSize =
-        createZeroInitTensor(rewriter, loc, offsetSize, offsetElemTy);
+    Value bagSize;
+    if (isMeanMode || isMaxMode) {
+      Value bagSizeInit = rewriter.create<tensor::EmptyOp>(
+          loc, getAsOpFoldResult(numBags), offsetElemTy);
+      bagSize =
+          rewriter
+              .create<linalg::GenericOp>(
+                  loc, bagSizeInit.getType(), ValueRange{}, bagSizeInit,
+                  SmallVector<AffineMap>{rewriter.getMultiDimIdentityMap(1)},
+                  SmallVector<utils::IteratorType>{
+                      utils::IteratorType::parallel},
+                  [&](OpBuilder &b, Location loc, ValueRange) {
+                    Value bag = b.create<linalg::IndexOp>(loc, 0);
+                    auto countEntry = [&](OpBuilder &b, Location loc, Value,
+                                          Value, ValueRange iterArgs) {
+                      return SmallVector<Value>{
+                          b.create<arith::AddIOp>(loc, iterArgs[0], c1)};
+                    };
+                    Value count =
+                        createBagLoop(b, loc, bag, c0, countEntry)[0];
+                    b.create<linalg::YieldOp>(
+                        loc, ValueRange{b.create<arith::IndexCastOp>(
+                                 loc, offsetElemTy, count)});
+                  })
+              .getResult(0);
+      if (includeLastOffsetBool) {
+        SmallVector<int64_t> lowPadding{0}, highPadding{1};
+        bagSize = torch_to_linalg::getPaddedTensor(
+            op, rewriter, bagSize, lowPadding, highPadding,
+            getConstant(rewriter, loc, 0, offsetElemTy));
+      }
+    } else {
+      bagSize = createZeroInitTensor(rewriter, loc, offsetSize, offsetElemTy);
+    }
     auto resultType2 = typeConverter->convertType(op->getResult(2).getType());
     Value castedBagSizeResult =
         rewriter.create<tensor::CastOp>(loc, resultType2, bagSize);
 
-    // max indices, vector of size offset with zeros, this is also always a
-    // vector of zeros in the sum mode. Its mainly used in the max mode.
+    // max_indices, the index of the maximum of each element of the output in
+    // the MAX mode, and zeros with one entry per offset otherwise.
     Value indicesOut =
-        createZeroInitTensor(rewriter, loc, offsetSize, offsetElemTy);
+        isMaxMode
+            ? embeddingBag.getResult(1)
+            : createZeroInitTensor(rewriter, loc, offsetSize, offsetElemTy);
     auto resultType3 = typeConverter->convertType(op->getResult(3).getType());
     Value castedMaxIndices =
         rewriter.create<tensor::CastOp>(loc, resultType3, indicesOut);
 
     rewriter.replaceOp(op, {castedEmbeddingBagResult, castedOffsetResult,
-                              castedBagSizeResult, castedMaxIndices});
+                            castedBagSizeResult, castedMaxIndices});
 
     return success();
   }
@@ -477,7 +477,10 @@ public:
 namespace {
 class ConvertAtenConvolutionOp : public OpConversionPattern<AtenConvolutionOp> {
 public:
-  using OpConversionPattern::OpConversionPattern;
+  ConvertAtenConvolutionOp(TypeConverter &typeConverter, MLIRContext *context,
+                           const torch_to_linalg::TorchToLinalgOptions &options)
+      : OpConversionPattern<AtenConvolutionOp>(typeConverter, context),
+        options(options) {}
   LogicalResult
   matchAndRewrite(AtenConvolutionOp op, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
@@ -557,6 +560,231 @@ public:
     SmallVector<Value> strideIntValues =
         getAsConstantIntValues(rewriter, loc, strideInts);
 
+    // Initializes `initTensor` with the bias broadcast along `channelDim`, or
+    // with zeros if there is no bias.
+    auto createOutputTensor = [&](Value initTensor,
+                                  int64_t channelDim) -> FailureOr<Value> {
+      Value bias = adaptor.getBias();
+      if (bias.getType().isa<Torch::NoneType>()) {
+        Value c0float = rewriter.create<arith::ConstantOp>(
+            loc, FloatAttr::get(elementType, 0.0));
+        return rewriter.create<linalg::FillOp>(loc, c0float, initTensor)
+            .getResult(0);
+      }
+      auto biasType = bias.getType().cast<RankedTensorType>();
+      if (biasType.getRank() != 1)
+        return rewriter.notifyMatchFailure(op, "expect bias to be rank 1");
+      if (elementType != biasType.getElementType())
+        return rewriter.notifyMatchFailure(op, "unimplemented: type promotion");
+
+      auto resultRank = initTensor.getType().cast<RankedTensorType>().getRank();
+      SmallVector<AffineMap> indexingMaps = {
+          // bias is used to initialize the channels dimension of output
+          AffineMap::get(/*dimCount=*/resultRank, /*symbolCount=*/0,
+                         rewriter.getAffineDimExpr(channelDim), context),
+          rewriter.getMultiDimIdentityMap(resultRank)};
+      SmallVector<utils::IteratorType> iteratorTypes(
+          resultRank, utils::IteratorType::parallel);
+      return rewriter
+          .create<linalg::GenericOp>(
+              loc, initTensor.getType(), bias, initTensor, indexingMaps,
+              iteratorTypes,
+              [](OpBuilder &b, Location loc, ValueRange args) {
+                b.create<linalg::YieldOp>(loc, args[0]);
+              })
+          .getResult(0);
+    };
+
+    auto inputShape = makeShapeTorchCompatible(
+        input.getType().cast<RankedTensorType>().getShape());
+    auto originalWeightShape = makeShapeTorchCompatible(
+        weight.getType().cast<RankedTensorType>().getShape());
+    // Depthwise convolution with a channel multiplier of 1.
+    bool isSimpleDepthwise = groupSize != 1 && inputShape[1] == groupSize &&
+                             originalWeightShape[0] == groupSize &&
+                             originalWeightShape[1] == 1;
+    if (options.useNhwcLayout && !transposed &&
+        (groupSize == 1 || isSimpleDepthwise)) {
+      // Convolve in NHWC with HWCF (or HWC for depthwise) filters. The layout
+      // transposes at the boundaries are expected to be cancelled between
+      // consecutive ops by the `propagate-linalg-layout` pass.
+      Value nhwcInput = torch_to_linalg::createTransposeLinalgGeneric(
+          rewriter, loc, input, {0, 2, 3, 1});
+      Value paddedInput = torch_to_linalg::getDynamicZeroPaddedTensor(
+          op, rewriter, nhwcInput, paddingIntValues, /*unpaddedDims=*/1,
+          /*unpaddedTrailingDims=*/1);
+
+      SmallVector<Value> outDims{inBatch};
+      for (size_t i = 0; i < numSpacialDims; i++)
+        outDims.push_back(torch_to_linalg::getOutputDimForConvOps(
+            rewriter, loc, inDims[i], paddingIntValues[i], dilationIntValues[i],
+            castIndexToInt(weightDims[i]), strideIntValues[i]));
+      outDims.push_back(weightBatch);
+      Value initTensor = rewriter.create<tensor::EmptyOp>(
+          loc, getAsOpFoldResult(outDims), elementType);
+      FailureOr<Value> outputTensor =
+          createOutputTensor(initTensor, /*channelDim=*/3);
+      if (failed(outputTensor))
+        return failure();
+
+      auto stridesAttr = rewriter.getI64VectorAttr(strideInts);
+      auto dilationAttr = rewriter.getI64VectorAttr(dilationInts);
+      Value conv;
+      if (groupSize == 1) {
+        Value hwcfWeight = torch_to_linalg::createTransposeLinalgGeneric(
+            rewriter, loc, weight, {2, 3, 1, 0});
+        conv = rewriter
+                   .create<linalg::Conv2DNhwcHwcfOp>(
+                       loc, outputTensor->getType(),
+                       ValueRange{paddedInput, hwcfWeight}, *outputTensor,
+                       stridesAttr, dilationAttr)
+                   .getResult(0);
+      } else {
+        SmallVector<ReassociationIndices, 4> collapsedDims = {{0, 1}, {2}, {3}};
+        SmallVector<int64_t> collapsedShape{
+            originalWeightShape[0], originalWeightShape[2],
+            originalWeightShape[3]};
+        Type collapsedType = RankedTensorType::get(
+            makeShapeLLVMCompatible(collapsedShape), elementType);
+        Value collapsedWeight = rewriter.create<tensor::CollapseShapeOp>(
+            loc, collapsedType, weight, collapsedDims);
+        Value hwcWeight = torch_to_linalg::createTransposeLinalgGeneric(
+            rewriter, loc, collapsedWeight, {1, 2, 0});
+        conv = rewriter
+                   .create<linalg::DepthwiseConv2DNhwcHwcOp>(
+                       loc, outputTensor->getType(),
+                       ValueRange{paddedInput, hwcWeight}, *outputTensor,
+                       stridesAttr, dilationAttr)
+                   .getResult(0);
+      }
+
+      Value nchwResult = torch_to_linalg::createTransposeLinalgGeneric(
+          rewriter, loc, conv, {0, 3, 1, 2});
+      Type newResultType = getTypeConverter()->convertType(op.getType());
+      rewriter.replaceOpWithNewOp<tensor::CastOp>(op, newResultType,
+                                                  nchwResult);
+      return success();
+    }
+
+    bool isStrided = llvm::any_of(strideInts, [](int64_t s) { return s != 1; });
+    if (transposed && groupSize == 1 && isStrided) {
+      // A strided transposed convolution is lowered as a GEMM followed by a
+      // col2im accumulation instead of a convolution over a zero-inserted
+      // input, so no multiplications by the inserted zeros are performed.
+      //
+      // The GEMM contracts the input channels of the N*C*H*W input with the
+      // C*F*KH*KW weight, producing one column per kernel tap:
+      //   cols[n, f, kh, kw, ih, iw] = sum_c input[n, c, ih, iw] *
+      //                                      weight[c, f, kh, kw]
+      // Input pixel (ih, iw) contributes tap (kh, kw) to output pixel
+      //   (ih * stride - padding + kh * dilation, ...)
+      // so col2im gathers, for each output pixel, the taps for which that
+      // relation has an integral in-bounds solution:
+      //   out[n, f, oh, ow] = bias[f] + sum_{kh, kw} cols[n, f, kh, kw,
+      //                         (oh + padding - kh * dilation) / stride, ...]
+      SmallVector<Value> colsDims{inBatch, weightChannels};
+      colsDims.append(weightDims);
+      colsDims.append(inDims);
+      Value colsInit =
+          createZeroInitTensor(rewriter, loc, colsDims, elementType);
+
+      // Loops: n, f, kh, kw, ih, iw, c.
+      auto d = [&](unsigned i) { return rewriter.getAffineDimExpr(i); };
+      SmallVector<AffineMap> gemmMaps{
+          AffineMap::get(7, 0, {d(0), d(6), d(4), d(5)}, context),
+          AffineMap::get(7, 0, {d(6), d(1), d(2), d(3)}, context),
+          AffineMap::get(7, 0, {d(0), d(1), d(2), d(3), d(4), d(5)}, context)};
+      SmallVector<utils::IteratorType> gemmIteratorTypes(
+          6, utils::IteratorType::parallel);
+      gemmIteratorTypes.push_back(utils::IteratorType::reduction);
+      Value cols =
+          rewriter
+              .create<linalg::GenericOp>(
+                  loc, colsInit.getType(), ValueRange{input, weight}, colsInit,
+                  gemmMaps, gemmIteratorTypes,
+                  [&](OpBuilder &b, Location loc, ValueRange args) {
+                    Value mul = b.create<arith::MulFOp>(loc, args[0], args[1]);
+                    Value add = b.create<arith::AddFOp>(loc, mul, args[2]);
+                    b.create<linalg::YieldOp>(loc, add);
+                  })
+              .getResult(0);
+
+      SmallVector<Value> outDims{inBatch, weightChannels};
+      for (size_t i = 0; i < numSpacialDims; i++)
+        outDims.push_back(torch_to_linalg::getOutputDimForConvTransposeOps(
+            rewriter, loc, inDims[i], paddingIntValues[i], dilationIntValues[i],
+            castIndexToInt(weightDims[i]), strideIntValues[i]));
+      Value initTensor = rewriter.create<tensor::EmptyOp>(
+          loc, getAsOpFoldResult(outDims), elementType);
+      FailureOr<Value> outputTensor =
+          createOutputTensor(initTensor, /*channelDim=*/1);
+      if (failed(outputTensor))
+        return failure();
+
+      // Loops: n, f, oh, ow, kh, kw. The kernel-shaped operand only provides
+      // the bounds of the reduction loops, as in the pooling lowerings.
+      Value kernelShape = rewriter.create<tensor::EmptyOp>(
+          loc, getAsOpFoldResult(weightDims), elementType);
+      SmallVector<AffineMap> col2imMaps{
+          AffineMap::get(6, 0, {d(4), d(5)}, context),
+          AffineMap::get(6, 0, {d(0), d(1), d(2), d(3)}, context)};
+      SmallVector<utils::IteratorType> col2imIteratorTypes(
+          4, utils::IteratorType::parallel);
+      col2imIteratorTypes.append(2, utils::IteratorType::reduction);
+      auto col2im = [&](OpBuilder &b, Location loc, ValueRange args) {
+        Value c0 = b.create<arith::ConstantIndexOp>(loc, 0);
+        Value isValid = b.create<arith::ConstantIntOp>(loc, 1, /*width=*/1);
+        SmallVector<Value> indices{b.create<linalg::IndexOp>(loc, 0),
+                                   b.create<linalg::IndexOp>(loc, 1)};
+        SmallVector<Value> inIndices;
+        for (size_t i = 0; i < numSpacialDims; i++) {
+          Value outIndex = b.create<linalg::IndexOp>(loc, 2 + i);
+          Value kernelIndex = b.create<linalg::IndexOp>(loc, 4 + i);
+          indices.push_back(kernelIndex);
+          Value stride = b.create<arith::ConstantIndexOp>(loc, strideInts[i]);
+          Value dilation =
+              b.create<arith::ConstantIndexOp>(loc, dilationInts[i]);
+          Value offset = b.create<arith::AddIOp>(
+              loc, outIndex, castIntToIndex(b, loc, paddingIntValues[i]));
+          offset = b.create<arith::SubIOp>(
+              loc, offset, b.create<arith::MulIOp>(loc, kernelIndex, dilation));
+          Value inIndex = b.create<arith::DivSIOp>(loc, offset, stride);
+          Value isAligned = b.create<arith::CmpIOp>(
+              loc, arith::CmpIPredicate::eq,
+              b.create<arith::RemSIOp>(loc, offset, stride), c0);
+          Value isNonNegative = b.create<arith::CmpIOp>(
+              loc, arith::CmpIPredicate::sge, offset, c0);
+          Value isInBounds = b.create<arith::CmpIOp>(
+              loc, arith::CmpIPredicate::slt, inIndex, inDims[i]);
+          isValid = b.create<arith::AndIOp>(loc, isValid, isAligned);
+          isValid = b.create<arith::AndIOp>(loc, isValid, isNonNegative);
+          isValid = b.create<arith::AndIOp>(loc, isValid, isInBounds);
+          inIndices.push_back(inIndex);
+        }
+        // Clamp the indices of invalid taps so that the extract stays in
+        // bounds; their value is discarded below.
+        for (Value inIndex : inIndices)
+          indices.push_back(
+              b.create<arith::SelectOp>(loc, isValid, inIndex, c0));
+        Value tap = b.create<tensor::ExtractOp>(loc, cols, indices);
+        Value zero = b.create<arith::ConstantOp>(
+            loc, b.getFloatAttr(elementType, 0.0));
+        tap = b.create<arith::SelectOp>(loc, isValid, tap, zero);
+        Value add = b.create<arith::AddFOp>(loc, tap, args[1]);
+        b.create<linalg::YieldOp>(loc, add);
+      };
+      Value result = rewriter
+                         .create<linalg::GenericOp>(
+                             loc, outputTensor->getType(), kernelShape,
+                             *outputTensor, col2imMaps, col2imIteratorTypes,
+                             col2im)
+                         .getResult(0);
+
+      Type newResultType = getTypeConverter()->convertType(op.getType());
+      rewriter.replaceOpWithNewOp<tensor::CastOp>(op, newResultType, result);
+      return success();
+    }
+
     // Pad the input tensor according to padding.
     SmallVector<Value> outDims{inBatch, weightBatch};
     Value paddedInput;
@@ -664,37 +892,11 @@ public:
     Value initTensor = rewriter.create<tensor::EmptyOp>(
         loc, getAsOpFoldResult(outDims), elementType);
 
-    Value bias = adaptor.getBias();
-    Value outputTensor;
-    if (bias.getType().isa<Torch::NoneType>()) {
-      Value c0float = rewriter.create<arith::ConstantOp>(
-          loc, FloatAttr::get(elementType, 0.0));
-      outputTensor = rewriter.create<linalg::FillOp>(loc, c0float, initTensor)
-                         .getResult(0);
-    } else {
-      auto biasType = bias.getType().cast<RankedTensorType>();
-      if (biasType.getRank() != 1)
-        return rewriter.notifyMatchFailure(op, "expect bias to be rank 1");
-      if (elementType != biasType.getElementType())
-        return rewriter.notifyMatchFailure(op, "unimplemented: type promotion");
-
-      auto resultRank = initTensor.getType().cast<RankedTensorType>().getRank();
-      SmallVector<AffineMap> indexingMaps = {
-          // bias is used to initialize the channels - dimension 1 of output
-          AffineMap::get(/*dimCount=*/resultRank, /*symbolCount=*/0,
-                         rewriter.getAffineDimExpr(1), context),
-          rewriter.getMultiDimIdentityMap(resultRank)};
-      SmallVector<utils::IteratorType> iteratorTypes(
-          resultRank, utils::IteratorType::parallel);
-      outputTensor = rewriter
-                         .create<linalg::GenericOp>(
-                             loc, initTensor.getType(), bias, initTensor,
-                             indexingMaps, iteratorTypes,
-                             [](OpBuilder &b, Location loc, ValueRange args) {
-                               b.create<linalg::YieldOp>(loc, args[0]);
-                             })
-                         .getResult(0);
-    }
+    FailureOr<Value> maybeOutputTensor =
+        createOutputTensor(initTensor, /*channelDim=*/1);
+    if (failed(maybeOutputTensor))
+      return failure();
+    Value outputTensor = *maybeOutputTensor;
 
     auto stridesAttr = rewriter.getI64VectorAttr(strideInts);
     auto dilationAttr = rewriter.getI64VectorAttr(dilationInts);
@@ -829,12 +1031,15 @@ public:
     rewriter.replaceOpWithNewOp<tensor::CastOp>(op, newResultType, conv);
     return success();
   }
+
+private:
+  torch_to_linalg::TorchToLinalgOptions options;
 };
 } // namespace
 
 void mlir::torch::torch_to_linalg::populateLinearPatternsAndLegality(
     TypeConverter &typeConverter, RewritePatternSet &patterns,
-    ConversionTarget &target) {
+    ConversionTarget &target, const TorchToLinalgOptions &options) {
   MLIRContext *context = patterns.getContext();
   target.addIllegalOp<AtenMmOp>();
   patterns.add<ConvertAtenMmOp>(typeConverter, context);
@@ -845,5 +1050,5 @@ void mlir::torch::torch_to_linalg::populateLinearPatternsAndLegality(
   target.addIllegalOp<AtenBmmOp>();
   patterns.add<ConvertAtenBmmOp>(typeConverter, context);
   target.addIllegalOp<AtenConvolutionOp>();
-  patterns.add<ConvertAtenConvolutionOp>(typeConverter, context);
+  patterns.add<ConvertAtenConvolutionOp>(typeConverter, context, options);
 }
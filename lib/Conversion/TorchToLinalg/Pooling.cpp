@@ -22,6 +22,7 @@
 #include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
 #include "torch-mlir/Dialect/Torch/Utils/TorchUpstream.h"
 #include "torch-mlir/Dialect/Torch/Utils/Utils.h"
+#include "torch-mlir/Dialect/TorchConversion/IR/TorchConversionOps.h"
 
 using namespace mlir;
 using namespace mlir::torch;
@@ -58,8 +59,31 @@ checkAndGetPoolingParameters(OpTy op, ConversionPatternRewriter &rewriter,
   return success();
 }
 
+// Kernels with at least this many elements are pooled separably: a row pass
+// over 1 x kW windows followed by a column pass over kH x 1 windows, which
+// reads kH + kW input elements per output instead of kH * kW.
+static constexpr int64_t kSeparablePoolingMinWindowSize = 25;
+
+// Returns true and stores the kernel size in `kernelInts` if it is constant
+// and large enough for the separable lowering to pay off.
+static bool
+isSeparablePoolingProfitable(ArrayRef<Value> kernelSizeIntValues,
+                             SmallVectorImpl<int64_t> &kernelInts) {
+  for (Value kernelSize : kernelSizeIntValues) {
+    int64_t size;
+    auto toI64 = kernelSize.getDefiningOp<TorchConversion::ToI64Op>();
+    if (!toI64 ||
+        !matchPattern(toI64.getOperand(), m_TorchConstantInt(&size)))
+      return false;
+    kernelInts.push_back(size);
+  }
+  return kernelInts[0] > 1 && kernelInts[1] > 1 &&
+         kernelInts[0] * kernelInts[1] >= kSeparablePoolingMinWindowSize;
+}
+
 // Creates a pooling operation based on the type specified by `OpTy` and
-// arguments passed.
+// arguments passed. `self` and `outTensorShape` are in NHWC layout if `OpTy`
+// is an NHWC pooling op, and in NCHW layout otherwise.
 template <typename OpTy>
 static LogicalResult createPoolingOp(
     Operation *op, ConversionPatternRewriter &rewriter, Value self,
@@ -73,12 +97,19 @@ static LogicalResult createPoolingOp(
   if (!elementType.isa<mlir::FloatType>() && !supportNonFPInput)
     return op->emitError("unimplemented: non-floating point type");
 
-  SmallVector<int64_t, 4> lowPaddingIncludingNC = {0, 0};
-  lowPaddingIncludingNC.append(paddingInts);
+  constexpr bool isNhwc = std::is_same<OpTy, linalg::PoolingNhwcMaxOp>() ||
+                          std::is_same<OpTy, linalg::PoolingNhwcSumOp>();
+  constexpr int64_t cDim = isNhwc ? 3 : 1;
+  constexpr int64_t hDim = isNhwc ? 1 : 2;
+  constexpr int64_t wDim = isNhwc ? 2 : 3;
+
+  SmallVector<int64_t, 4> lowPaddingIncludingNC(4, 0);
+  lowPaddingIncludingNC[hDim] = paddingInts[0];
+  lowPaddingIncludingNC[wDim] = paddingInts[1];
   SmallVector<int64_t, 4> highPaddingIncludingNC = lowPaddingIncludingNC;
   if (ceilMode) {
-    highPaddingIncludingNC[2] += strideInts[0];
-    highPaddingIncludingNC[3] += strideInts[1];
+    highPaddingIncludingNC[hDim] += strideInts[0];
+    highPaddingIncludingNC[wDim] += strideInts[1];
   }
   Value initValue = rewriter.create<arith::ConstantOp>(loc, initValueAttr);
   paddedInput = torch_to_linalg::getPaddedTensor(
@@ -86,9 +117,9 @@ static LogicalResult createPoolingOp(
       initValue);
 
   Value N = getDimOp(rewriter, loc, self, 0);
-  Value C = getDimOp(rewriter, loc, self, 1);
-  Value H = getDimOp(rewriter, loc, self, 2);
-  Value W = getDimOp(rewriter, loc, self, 3);
+  Value C = getDimOp(rewriter, loc, self, cDim);
+  Value H = getDimOp(rewriter, loc, self, hDim);
+  Value W = getDimOp(rewriter, loc, self, wDim);
 
   SmallVector<Value> paddingIntValues =
       getAsConstantIntValues(rewriter, loc, paddingInts);
@@ -105,10 +136,44 @@ static LogicalResult createPoolingOp(
       kernelSizeIntValues[1], strideIntValues[1], ceilMode);
 
   // Create output tensor initialized with smallest floating point value.
-  outTensorShape.insert(outTensorShape.begin(), {N, C, hOut, wOut});
+  if (isNhwc)
+    outTensorShape.insert(outTensorShape.begin(), {N, hOut, wOut, C});
+  else
+    outTensorShape.insert(outTensorShape.begin(), {N, C, hOut, wOut});
   Value outTensorInitialized =
       createInitTensor(rewriter, loc, outTensorShape, elementType, initValue);
 
+  // Max and sum pooling are both separable, so large windows are reduced
+  // along W first, keeping every padded row, and then along H.
+  SmallVector<int64_t, 2> kernelInts;
+  if (isSeparablePoolingProfitable(kernelSizeIntValues, kernelInts)) {
+    SmallVector<Value, 4> rowPoolShape(outTensorShape.begin(),
+                                       outTensorShape.end());
+    rowPoolShape[hDim] = getDimOp(rewriter, loc, paddedInput, hDim);
+    Value rowPoolInitialized =
+        createInitTensor(rewriter, loc, rowPoolShape, elementType, initValue);
+    Value rowWindow = rewriter.create<tensor::EmptyOp>(
+        loc, ArrayRef<int64_t>{1, kernelInts[1]}, elementType);
+    Value rowPool =
+        rewriter
+            .create<OpTy>(loc, rowPoolInitialized.getType(),
+                          ValueRange{paddedInput, rowWindow},
+                          rowPoolInitialized,
+                          rewriter.getI64VectorAttr({1, strideInts[1]}),
+                          rewriter.getI64VectorAttr({1, dilationInts[1]}))
+            .getResult(0);
+    Value columnWindow = rewriter.create<tensor::EmptyOp>(
+        loc, ArrayRef<int64_t>{kernelInts[0], 1}, elementType);
+    result = rewriter
+                 .create<OpTy>(loc, outTensorInitialized.getType(),
+                               ValueRange{rowPool, columnWindow},
+                               outTensorInitialized,
+                               rewriter.getI64VectorAttr({strideInts[0], 1}),
+                               rewriter.getI64VectorAttr({dilationInts[0], 1}))
+                 .getResult(0);
+    return success();
+  }
+
   auto stridesAttr = rewriter.getI64VectorAttr(strideInts);
   auto dilationAttr = rewriter.getI64VectorAttr(dilationInts);
   auto shape = castIntVectorToIndexVector(rewriter, loc, kernelSizeIntValues);
@@ -127,7 +192,10 @@ static LogicalResult createPoolingOp(
 namespace {
 class ConvertAtenMaxPool2dOp : public OpConversionPattern<AtenMaxPool2dOp> {
 public:
-  using OpConversionPattern::OpConversionPattern;
+  ConvertAtenMaxPool2dOp(TypeConverter &typeConverter, MLIRContext *context,
+                         const torch_to_linalg::TorchToLinalgOptions &options)
+      : OpConversionPattern<AtenMaxPool2dOp>(typeConverter, context),
+        options(options) {}
   LogicalResult
   matchAndRewrite(AtenMaxPool2dOp op, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
@@ -162,15 +230,30 @@ public:
     SmallVector<Value, 4> outTensorShape;
     // `maxpool2d` contains the result of maxpool2d operation over the input.
     Value maxPool2d, paddedInput;
-    if (failed(createPoolingOp<linalg::PoolingNchwMaxOp>(
-            op, rewriter, self, /*supportNonFPInput=*/false, ceilMode,
-            kernelSizeIntValues, strideInts, paddingInts, dilationInts,
-            smallestFPValueAttr, outTensorShape, paddedInput, maxPool2d)))
+    if (options.useNhwcLayout) {
+      Value nhwcSelf = torch_to_linalg::createTransposeLinalgGeneric(
+          rewriter, op.getLoc(), self, {0, 2, 3, 1});
+      if (failed(createPoolingOp<linalg::PoolingNhwcMaxOp>(
+              op, rewriter, nhwcSelf, /*supportNonFPInput=*/false, ceilMode,
+              kernelSizeIntValues, strideInts, paddingInts, dilationInts,
+              smallestFPValueAttr, outTensorShape, paddedInput, maxPool2d)))
+        return rewriter.notifyMatchFailure(op, "unable to compute maxpool2d");
+      maxPool2d = torch_to_linalg::createTransposeLinalgGeneric(
+          rewriter, op.getLoc(), maxPool2d, {0, 3, 1, 2});
+    } else if (failed(createPoolingOp<linalg::PoolingNchwMaxOp>(
+                   op, rewriter, self, /*supportNonFPInput=*/false, ceilMode,
+                   kernelSizeIntValues, strideInts, paddingInts, dilationInts,
+                   smallestFPValueAttr, outTensorShape, paddedInput,
+                   maxPool2d))) {
       return rewriter.notifyMatchFailure(op, "unable to compute maxpool2d");
+    }
     Type newResultType = getTypeConverter()->convertType(op.getType());
     rewriter.replaceOpWithNewOp<tensor::CastOp>(op, newResultType, maxPool2d);
     return success();
   }
+
+private:
+  torch_to_linalg::TorchToLinalgOptions options;
 };
 } // namespace
 
@@ -357,7 +440,10 @@ public:
 namespace {
 class ConvertAtenAvgPool2dOp : public OpConversionPattern<AtenAvgPool2dOp> {
 public:
-  using OpConversionPattern::OpConversionPattern;
+  ConvertAtenAvgPool2dOp(TypeConverter &typeConverter, MLIRContext *context,
+                         const torch_to_linalg::TorchToLinalgOptions &options)
+      : OpConversionPattern<AtenAvgPool2dOp>(typeConverter, context),
+        options(options) {}
   LogicalResult
   matchAndRewrite(AtenAvgPool2dOp op, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
@@ -393,14 +479,26 @@ public:
     }
 
     // `sumPool2d` contains the result of sumpool2d operation over the input.
+    // With `useNhwcLayout`, it is in NHWC layout, as well as `outTensorShape`
+    // and the average computed from them below.
     Value sumPool2d, paddedInput;
     SmallVector<Value, 4> outTensorShape;
-    if (failed(createPoolingOp<linalg::PoolingNchwSumOp>(
-            op, rewriter, self, /*supportNonFPInput=*/true, ceilMode,
-            kernelSizeIntValues, strideInts, paddingInts, dilationInts,
-            rewriter.getZeroAttr(inputElementType), outTensorShape, paddedInput,
-            sumPool2d)))
+    if (options.useNhwcLayout) {
+      Value nhwcSelf = torch_to_linalg::createTransposeLinalgGeneric(
+          rewriter, loc, self, {0, 2, 3, 1});
+      if (failed(createPoolingOp<linalg::PoolingNhwcSumOp>(
+              op, rewriter, nhwcSelf, /*supportNonFPInput=*/true, ceilMode,
+              kernelSizeIntValues, strideInts, paddingInts, dilationInts,
+              rewriter.getZeroAttr(inputElementType), outTensorShape,
+              paddedInput, sumPool2d)))
+        return rewriter.notifyMatchFailure(op, "unable to compute sumpool2d");
+    } else if (failed(createPoolingOp<linalg::PoolingNchwSumOp>(
+                   op, rewriter, self, /*supportNonFPInput=*/true, ceilMode,
+                   kernelSizeIntValues, strideInts, paddingInts, dilationInts,
+                   rewriter.getZeroAttr(inputElementType), outTensorShape,
+                   paddedInput, sumPool2d))) {
       return rewriter.notifyMatchFailure(op, "unable to compute sumpool2d");
+    }
 
     Value kHtimeskW = rewriter.create<arith::MulIOp>(
         loc, kernelSizeIntValues[0], kernelSizeIntValues[1]);
@@ -432,20 +530,26 @@ public:
                 })
             .getResult(0);
 
+    if (options.useNhwcLayout)
+      avgPool2d = torch_to_linalg::createTransposeLinalgGeneric(
+          rewriter, loc, avgPool2d, {0, 3, 1, 2});
     rewriter.replaceOpWithNewOp<tensor::CastOp>(op, resultType, avgPool2d);
     return success();
   }
+
+private:
+  torch_to_linalg::TorchToLinalgOptions options;
 };
 } // namespace
 
 void mlir::torch::torch_to_linalg::populatePoolingPatternsAndLegality(
     TypeConverter &typeConverter, RewritePatternSet &patterns,
-    ConversionTarget &target) {
+    ConversionTarget &target, const TorchToLinalgOptions &options) {
   MLIRContext *context = patterns.getContext();
   target.addIllegalOp<AtenMaxPool2dOp>();
-  patterns.add<ConvertAtenMaxPool2dOp>(typeConverter, context);
+  patterns.add<ConvertAtenMaxPool2dOp>(typeConverter, context, options);
   target.addIllegalOp<AtenMaxPool2dWithIndicesOp>();
   patterns.add<ConvertAtenMaxPool2dWithIndicesOp>(typeConverter, context);
   target.addIllegalOp<AtenAvgPool2dOp>();
-  patterns.add<ConvertAtenAvgPool2dOp>(typeConverter, context);
+  patterns.add<ConvertAtenAvgPool2dOp>(typeConverter, context, options);
 }
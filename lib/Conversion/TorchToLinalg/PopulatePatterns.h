@@ -36,15 +36,28 @@ namespace torch_to_linalg {
 // lacks enough support for dynamic shapes and error assertions to be used
 // for this purpose.
 
+struct TorchToLinalgOptions {
+  // Lower 2D convolutions and pooling ops to their NHWC named op variants,
+  // with transposes at the op boundary.
+  bool useNhwcLayout = false;
+};
+
 void populateTensorScalarInteropPatternsAndLegality(
     TypeConverter &typeConverter, RewritePatternSet &patterns,
     ConversionTarget &target);
 void populateLinearPatternsAndLegality(TypeConverter &typeConverter,
                                        RewritePatternSet &patterns,
-                                       ConversionTarget &target);
+                                       ConversionTarget &target,
+                                       const TorchToLinalgOptions &options);
 void populatePoolingPatternsAndLegality(TypeConverter &typeConverter,
                                         RewritePatternSet &patterns,
-                                        ConversionTarget &target);
+                                        ConversionTarget &target,
+                                        const TorchToLinalgOptions &options);
+// The type converter must convert quantized tensors to their integer
+// representation, see `setupQuantizedTensorToBuiltinTensorConversion`.
+void populateQuantizedPatternsAndLegality(TypeConverter &typeConverter,
+                                          RewritePatternSet &patterns,
+                                          ConversionTarget &target);
 void populateRandomPatternsAndLegality(TypeConverter &typeConverter,
                                        RewritePatternSet &patterns,
                                        ConversionTarget &target);
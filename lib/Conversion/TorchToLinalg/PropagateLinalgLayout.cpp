@@ -0,0 +1,270 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+//
+// With `use-nhwc-layout`, TorchToLinalg wraps each NHWC convolution and
+// pooling op in a pair of transposes (`linalg.generic` ops created by
+// `createTransposeLinalgGeneric`). This pass sinks those transposes through
+// elementwise `linalg.generic` ops so that the NHWC->NCHW transpose of one
+// layer meets the NCHW->NHWC transpose of the next and both fold away.
+//
+// TorchToLinalg ends every converted op with a `tensor.cast` to the converted
+// result type, so the patterns look through chains of casts between a
+// transpose and its user. Transposes of constants, such as the HWCF weights
+// of convolutions, are folded into new constants, so they are not recomputed
+// on every call.
+//
+//===----------------------------------------------------------------------===//
+
+#include "torch-mlir/Conversion/TorchToLinalg/TorchToLinalg.h"
+
+#include "../PassDetail.h"
+#include "Utils.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Linalg/Transforms/Transforms.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+#include "torch-mlir/Conversion/Utils/Utils.h"
+
+using namespace mlir;
+using namespace mlir::torch;
+using namespace mlir::torch::Torch;
+
+namespace {
+
+// Returns the permutation of `op` if it is a transpose, in the convention of
+// `createTransposeLinalgGeneric`: result dim `i` is input dim `perm[i]`.
+// Identity permutations (plain copies) are not considered transposes.
+static std::optional<SmallVector<int64_t>>
+getTransposePermutation(linalg::GenericOp op) {
+  if (op.getNumDpsInputs() != 1 || op.getNumDpsInits() != 1)
+    return std::nullopt;
+  if (op.getNumParallelLoops() != op.getNumLoops())
+    return std::nullopt;
+  SmallVector<AffineMap> maps = op.getIndexingMapsArray();
+  if (!maps[1].isIdentity() || !maps[0].isPermutation() ||
+      maps[0].isIdentity())
+    return std::nullopt;
+
+  Block *body = op.getBody();
+  auto yield = dyn_cast<linalg::YieldOp>(body->getTerminator());
+  if (!yield || body->getOperations().size() != 1 ||
+      yield.getValues().size() != 1 ||
+      yield.getValues()[0] != body->getArgument(0))
+    return std::nullopt;
+
+  // The input map sends input dim `j` to loop `maps[0].getDimPosition(j)`,
+  // i.e. result dim `maps[0].getDimPosition(j)` is input dim `j`.
+  SmallVector<int64_t> perm(op.getNumLoops());
+  for (unsigned j = 0, e = maps[0].getNumResults(); j < e; ++j)
+    perm[maps[0].getDimPosition(j)] = j;
+  return perm;
+}
+
+// Returns the `linalg.generic` that produces `value`, looking through
+// `tensor.cast`s. If `requireOneUse` is set, the generic and every cast in
+// between must have a single use.
+static linalg::GenericOp getGenericThroughCasts(Value value,
+                                                bool requireOneUse) {
+  while (auto cast = value.getDefiningOp<tensor::CastOp>()) {
+    if (requireOneUse && !cast->hasOneUse())
+      return nullptr;
+    value = cast.getSource();
+  }
+  auto generic = value.getDefiningOp<linalg::GenericOp>();
+  if (!generic || (requireOneUse && !generic->hasOneUse()))
+    return nullptr;
+  return generic;
+}
+
+static bool isIdentityPermutation(ArrayRef<int64_t> perm) {
+  for (auto en : llvm::enumerate(perm))
+    if (en.value() != static_cast<int64_t>(en.index()))
+      return false;
+  return true;
+}
+
+static Value castIfNeeded(OpBuilder &b, Location loc, Value value, Type type) {
+  if (value.getType() == type)
+    return value;
+  return b.create<tensor::CastOp>(loc, type, value);
+}
+
+// transpose(transpose(x, p1), p2) -> transpose(x, p1 o p2), or x if the
+// composition is the identity.
+class FoldTransposeOfTranspose : public OpRewritePattern<linalg::GenericOp> {
+public:
+  using OpRewritePattern::OpRewritePattern;
+  LogicalResult matchAndRewrite(linalg::GenericOp op,
+                                PatternRewriter &rewriter) const override {
+    std::optional<SmallVector<int64_t>> outerPerm =
+        getTransposePermutation(op);
+    if (!outerPerm)
+      return rewriter.notifyMatchFailure(op, "not a transpose");
+    auto inner = getGenericThroughCasts(op.getDpsInputOperand(0)->get(),
+                                        /*requireOneUse=*/false);
+    if (!inner)
+      return rewriter.notifyMatchFailure(op, "input is not a linalg.generic");
+    std::optional<SmallVector<int64_t>> innerPerm =
+        getTransposePermutation(inner);
+    if (!innerPerm)
+      return rewriter.notifyMatchFailure(op, "input is not a transpose");
+
+    SmallVector<int64_t> perm;
+    for (int64_t dim : *outerPerm)
+      perm.push_back((*innerPerm)[dim]);
+
+    Location loc = op.getLoc();
+    Value source = inner.getDpsInputOperand(0)->get();
+    Value result =
+        isIdentityPermutation(perm)
+            ? source
+            : torch_to_linalg::createTransposeLinalgGeneric(rewriter, loc,
+                                                            source, perm);
+    rewriter.replaceOp(
+        op, castIfNeeded(rewriter, loc, result, op.getResult(0).getType()));
+    return success();
+  }
+};
+
+// Rewrites an elementwise `linalg.generic` whose inputs include transposes
+// with the same permutation into the same generic over the untransposed
+// values, followed by a transpose of each of its results. The other operands
+// are read through their indexing maps composed with the permutation, which
+// also covers broadcasted operands such as biases.
+class SinkTransposeThroughElementwise
+    : public OpRewritePattern<linalg::GenericOp> {
+public:
+  using OpRewritePattern::OpRewritePattern;
+  LogicalResult matchAndRewrite(linalg::GenericOp op,
+                                PatternRewriter &rewriter) const override {
+    if (op.getNumParallelLoops() != op.getNumLoops())
+      return rewriter.notifyMatchFailure(op, "not elementwise");
+    if (!op.hasTensorSemantics())
+      return rewriter.notifyMatchFailure(op, "expected tensor semantics");
+    if (!op.getBody()->getOps<linalg::IndexOp>().empty())
+      return rewriter.notifyMatchFailure(op, "payload depends on indices");
+    for (OpOperand *init : op.getDpsInitOperands()) {
+      if (!op.getMatchingIndexingMap(init).isIdentity() ||
+          op.payloadUsesValueFromOperand(init))
+        return rewriter.notifyMatchFailure(op, "unsupported init operand");
+    }
+
+    // Find the inputs that are single-use transposes (possibly behind
+    // casts) read with an identity map. They all have to share the same
+    // permutation.
+    std::optional<SmallVector<int64_t>> perm;
+    SmallVector<Value> sources;
+    SmallVector<OpOperand *> transposedInputs;
+    for (OpOperand *input : op.getDpsInputOperands()) {
+      auto transpose =
+          getGenericThroughCasts(input->get(), /*requireOneUse=*/true);
+      if (!transpose || !op.getMatchingIndexingMap(input).isIdentity())
+        continue;
+      std::optional<SmallVector<int64_t>> inputPerm =
+          getTransposePermutation(transpose);
+      if (!inputPerm || (perm && *perm != *inputPerm))
+        continue;
+      perm = inputPerm;
+      sources.push_back(transpose.getDpsInputOperand(0)->get());
+      transposedInputs.push_back(input);
+    }
+    // Each result gets a transpose, so only sink when that does not increase
+    // the number of transposes.
+    if (!perm || transposedInputs.size() < op.getNumResults())
+      return rewriter.notifyMatchFailure(op, "no transpose to sink");
+
+    // Loop `i` of `op` is dim `perm[i]` of the untransposed values, so the
+    // maps of the new op are the old ones composed with `d_i -> d_perm[i]`.
+    MLIRContext *context = op.getContext();
+    int64_t rank = perm->size();
+    SmallVector<AffineExpr> permExprs;
+    for (int64_t dim : *perm)
+      permExprs.push_back(rewriter.getAffineDimExpr(dim));
+    AffineMap permMap =
+        AffineMap::get(rank, /*symbolCount=*/0, permExprs, context);
+
+    Location loc = op.getLoc();
+    SmallVector<Value> newInputs;
+    SmallVector<AffineMap> newMaps;
+    for (OpOperand *input : op.getDpsInputOperands()) {
+      auto it = llvm::find(transposedInputs, input);
+      if (it != transposedInputs.end()) {
+        newInputs.push_back(sources[it - transposedInputs.begin()]);
+        newMaps.push_back(rewriter.getMultiDimIdentityMap(rank));
+        continue;
+      }
+      newInputs.push_back(input->get());
+      newMaps.push_back(op.getMatchingIndexingMap(input).compose(permMap));
+    }
+
+    SmallVector<OpFoldResult> sizes;
+    for (int64_t dim = 0; dim < rank; ++dim)
+      sizes.push_back(
+          getAsOpFoldResult(getDimOp(rewriter, loc, sources[0], dim)));
+    SmallVector<Value> newInits;
+    SmallVector<Type> newResultTypes;
+    for (OpOperand *init : op.getDpsInitOperands()) {
+      Type elementType =
+          init->get().getType().cast<RankedTensorType>().getElementType();
+      Value empty = rewriter.create<tensor::EmptyOp>(loc, sizes, elementType);
+      newInits.push_back(empty);
+      newResultTypes.push_back(empty.getType());
+      newMaps.push_back(rewriter.getMultiDimIdentityMap(rank));
+    }
+
+    auto newOp = rewriter.create<linalg::GenericOp>(
+        loc, newResultTypes, newInputs, newInits, newMaps,
+        op.getIteratorTypesArray());
+    rewriter.inlineRegionBefore(op.getRegion(), newOp.getRegion(),
+                                newOp.getRegion().begin());
+
+    SmallVector<Value> replacements;
+    for (auto [oldResult, newResult] :
+         llvm::zip(op.getResults(), newOp.getResults())) {
+      Value transposed = torch_to_linalg::createTransposeLinalgGeneric(
+          rewriter, loc, newResult, *perm);
+      replacements.push_back(
+          castIfNeeded(rewriter, loc, transposed, oldResult.getType()));
+    }
+    rewriter.replaceOp(op, replacements);
+    return success();
+  }
+};
+
+class PropagateLinalgLayout
+    : public PropagateLinalgLayoutBase<PropagateLinalgLayout> {
+public:
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<linalg::LinalgDialect>();
+    registry.insert<tensor::TensorDialect>();
+  }
+
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+    RewritePatternSet patterns(context);
+    patterns.add<FoldTransposeOfTranspose, SinkTransposeThroughElementwise>(
+        context);
+    // Fold transposes of constants that have no other use, so that the
+    // weights are stored in the layout the NHWC ops read them in.
+    linalg::populateConstantFoldLinalgOperations(
+        patterns,
+        [](OpOperand *operand) { return operand->get().hasOneUse(); });
+    tensor::CastOp::getCanonicalizationPatterns(patterns, context);
+    tensor::DimOp::getCanonicalizationPatterns(patterns, context);
+    if (failed(applyPatternsAndFoldGreedily(getOperation(),
+                                            std::move(patterns))))
+      return signalPassFailure();
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::torch::createPropagateLinalgLayoutPass() {
+  return std::make_unique<PropagateLinalgLayout>();
+}
@@ -0,0 +1,582 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "torch-mlir/Conversion/TorchToLinalg/TorchToLinalg.h"
+
+#include "../PassDetail.h"
+#include "PopulatePatterns.h"
+#include "Utils.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Math/IR/Math.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/IR/Matchers.h"
+#include "torch-mlir/Conversion/Utils/Utils.h"
+#include "torch-mlir/Dialect/Torch/IR/TorchDialect.h"
+#include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
+#include "torch-mlir/Dialect/Torch/Utils/Utils.h"
+#include <cmath>
+
+using namespace mlir;
+using namespace mlir::torch;
+using namespace mlir::torch::Torch;
+
+namespace {
+// A per-tensor affine quantized tensor, with its integer representation
+// converted to a builtin tensor of signed 8-bit values. Unsigned
+// representations are shifted into the signed range by flipping their sign
+// bit, which maps `q` to `q - 128`, and their zero point is shifted to match.
+// This lets both signednesses use the sign-extending `linalg.quantized_matmul`.
+struct PerTensorQuantizedValue {
+  Value intRepr;
+  double scale;
+  int64_t zeroPoint;
+};
+} // namespace
+
+// PyTorch's quantized tanh maps its output range [-1, 1] onto all of quint8,
+// whatever the parameters of its input.
+static constexpr double kQUInt8TanhScale = 2.0 / 256.0;
+static constexpr int64_t kQUInt8TanhZeroPoint = 128;
+
+static bool hasQUInt8Dtype(Value value) {
+  Type dtype = value.getType().cast<BaseTensorType>().getOptionalDtype();
+  return dtype && dtype.isa<QUInt8Type>();
+}
+
+// Converting a quantized tensor to its integer representation drops its scale
+// and zero point. Consumers recover them from the producer, so the only
+// producers understood are `torch.per_tensor_affine.create`,
+// `aten::quantize_per_tensor` and `quantized::linear` with constant
+// quantization parameters, and quint8 `aten::tanh`.
+static LogicalResult getPerTensorQuantizationParams(Value quantized,
+                                                    double &scale,
+                                                    int64_t &zeroPoint) {
+  Value scaleValue, zeroPointValue;
+  if (auto create = quantized.getDefiningOp<PerTensorAffineCreateOp>()) {
+    scaleValue = create.getScale();
+    zeroPointValue = create.getOffset();
+  } else if (auto quantize =
+                 quantized.getDefiningOp<AtenQuantizePerTensorOp>()) {
+    scaleValue = quantize.getScale();
+    zeroPointValue = quantize.getZeroPoint();
+  } else if (auto linear = quantized.getDefiningOp<QuantizedLinearOp>()) {
+    scaleValue = linear.getYScaleI();
+    zeroPointValue = linear.getYZeroPointI();
+  } else if (quantized.getDefiningOp<AtenTanhOp>() &&
+             hasQUInt8Dtype(quantized)) {
+    scale = kQUInt8TanhScale;
+    zeroPoint = kQUInt8TanhZeroPoint;
+    return success();
+  } else {
+    return failure();
+  }
+  if (!matchPattern(scaleValue, m_TorchConstantFloat(&scale)) ||
+      !matchPattern(zeroPointValue, m_TorchConstantInt(&zeroPoint)))
+    return failure();
+  return success();
+}
+
+// Producers of quantized tensors are only converted when all their users read
+// the quantization parameters with `getPerTensorQuantizationParams`. Any other
+// user would see a bare integer tensor, so the producer is left illegal and
+// the conversion fails instead.
+static bool isConsumedBySupportedQuantizedOps(Value quantized) {
+  return llvm::all_of(quantized.getUses(), [](OpOperand &use) {
+    Operation *user = use.getOwner();
+    if (auto linear = dyn_cast<QuantizedLinearOp>(user))
+      return use.get() == linear.getX();
+    if (auto params = dyn_cast<LinearParamsCreateOp>(user)) {
+      return use.get() == params.getWeight() &&
+             llvm::all_of(params->getUsers(), [](Operation *paramsUser) {
+               return isa<QuantizedLinearOp>(paramsUser);
+             });
+    }
+    if (isa<AtenTanhOp>(user))
+      return hasQUInt8Dtype(use.get());
+    return isa<AtenDequantizeSelfOp>(user);
+  });
+}
+
+static FailureOr<PerTensorQuantizedValue>
+getPerTensorQuantizedValue(OpBuilder &b, Location loc, Value quantized,
+                           Value intRepr) {
+  PerTensorQuantizedValue result;
+  if (failed(getPerTensorQuantizationParams(quantized, result.scale,
+                                            result.zeroPoint)))
+    return failure();
+  auto builtinType = intRepr.getType().dyn_cast<RankedTensorType>();
+  if (!builtinType || !builtinType.getElementType().isInteger(8))
+    return failure();
+  result.intRepr = intRepr;
+
+  Type dtype = quantized.getType().cast<BaseTensorType>().getOptionalDtype();
+  if (dtype && dtype.isa<QUInt8Type>()) {
+    int64_t rank = builtinType.getRank();
+    SmallVector<AffineMap> indexingMaps(2, b.getMultiDimIdentityMap(rank));
+    SmallVector<utils::IteratorType> iteratorTypes(
+        rank, utils::IteratorType::parallel);
+    Value signBit = b.create<arith::ConstantOp>(
+        loc, b.getIntegerAttr(builtinType.getElementType(), -128));
+    Value init = b.create<tensor::EmptyOp>(
+        loc, getAsOpFoldResult(getTensorSizes(b, loc, intRepr)),
+        builtinType.getElementType());
+    result.intRepr =
+        b.create<linalg::GenericOp>(
+             loc, init.getType(), intRepr, init, indexingMaps, iteratorTypes,
+             [&](OpBuilder &b, Location loc, ValueRange args) {
+               Value flipped = b.create<arith::XOrIOp>(loc, args[0], signBit);
+               b.create<linalg::YieldOp>(loc, flipped);
+             })
+            .getResult(0);
+    result.zeroPoint -= 128;
+  } else if (!dtype || !dtype.isa<QInt8Type>()) {
+    return failure();
+  }
+  return result;
+}
+
+// Rounds half to even, like the `nearbyint` used by PyTorch when quantizing.
+static Value createRoundHalfToEven(OpBuilder &b, Location loc, Value value) {
+  Type type = value.getType();
+  Value half = b.create<arith::ConstantOp>(loc, FloatAttr::get(type, 0.5));
+  Value one = b.create<arith::ConstantOp>(loc, FloatAttr::get(type, 1.0));
+  Value two = b.create<arith::ConstantOp>(loc, FloatAttr::get(type, 2.0));
+  Value floor = b.create<math::FloorOp>(loc, value);
+  Value fraction = b.create<arith::SubFOp>(loc, value, floor);
+  // On a tie, round up iff `floor` is odd.
+  Value floorIsOdd = b.create<math::AbsFOp>(
+      loc, b.create<arith::RemFOp>(loc, floor, two));
+  Value tieRoundUp = b.create<arith::AddFOp>(loc, floor, floorIsOdd);
+  Value roundUp = b.create<arith::AddFOp>(loc, floor, one);
+  Value isAboveHalf = b.create<arith::CmpFOp>(loc, arith::CmpFPredicate::OGT,
+                                              fraction, half);
+  Value isBelowHalf = b.create<arith::CmpFOp>(loc, arith::CmpFPredicate::OLT,
+                                              fraction, half);
+  Value rounded =
+      b.create<arith::SelectOp>(loc, isBelowHalf, floor, tieRoundUp);
+  return b.create<arith::SelectOp>(loc, isAboveHalf, roundUp, rounded);
+}
+
+// Rounds a value that is already divided by the output scale, adds the zero
+// point and clamps it to the range of the quantized type, all in f32 like
+// PyTorch. Returns the i8 bit pattern of the quantized value.
+static Value createQuantizedValue(OpBuilder &b, Location loc, Value scaled,
+                                  int64_t zeroPoint, bool isUnsigned) {
+  auto f32Const = [&](float value) -> Value {
+    return b.create<arith::ConstantOp>(loc, b.getF32FloatAttr(value));
+  };
+  Value value = createRoundHalfToEven(b, loc, scaled);
+  value = b.create<arith::AddFOp>(loc, value, f32Const(zeroPoint));
+  value = b.create<arith::MaxFOp>(loc, value, f32Const(isUnsigned ? 0 : -128));
+  value = b.create<arith::MinFOp>(loc, value, f32Const(isUnsigned ? 255 : 127));
+  // The clamp above keeps the conversion in range, and truncating to i8 keeps
+  // the bit pattern of unsigned values.
+  value = b.create<arith::FPToSIOp>(loc, b.getI32Type(), value);
+  return b.create<arith::TruncIOp>(loc, b.getI8Type(), value);
+}
+
+// Quantizes a float like PyTorch: `nearbyint(x * (1 / scale)) + zero_point`,
+// clamped, with the inverse scale rounded to f32.
+static Value createQuantize(OpBuilder &b, Location loc, Value value,
+                            double scale, int64_t zeroPoint, bool isUnsigned) {
+  Type f32 = b.getF32Type();
+  float inverseScale = 1.0f / static_cast<float>(scale);
+  value = convertScalarToDtype(b, loc, value, f32);
+  value = b.create<arith::MulFOp>(
+      loc, value,
+      b.create<arith::ConstantOp>(loc, b.getF32FloatAttr(inverseScale)));
+  return createQuantizedValue(b, loc, value, zeroPoint, isUnsigned);
+}
+
+// Dequantizes the i8 bit pattern of a quantized value to
+// `(q - zero_point) * scale` in `elementType`.
+static Value createDequantize(OpBuilder &b, Location loc, Value value,
+                              double scale, int64_t zeroPoint, bool isUnsigned,
+                              Type elementType) {
+  Type i32 = b.getI32Type();
+  value = isUnsigned ? b.create<arith::ExtUIOp>(loc, i32, value).getResult()
+                     : b.create<arith::ExtSIOp>(loc, i32, value).getResult();
+  value = b.create<arith::SubIOp>(
+      loc, value,
+      b.create<arith::ConstantOp>(loc, b.getI32IntegerAttr(zeroPoint)));
+  value = b.create<arith::SIToFPOp>(loc, elementType, value);
+  return b.create<arith::MulFOp>(
+      loc, value,
+      b.create<arith::ConstantOp>(loc, FloatAttr::get(elementType, scale)));
+}
+
+// Creates a parallel `linalg.generic` mapping `input` to a tensor of the same
+// shape with `elementType`, computing each element with `body`.
+static Value createElementwiseMap(
+    OpBuilder &b, Location loc, Value input, Type elementType,
+    function_ref<Value(OpBuilder &, Location, Value)> body) {
+  int64_t rank = input.getType().cast<RankedTensorType>().getRank();
+  SmallVector<AffineMap> indexingMaps(2, b.getMultiDimIdentityMap(rank));
+  SmallVector<utils::IteratorType> iteratorTypes(
+      rank, utils::IteratorType::parallel);
+  Value init = b.create<tensor::EmptyOp>(
+      loc, getAsOpFoldResult(getTensorSizes(b, loc, input)), elementType);
+  return b
+      .create<linalg::GenericOp>(
+          loc, init.getType(), input, init, indexingMaps, iteratorTypes,
+          [&](OpBuilder &b, Location loc, ValueRange args) {
+            b.create<linalg::YieldOp>(loc, body(b, loc, args[0]));
+          })
+      .getResult(0);
+}
+
+namespace {
+// Lowers `quantized::linear` to an int8 x int8 -> int32
+// `linalg.quantized_matmul`, followed by a single elementwise op that adds the
+// bias and requantizes to the output scale and zero point. The requantization
+// is done in f32 exactly like FBGEMM's, so results match PyTorch's. The
+// activation and the weight must be per-tensor quantized with parameters known
+// from their producers. Only per-tensor quantization is handled: the tree has
+// no per-channel quantized tensor op to read parameters from.
+class ConvertQuantizedLinearOp : public OpConversionPattern<QuantizedLinearOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+  LogicalResult
+  matchAndRewrite(QuantizedLinearOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op->getLoc();
+    auto params = op.getWPrepack().getDefiningOp<LinearParamsCreateOp>();
+    if (!params)
+      return rewriter.notifyMatchFailure(
+          op, "expected packed params from torch.linear_params.create");
+    if (!isConsumedBySupportedQuantizedOps(op.getResult()))
+      return rewriter.notifyMatchFailure(
+          op, "result is used by an op that does not read its quantization "
+              "parameters");
+
+    FailureOr<PerTensorQuantizedValue> input =
+        getPerTensorQuantizedValue(rewriter, loc, op.getX(), adaptor.getX());
+    if (failed(input))
+      return rewriter.notifyMatchFailure(
+          op, "expected an input with constant per-tensor quantization");
+    Value torchWeight = params.getWeight();
+    Type weightType = getTypeConverter()->convertType(torchWeight.getType());
+    Value builtinWeight =
+        weightType ? getTypeConverter()->materializeTargetConversion(
+                         rewriter, loc, weightType, torchWeight)
+                   : Value();
+    if (!builtinWeight)
+      return rewriter.notifyMatchFailure(op, "unsupported weight type");
+    FailureOr<PerTensorQuantizedValue> weight =
+        getPerTensorQuantizedValue(rewriter, loc, torchWeight, builtinWeight);
+    if (failed(weight))
+      return rewriter.notifyMatchFailure(
+          op, "expected a weight with constant per-tensor quantization");
+
+    double outputScale;
+    int64_t outputZeroPoint;
+    if (!matchPattern(op.getYScaleI(), m_TorchConstantFloat(&outputScale)) ||
+        !matchPattern(op.getYZeroPointI(),
+                      m_TorchConstantInt(&outputZeroPoint)))
+      return rewriter.notifyMatchFailure(
+          op, "only constant output scale and zero point are supported");
+
+    Type outputDtype = op.getType().cast<BaseTensorType>().getOptionalDtype();
+    if (!outputDtype || !outputDtype.isa<QInt8Type, QUInt8Type>())
+      return rewriter.notifyMatchFailure(op, "expected a quantized result");
+    bool isUnsignedOutput = outputDtype.isa<QUInt8Type>();
+
+    if (input->intRepr.getType().cast<RankedTensorType>().getRank() != 2 ||
+        weight->intRepr.getType().cast<RankedTensorType>().getRank() != 2)
+      return rewriter.notifyMatchFailure(
+          op, "only 2D input and weight are supported");
+
+    // The accumulator has scale `sx * sw`, so requantizing multiplies it by
+    // `sx * sw / sy`. Both are rounded to f32 the same way FBGEMM does.
+    float accScale =
+        static_cast<float>(input->scale) * static_cast<float>(weight->scale);
+    float multiplier = accScale / static_cast<float>(outputScale);
+    if (!(multiplier > 0.0f) || !std::isfinite(multiplier))
+      return rewriter.notifyMatchFailure(
+          op, "requantization multiplier is out of range");
+
+    // The packed weight is [N, K]; `linalg.quantized_matmul` wants [K, N].
+    Value lhs = input->intRepr;
+    Value rhs = torch_to_linalg::createTransposeLinalgGeneric(
+        rewriter, loc, weight->intRepr, {1, 0});
+    Type accType = rewriter.getI32Type();
+    Value lhsZeroPoint = rewriter.create<arith::ConstantOp>(
+        loc, rewriter.getI32IntegerAttr(input->zeroPoint));
+    Value rhsZeroPoint = rewriter.create<arith::ConstantOp>(
+        loc, rewriter.getI32IntegerAttr(weight->zeroPoint));
+    SmallVector<Value> resultSizes = {getDimOp(rewriter, loc, lhs, 0),
+                                      getDimOp(rewriter, loc, rhs, 1)};
+    Value accInit = createZeroInitTensor(rewriter, loc, resultSizes, accType);
+    Value acc = rewriter
+                    .create<linalg::QuantizedMatmulOp>(
+                        loc, accInit.getType(),
+                        ValueRange{lhs, rhs, lhsZeroPoint, rhsZeroPoint},
+                        accInit)
+                    .getResult(0);
+
+    // The float bias is divided once by the accumulator scale, which is the
+    // `bias / act_times_w_scale` term of FBGEMM's requantization.
+    Type f32 = rewriter.getF32Type();
+    Value bias;
+    if (params.getBias()) {
+      Value torchBias = params.getBias();
+      Type biasType = getTypeConverter()->convertType(torchBias.getType());
+      bias = biasType ? getTypeConverter()->materializeTargetConversion(
+                            rewriter, loc, biasType, torchBias)
+                      : Value();
+      if (!bias || !biasType.cast<RankedTensorType>()
+                        .getElementType()
+                        .isa<mlir::FloatType>())
+        return rewriter.notifyMatchFailure(op, "expected a float bias");
+      bias = createElementwiseMap(
+          rewriter, loc, bias, f32,
+          [&](OpBuilder &b, Location loc, Value value) -> Value {
+            value = convertScalarToDtype(b, loc, value, f32);
+            return b.create<arith::DivFOp>(
+                loc, value,
+                b.create<arith::ConstantOp>(loc, b.getF32FloatAttr(accScale)));
+          });
+    }
+
+    auto resultType = getTypeConverter()
+                          ->convertType(op.getType())
+                          .cast<RankedTensorType>();
+    Value resultInit = rewriter.create<tensor::EmptyOp>(
+        loc, getAsOpFoldResult(resultSizes), resultType.getElementType());
+    SmallVector<Value> inputs = {acc};
+    SmallVector<AffineMap> indexingMaps = {rewriter.getMultiDimIdentityMap(2)};
+    if (bias) {
+      inputs.push_back(bias);
+      indexingMaps.push_back(AffineMap::get(
+          /*dimCount=*/2, /*symbolCount=*/0, rewriter.getAffineDimExpr(1)));
+    }
+    indexingMaps.push_back(rewriter.getMultiDimIdentityMap(2));
+    SmallVector<utils::IteratorType> iteratorTypes(
+        2, utils::IteratorType::parallel);
+
+    // y = clamp(nearbyint((float(acc) + bias) * multiplier) + zy).
+    Value requantized =
+        rewriter
+            .create<linalg::GenericOp>(
+                loc, resultInit.getType(), inputs, resultInit, indexingMaps,
+                iteratorTypes,
+                [&](OpBuilder &b, Location loc, ValueRange args) {
+                  Value value = b.create<arith::SIToFPOp>(loc, f32, args[0]);
+                  if (bias)
+                    value = b.create<arith::AddFOp>(loc, value, args[1]);
+                  value = b.create<arith::MulFOp>(
+                      loc, value,
+                      b.create<arith::ConstantOp>(
+                          loc, b.getF32FloatAttr(multiplier)));
+                  value = createQuantizedValue(b, loc, value, outputZeroPoint,
+                                               isUnsignedOutput);
+                  b.create<linalg::YieldOp>(loc, value);
+                })
+            .getResult(0);
+
+    rewriter.replaceOpWithNewOp<tensor::CastOp>(op, resultType, requantized);
+    return success();
+  }
+};
+} // namespace
+
+namespace {
+// The builtin form of a per-tensor affine quantized tensor is its integer
+// representation. Its users read the scale and zero point from this op
+// directly, so it is only converted when all of them are able to.
+class ConvertPerTensorAffineCreateOp
+    : public OpConversionPattern<PerTensorAffineCreateOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+  LogicalResult
+  matchAndRewrite(PerTensorAffineCreateOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (!isConsumedBySupportedQuantizedOps(op.getResult()))
+      return rewriter.notifyMatchFailure(
+          op, "result is used by an op that does not read its quantization "
+              "parameters");
+    Type resultType = getTypeConverter()->convertType(op.getType());
+    if (!resultType)
+      return rewriter.notifyMatchFailure(op, "unsupported result type");
+    rewriter.replaceOpWithNewOp<tensor::CastOp>(op, resultType,
+                                                adaptor.getIntRepr());
+    return success();
+  }
+};
+} // namespace
+
+namespace {
+// Lowers `aten::quantize_per_tensor` with constant parameters to the integer
+// representation of its result.
+class ConvertAtenQuantizePerTensorOp
+    : public OpConversionPattern<AtenQuantizePerTensorOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+  LogicalResult
+  matchAndRewrite(AtenQuantizePerTensorOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (!isConsumedBySupportedQuantizedOps(op.getResult()))
+      return rewriter.notifyMatchFailure(
+          op, "result is used by an op that does not read its quantization "
+              "parameters");
+    double scale;
+    int64_t zeroPoint;
+    if (failed(getPerTensorQuantizationParams(op.getResult(), scale,
+                                              zeroPoint)))
+      return rewriter.notifyMatchFailure(
+          op, "only constant scale and zero point are supported");
+    Type dtype = op.getType().cast<BaseTensorType>().getOptionalDtype();
+    if (!dtype || !dtype.isa<QInt8Type, QUInt8Type>())
+      return rewriter.notifyMatchFailure(op, "expected a quantized result");
+    bool isUnsigned = dtype.isa<QUInt8Type>();
+
+    Value self = adaptor.getSelf();
+    auto selfType = self.getType().dyn_cast<RankedTensorType>();
+    if (!selfType || !selfType.getElementType().isa<mlir::FloatType>())
+      return rewriter.notifyMatchFailure(op, "expected a float input");
+    auto resultType = getTypeConverter()
+                          ->convertType(op.getType())
+                          .dyn_cast_or_null<RankedTensorType>();
+    if (!resultType)
+      return rewriter.notifyMatchFailure(op, "expected a ranked result");
+    Value quantized = createElementwiseMap(
+        rewriter, op.getLoc(), self, resultType.getElementType(),
+        [&](OpBuilder &b, Location loc, Value value) {
+          return createQuantize(b, loc, value, scale, zeroPoint, isUnsigned);
+        });
+    rewriter.replaceOpWithNewOp<tensor::CastOp>(op, resultType, quantized);
+    return success();
+  }
+};
+} // namespace
+
+namespace {
+// Lowers quint8 `aten::tanh` the way PyTorch's kernel computes it:
+// dequantize, f32 tanh, and quantize to the fixed output parameters.
+class ConvertQuantizedAtenTanhOp : public OpConversionPattern<AtenTanhOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+  LogicalResult
+  matchAndRewrite(AtenTanhOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (!hasQUInt8Dtype(op.getSelf()) || !hasQUInt8Dtype(op.getResult()))
+      return rewriter.notifyMatchFailure(op, "expected a quint8 tanh");
+    if (!isConsumedBySupportedQuantizedOps(op.getResult()))
+      return rewriter.notifyMatchFailure(
+          op, "result is used by an op that does not read its quantization "
+              "parameters");
+    double scale;
+    int64_t zeroPoint;
+    if (failed(getPerTensorQuantizationParams(op.getSelf(), scale, zeroPoint)))
+      return rewriter.notifyMatchFailure(
+          op, "expected an input with constant per-tensor quantization");
+
+    auto resultType = getTypeConverter()
+                          ->convertType(op.getType())
+                          .dyn_cast_or_null<RankedTensorType>();
+    if (!resultType)
+      return rewriter.notifyMatchFailure(op, "expected a ranked result");
+    Value result = createElementwiseMap(
+        rewriter, op.getLoc(), adaptor.getSelf(), resultType.getElementType(),
+        [&](OpBuilder &b, Location loc, Value value) {
+          value = createDequantize(b, loc, value, scale, zeroPoint,
+                                   /*isUnsigned=*/true, b.getF32Type());
+          value = b.create<math::TanhOp>(loc, value);
+          return createQuantize(b, loc, value, kQUInt8TanhScale,
+                                kQUInt8TanhZeroPoint, /*isUnsigned=*/true);
+        });
+    rewriter.replaceOpWithNewOp<tensor::CastOp>(op, resultType, result);
+    return success();
+  }
+};
+} // namespace
+
+namespace {
+// Packed params have no builtin form. `quantized::linear` reads the weight and
+// bias from this op directly, so it is erased once those are its only users,
+// however many layers share it.
+class ConvertLinearParamsCreateOp
+    : public OpConversionPattern<LinearParamsCreateOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+  LogicalResult
+  matchAndRewrite(LinearParamsCreateOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (!llvm::all_of(op->getUsers(), [](Operation *user) {
+          return isa<QuantizedLinearOp>(user);
+        }))
+      return rewriter.notifyMatchFailure(
+          op, "packed params are used by an op other than quantized::linear");
+    rewriter.eraseOp(op);
+    return success();
+  }
+};
+} // namespace
+
+namespace {
+// Lowers `aten::dequantize.self` of a per-tensor quantized tensor to
+// `(q - zero_point) * scale`.
+class ConvertAtenDequantizeSelfOp
+    : public OpConversionPattern<AtenDequantizeSelfOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+  LogicalResult
+  matchAndRewrite(AtenDequantizeSelfOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op->getLoc();
+    double scale;
+    int64_t zeroPoint;
+    if (failed(getPerTensorQuantizationParams(op.getSelf(), scale, zeroPoint)))
+      return rewriter.notifyMatchFailure(
+          op, "expected an input with constant per-tensor quantization");
+    Type dtype =
+        op.getSelf().getType().cast<BaseTensorType>().getOptionalDtype();
+    if (!dtype || !dtype.isa<QInt8Type, QUInt8Type>())
+      return rewriter.notifyMatchFailure(op, "expected a quantized input");
+    bool isUnsigned = dtype.isa<QUInt8Type>();
+
+    Value self = adaptor.getSelf();
+    auto resultType = getTypeConverter()
+                          ->convertType(op.getType())
+                          .dyn_cast_or_null<RankedTensorType>();
+    if (!resultType || !resultType.getElementType().isa<mlir::FloatType>())
+      return rewriter.notifyMatchFailure(op, "expected a float result");
+    Type elementType = resultType.getElementType();
+    Value dequantized = createElementwiseMap(
+        rewriter, loc, self, elementType,
+        [&](OpBuilder &b, Location loc, Value value) {
+          return createDequantize(b, loc, value, scale, zeroPoint, isUnsigned,
+                                  elementType);
+        });
+    rewriter.replaceOpWithNewOp<tensor::CastOp>(op, resultType, dequantized);
+    return success();
+  }
+};
+} // namespace
+
+void mlir::torch::torch_to_linalg::populateQuantizedPatternsAndLegality(
+    TypeConverter &typeConverter, RewritePatternSet &patterns,
+    ConversionTarget &target) {
+  MLIRContext *context = patterns.getContext();
+  target.addIllegalOp<QuantizedLinearOp>();
+  patterns.add<ConvertQuantizedLinearOp>(typeConverter, context);
+  target.addIllegalOp<PerTensorAffineCreateOp>();
+  patterns.add<ConvertPerTensorAffineCreateOp>(typeConverter, context);
+  target.addIllegalOp<LinearParamsCreateOp>();
+  patterns.add<ConvertLinearParamsCreateOp>(typeConverter, context);
+  target.addIllegalOp<AtenDequantizeSelfOp>();
+  patterns.add<ConvertAtenDequantizeSelfOp>(typeConverter, context);
+  target.addIllegalOp<AtenQuantizePerTensorOp>();
+  patterns.add<ConvertAtenQuantizePerTensorOp>(typeConverter, context);
+  // Float tanh is lowered by `ConvertElementwiseOp`, whose type converter
+  // rejects quantized tensors.
+  target.addIllegalOp<AtenTanhOp>();
+  patterns.add<ConvertQuantizedAtenTanhOp>(typeConverter, context);
+}
@@ -15,6 +15,7 @@
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/ControlFlow/IR/ControlFlowOps.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Math/IR/Math.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/IR/Matchers.h"
 #include "torch-mlir/Conversion/Utils/Utils.h"
@@ -23,6 +24,7 @@
 #include "torch-mlir/Dialect/Torch/Utils/TorchUpstream.h"
 #include "torch-mlir/Dialect/Torch/Utils/Utils.h"
 #include "torch-mlir/Dialect/TorchConversion/IR/TorchConversionOps.h"
+#include "llvm/Support/MathExtras.h"
 
 using namespace mlir;
 using namespace mlir::torch;
@@ -113,6 +115,73 @@ static Value randomUniformUInt(OpBuilder &b, Location loc, Value ctr,
   return bitwiseXOr(t, shiftRight32(add(mul(x, x), y)));
 }
 
+// Creates a `linalg.generic` producing `numResults` tensors of `sizes` from
+// `inputs`, whose payload also gets 64 random bits for each element. The bits
+// come from the counter-based generator keyed by the next global seed, with the
+// element's linear index as the counter. Since each element only depends on its
+// own index, the result does not change however the iteration space is split
+// across threads.
+static ValueRange createRandomLinalgGeneric(
+    OpBuilder &b, Location loc, ArrayRef<Value> sizes, Type elemTy,
+    unsigned numResults, ValueRange inputs,
+    ArrayRef<AffineMap> inputIndexingMaps,
+    function_ref<SmallVector<Value>(OpBuilder &, Location, Value, ValueRange)>
+        payload) {
+  Value key = b.create<TorchConversion::GetNextSeedOp>(loc);
+  int64_t resultRank = sizes.size();
+  SmallVector<AffineMap> indexingMaps(inputIndexingMaps);
+  indexingMaps.append(numResults, b.getMultiDimIdentityMap(resultRank));
+  SmallVector<utils::IteratorType> iteratorTypes(
+      resultRank, utils::IteratorType::parallel);
+  SmallVector<Value> sizesIntValues =
+      castIndexVectorToInt64Vector(b, loc, sizes);
+  SmallVector<Value> initTensors;
+  for (unsigned i = 0; i < numResults; i++) {
+    initTensors.push_back(
+        b.create<tensor::EmptyOp>(loc, getAsOpFoldResult(sizes), elemTy));
+  }
+  return b
+      .create<linalg::GenericOp>(
+          loc, ValueRange(initTensors).getTypes(), inputs,
+          /*outputs=*/initTensors, indexingMaps, iteratorTypes,
+          [&](OpBuilder &b, Location loc, ValueRange args) {
+            SmallVector<Value> indicesIntValues;
+            for (int i = 0; i < resultRank; i++) {
+              indicesIntValues.push_back(castIndexToInt64(
+                  b, loc, b.create<linalg::IndexOp>(loc, i)));
+            }
+            Value linearIndex =
+                toLinearIndex(b, loc, indicesIntValues, sizesIntValues);
+            Value randomBits = randomUniformUInt(b, loc, linearIndex, key);
+            b.create<linalg::YieldOp>(
+                loc, payload(b, loc, randomBits,
+                             args.drop_back(numResults)));
+          })
+      .getResults();
+}
+
+static Value createRandomLinalgGeneric(
+    OpBuilder &b, Location loc, ArrayRef<Value> sizes, Type elemTy,
+    ValueRange inputs, ArrayRef<AffineMap> inputIndexingMaps,
+    function_ref<Value(OpBuilder &, Location, Value, ValueRange)> payload) {
+  return createRandomLinalgGeneric(
+      b, loc, sizes, elemTy, /*numResults=*/1, inputs, inputIndexingMaps,
+      [&](OpBuilder &b, Location loc, Value randomBits, ValueRange args) {
+        return SmallVector<Value>{payload(b, loc, randomBits, args)};
+      })[0];
+}
+
+// Maps random bits to a float in [0, 1) by scaling with 1 / 2^N, where N is
+// the width of `bits`.
+static Value bitsToUnitFloat(OpBuilder &b, Location loc, Value bits,
+                             Type elemTy) {
+  unsigned width = bits.getType().getIntOrFloatBitWidth();
+  Value scale = b.create<arith::ConstantOp>(
+      loc, b.getFloatAttr(elemTy, std::ldexp(1.0, -width)));
+  Value bitsFloat = b.create<arith::UIToFPOp>(loc, elemTy, bits);
+  return b.create<arith::MulFOp>(loc, bitsFloat, scale);
+}
+
 namespace {
 class ConvertAtenUniformOp : public OpConversionPattern<AtenUniformOp> {
 public:
@@ -137,55 +206,27 @@ public:
       return rewriter.notifyMatchFailure(
           op, "The generator has to be None because only global default "
               "generator is supported");
-    // Get key, min and max used by `linalg.generic` compute payload.
-    Value key = rewriter.create<TorchConversion::GetNextSeedOp>(loc);
+    // Get min and max used by `linalg.generic` compute payload.
     Value min = convertScalarToDtype(rewriter, loc, from, elemTy);
     Value max = convertScalarToDtype(rewriter, loc, to, elemTy);
 
-    // Construct the `linalg.generic` op.
-    auto resultRank = resultType.getRank();
-    SmallVector<AffineMap, 1> indexingMaps(
-        1, rewriter.getMultiDimIdentityMap(resultRank));
-    SmallVector<utils::IteratorType> iteratorTypes(
-        resultRank, utils::IteratorType::parallel);
     SmallVector<Value> sizes = getTensorSizes(rewriter, loc, self);
-    SmallVector<Value> sizesIntValues =
-        castIndexVectorToInt64Vector(rewriter, loc, sizes);
-    Value initTensor =
-        rewriter.create<tensor::EmptyOp>(loc, getAsOpFoldResult(sizes), elemTy);
-    Value uniformRes =
-        rewriter
-            .create<linalg::GenericOp>(
-                loc, initTensor.getType(), /*inputs=*/ValueRange{},
-                /*outputs=*/initTensor, indexingMaps, iteratorTypes,
-                [&](OpBuilder &b, Location loc, ValueRange args) {
-                  SmallVector<Value> indicesIntValues;
-                  for (int i = 0; i < resultRank; i++) {
-                    indicesIntValues.push_back(castIndexToInt64(
-                        b, loc, b.create<linalg::IndexOp>(loc, i)));
-                  }
-
-                  Value linearIndex =
-                      toLinearIndex(b, loc, indicesIntValues, sizesIntValues);
-                  Value randomVal = randomUniformUInt(b, loc, linearIndex, key);
-
-                  // scale = (max - min) * const(F64,  5.4210108E-20)
-                  // which is derived from rand(min,max) =
-                  // rand()/(RAND_MAX/(max-min)) where RAND_MAX = 2^64 - 1
-                  Value epsilon = b.create<arith::ConstantOp>(
-                      loc, b.getFloatAttr(min.getType(), 5.4210108E-20));
-                  Value range = b.create<arith::SubFOp>(loc, max, min);
-                  Value scale = b.create<arith::MulFOp>(loc, range, epsilon);
-
-                  // res = cast(F64, tempN) * scale + min
-                  Value updateFloat =
-                      b.create<arith::UIToFPOp>(loc, elemTy, randomVal);
-                  Value updateScaled =
-                      b.create<arith::MulFOp>(loc, updateFloat, scale);
-                  Value res = b.create<arith::AddFOp>(loc, updateScaled, min);
-                  b.create<linalg::YieldOp>(loc, res);
-                })
-            .getResult(0);
+    Value uniformRes = createRandomLinalgGeneric(
+        rewriter, loc, sizes, elemTy, /*inputs=*/{}, /*inputIndexingMaps=*/{},
+        [&](OpBuilder &b, Location loc, Value randomVal, ValueRange) {
+          // scale = (max - min) * const(F64,  5.4210108E-20)
+          // which is derived from rand(min,max) =
+          // rand()/(RAND_MAX/(max-min)) where RAND_MAX = 2^64 - 1
+          Value epsilon = b.create<arith::ConstantOp>(
+              loc, b.getFloatAttr(min.getType(), 5.4210108E-20));
+          Value range = b.create<arith::SubFOp>(loc, max, min);
+          Value scale = b.create<arith::MulFOp>(loc, range, epsilon);
+
+          // res = cast(F64, tempN) * scale + min
+          Value updateFloat = b.create<arith::UIToFPOp>(loc, elemTy, randomVal);
+          Value updateScaled = b.create<arith::MulFOp>(loc, updateFloat, scale);
+          return b.create<arith::AddFOp>(loc, updateScaled, min);
+        });
 
     Type newResultType = getTypeConverter()->convertType(op.getType());
     rewriter.replaceOpWithNewOp<tensor::CastOp>(op, newResultType, uniformRes);
@@ -194,6 +235,190 @@ public:
 };
 } // namespace
 
+namespace {
+// Generates normally distributed values with the Box-Muller transform in the
+// same `linalg.generic` as the random bits. The two uniform samples the
+// transform needs are the high and low halves of a single 64-bit draw:
+//   u1 = (hi + 1) / 2^32, u2 = lo / 2^32
+//   r = sqrt(-2 * log(u1)), theta = 2 * pi * u2
+// where u1 is in (0, 1] so that its log is finite. Both samples of the
+// transform, r * cos(theta) and r * sin(theta), are used: the generic iterates
+// over half of the innermost dimension and its two results are interleaved
+// into the even and odd elements.
+class ConvertAtenRandnGeneratorOp
+    : public OpConversionPattern<AtenRandnGeneratorOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+  LogicalResult
+  matchAndRewrite(AtenRandnGeneratorOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (failed(verifyLinalgCompatibleTypes(op, rewriter)))
+      return failure();
+    Location loc = op.getLoc();
+    if (!op.getGenerator().getType().isa<Torch::NoneType>())
+      return rewriter.notifyMatchFailure(
+          op, "The generator has to be None because only global default "
+              "generator is supported");
+    auto resultType = getTypeConverter()
+                          ->convertType(op.getType())
+                          .cast<RankedTensorType>();
+    Type elemTy = resultType.getElementType();
+    if (!elemTy.isa<mlir::FloatType>())
+      return rewriter.notifyMatchFailure(op, "This op only support float type");
+
+    SmallVector<Value> sizeTorchInt;
+    if (!getListConstructElements(op.getSize(), sizeTorchInt))
+      return rewriter.notifyMatchFailure(
+          op, "unimplemented: size must be constructed using ListConstruct");
+    SmallVector<Value> sizes = castIntVectorToIndexVector(
+        rewriter, loc,
+        getTypeConvertedValues(rewriter, loc, getTypeConverter(),
+                               sizeTorchInt));
+
+    // f16 and bf16 would round `u1` close to 1 to 1 and close to 0 to 0, for
+    // which `log` yields 0 or -inf, so the transform is computed in f64 for
+    // them and only the samples are rounded to the result dtype.
+    Type computeTy = elemTy;
+    if (elemTy.getIntOrFloatBitWidth() < 32)
+      computeTy = rewriter.getF64Type();
+
+    SmallVector<Value> pairSizes(sizes);
+    if (!sizes.empty()) {
+      Value two = rewriter.create<arith::ConstantIndexOp>(loc, 2);
+      pairSizes.back() =
+          rewriter.create<arith::CeilDivUIOp>(loc, sizes.back(), two);
+    }
+    ValueRange samples = createRandomLinalgGeneric(
+        rewriter, loc, pairSizes, elemTy, /*numResults=*/2, /*inputs=*/{},
+        /*inputIndexingMaps=*/{},
+        [&](OpBuilder &b, Location loc, Value randomBits, ValueRange) {
+          Type i32 = b.getI32Type();
+          Value cst32 =
+              b.create<arith::ConstantOp>(loc, b.getI64IntegerAttr(32));
+          Value hi = b.create<arith::TruncIOp>(
+              loc, i32, b.create<arith::ShRUIOp>(loc, randomBits, cst32));
+          Value lo = b.create<arith::TruncIOp>(loc, i32, randomBits);
+          Value one =
+              b.create<arith::ConstantOp>(loc, b.getFloatAttr(computeTy, 1.0));
+          Value twoToMinus32 = b.create<arith::ConstantOp>(
+              loc, b.getFloatAttr(computeTy, std::ldexp(1.0, -32)));
+          Value u1 = b.create<arith::MulFOp>(
+              loc,
+              b.create<arith::AddFOp>(
+                  loc, b.create<arith::UIToFPOp>(loc, computeTy, hi), one),
+              twoToMinus32);
+          Value u2 = bitsToUnitFloat(b, loc, lo, computeTy);
+
+          Value minusTwo = b.create<arith::ConstantOp>(
+              loc, b.getFloatAttr(computeTy, -2.0));
+          Value twoPi = b.create<arith::ConstantOp>(
+              loc, b.getFloatAttr(computeTy, 2.0 * llvm::numbers::pi));
+          Value r = b.create<math::SqrtOp>(
+              loc, b.create<arith::MulFOp>(
+                       loc, minusTwo, b.create<math::LogOp>(loc, u1)));
+          Value theta = b.create<arith::MulFOp>(loc, twoPi, u2);
+          Value cosSample = b.create<arith::MulFOp>(
+              loc, r, b.create<math::CosOp>(loc, theta));
+          Value sinSample = b.create<arith::MulFOp>(
+              loc, r, b.create<math::SinOp>(loc, theta));
+          return SmallVector<Value>{
+              convertScalarToDtype(b, loc, cosSample, elemTy),
+              convertScalarToDtype(b, loc, sinSample, elemTy)};
+        });
+
+    // A 0-d result only needs one sample.
+    Value randn = samples[0];
+    if (!sizes.empty()) {
+      int64_t rank = sizes.size();
+      SmallVector<OpFoldResult> paddedSizes = getAsOpFoldResult(pairSizes);
+      paddedSizes.back() = getAsOpFoldResult(rewriter.create<arith::MulIOp>(
+          loc, pairSizes.back(),
+          rewriter.create<arith::ConstantIndexOp>(loc, 2)));
+      Value padded =
+          rewriter.create<tensor::EmptyOp>(loc, paddedSizes, elemTy);
+      SmallVector<OpFoldResult> offsets(rank, rewriter.getIndexAttr(0));
+      SmallVector<OpFoldResult> strides(rank, rewriter.getIndexAttr(1));
+      SmallVector<OpFoldResult> interleavedStrides(strides);
+      interleavedStrides.back() = rewriter.getIndexAttr(2);
+      padded = rewriter.create<tensor::InsertSliceOp>(
+          loc, samples[0], padded, offsets, getAsOpFoldResult(pairSizes),
+          interleavedStrides);
+      SmallVector<OpFoldResult> oddOffsets(offsets);
+      oddOffsets.back() = rewriter.getIndexAttr(1);
+      padded = rewriter.create<tensor::InsertSliceOp>(
+          loc, samples[1], padded, oddOffsets, getAsOpFoldResult(pairSizes),
+          interleavedStrides);
+      // Drop the last sine sample when the innermost dimension is odd.
+      randn = rewriter.create<tensor::ExtractSliceOp>(
+          loc, padded, offsets, getAsOpFoldResult(sizes), strides);
+    }
+
+    rewriter.replaceOpWithNewOp<tensor::CastOp>(op, resultType, randn);
+    return success();
+  }
+};
+} // namespace
+
+namespace {
+// Draws each element as `uniform < p` in the same `linalg.generic` as the
+// random bits, and casts the result to the dtype of `self`. The uniform sample
+// is compared in f64 so that probabilities are not rounded to the input dtype.
+template <typename OpTy>
+class ConvertAtenBernoulliLikeOp : public OpConversionPattern<OpTy> {
+public:
+  using OpConversionPattern<OpTy>::OpConversionPattern;
+  using OpAdaptor = typename OpTy::Adaptor;
+  LogicalResult
+  matchAndRewrite(OpTy op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (failed(verifyLinalgCompatibleTypes(op, rewriter)))
+      return failure();
+    Location loc = op.getLoc();
+    if (!op.getGenerator().getType().template isa<Torch::NoneType>())
+      return rewriter.notifyMatchFailure(
+          op, "The generator has to be None because only global default "
+              "generator is supported");
+    Value self = adaptor.getSelf();
+    auto resultType = this->getTypeConverter()
+                          ->convertType(op.getType())
+                          .template cast<RankedTensorType>();
+    Type elemTy = resultType.getElementType();
+
+    // `aten.bernoulli` takes the probabilities from `self`, while
+    // `valsem.aten.bernoulli.float` takes a single float probability.
+    constexpr bool probIsSelf = std::is_same<OpTy, AtenBernoulliOp>();
+    SmallVector<Value> inputs;
+    SmallVector<AffineMap> inputIndexingMaps;
+    if (probIsSelf) {
+      if (!elemTy.isa<mlir::FloatType>())
+        return rewriter.notifyMatchFailure(
+            op, "probabilities must be a float type tensor");
+      inputs.push_back(self);
+      inputIndexingMaps.push_back(rewriter.getMultiDimIdentityMap(
+          self.getType().template cast<RankedTensorType>().getRank()));
+    }
+
+    SmallVector<Value> sizes = getTensorSizes(rewriter, loc, self);
+    Value bernoulli = createRandomLinalgGeneric(
+        rewriter, loc, sizes, elemTy, inputs, inputIndexingMaps,
+        [&](OpBuilder &b, Location loc, Value randomBits, ValueRange args) {
+          Type f64 = b.getF64Type();
+          Value prob;
+          if constexpr (probIsSelf)
+            prob = convertScalarToDtype(b, loc, args[0], f64);
+          else
+            prob = adaptor.getP();
+          Value uniform = bitsToUnitFloat(b, loc, randomBits, f64);
+          Value lessThanP = b.create<arith::CmpFOp>(
+              loc, arith::CmpFPredicate::OLT, uniform, prob);
+          return convertScalarToDtype(b, loc, lessThanP, elemTy);
+        });
+
+    rewriter.replaceOpWithNewOp<tensor::CastOp>(op, resultType, bernoulli);
+    return success();
+  }
+};
+} // namespace
 
 void mlir::torch::torch_to_linalg::populateRandomPatternsAndLegality(
     TypeConverter &typeConverter, RewritePatternSet &patterns,
@@ -203,4 +428,10 @@ void mlir::torch::torch_to_linalg::populateRandomPatternsAndLegality(
   patterns.add<ConvertAtenDropoutOp>(typeConverter, context);
   target.addIllegalOp<AtenUniformOp>();
   patterns.add<ConvertAtenUniformOp>(typeConverter, context);
+  target.addIllegalOp<AtenRandnGeneratorOp>();
+  patterns.add<ConvertAtenRandnGeneratorOp>(typeConverter, context);
+  target.addIllegalOp<AtenBernoulliOp, ValsemVariantAtenBernoulliFloatOp>();
+  patterns.add<ConvertAtenBernoulliLikeOp<AtenBernoulliOp>,
+               ConvertAtenBernoulliLikeOp<ValsemVariantAtenBernoulliFloatOp>>(
+      typeConverter, context);
 }
@@ -29,18 +29,110 @@ using namespace mlir;
 using namespace mlir::torch;
 using namespace mlir::torch::Torch;
 
+// Reductions along a statically sized dim of at least this many elements are
+// split into tiles of `kMaxWithIndexTileSize` elements, which are reduced
+// independently before their partial results are combined.
+static constexpr int64_t kMaxWithIndexTreeThreshold = 1024;
+static constexpr int64_t kMaxWithIndexTileSize = 256;
+
+// Creates a `linalg.generic` reducing `inputs[0]` along `dim` to its maximum
+// value and the index of that value. `getIndex` computes the index of the
+// current element, as `idxElementType`, from the block arguments of the
+// inputs. NaN compares greater than any other value, so it propagates to the
+// result, and ties are broken in favour of the first element visited, which
+// gives the first index as long as the elements are visited in order.
+static std::pair<Value, Value> createMaxWithIndexReduction(
+    OpBuilder &b, Location loc, ValueRange inputs, int64_t dim, bool keepDim,
+    Type idxElementType,
+    function_ref<Value(OpBuilder &, Location, ValueRange)> getIndex) {
+  Value values = inputs[0];
+  auto valuesType = values.getType().cast<RankedTensorType>();
+  auto elementType = valuesType.getElementType().cast<mlir::FloatType>();
+  int64_t rank = valuesType.getRank();
+
+  Value c1 = b.create<arith::ConstantIndexOp>(loc, /*value=*/1);
+  SmallVector<Value> resultShape;
+  for (int64_t i = 0; i < rank; i++) {
+    if (dim != i)
+      resultShape.push_back(getDimOp(b, loc, values, i));
+    else if (keepDim)
+      resultShape.push_back(c1);
+  }
+  Value filledTensorIdx =
+      createZeroInitTensor(b, loc, resultShape, idxElementType);
+  Value initTensorMax = b.create<tensor::EmptyOp>(
+      loc, getAsOpFoldResult(resultShape), elementType);
+  // Start from -inf rather than the lowest finite value so that a slice of
+  // -inf values reduces to -inf.
+  Value fillValueMax = b.create<arith::ConstantOp>(
+      loc, b.getFloatAttr(elementType,
+                          APFloat::getInf(elementType.getFloatSemantics(),
+                                          /*Negative=*/true)));
+  Value filledTensorMax =
+      b.create<linalg::FillOp>(loc, fillValueMax, initTensorMax).result();
+
+  SmallVector<AffineExpr> exprs;
+  SmallVector<utils::IteratorType> iteratorTypes;
+  SmallVector<AffineExpr> resultExprs;
+  for (int64_t i = 0; i < rank; i++) {
+    exprs.push_back(b.getAffineDimExpr(i));
+    if (dim == i) {
+      iteratorTypes.push_back(utils::IteratorType::reduction);
+      // If `keepDim`, map the reduced dim to its only element.
+      if (keepDim)
+        resultExprs.push_back(b.getAffineConstantExpr(0));
+    } else {
+      iteratorTypes.push_back(utils::IteratorType::parallel);
+      resultExprs.push_back(b.getAffineDimExpr(i));
+    }
+  }
+  SmallVector<AffineMap> maps(
+      inputs.size(), AffineMap::get(rank, 0, exprs, b.getContext()));
+  maps.append(2, AffineMap::get(rank, 0, resultExprs, b.getContext()));
+
+  auto linalgOp = b.create<linalg::GenericOp>(
+      loc, TypeRange{filledTensorMax.getType(), filledTensorIdx.getType()},
+      inputs, ValueRange{filledTensorMax, filledTensorIdx}, maps,
+      iteratorTypes,
+      [&](OpBuilder &nestedBuilder, Location nestedLoc, ValueRange blockArgs) {
+        Value newValue = blockArgs[0];
+        Value oldValue = blockArgs[inputs.size()];
+        Value oldIndex = blockArgs[inputs.size() + 1];
+        Value newIndex = getIndex(nestedBuilder, nestedLoc,
+                                  blockArgs.take_front(inputs.size()));
+
+        // Take the new element if it is greater than the running max, or if
+        // it is the first NaN.
+        Value isGreater = nestedBuilder.create<arith::CmpFOp>(
+            nestedLoc, arith::CmpFPredicate::OGT, newValue, oldValue);
+        Value newIsNaN = nestedBuilder.create<arith::CmpFOp>(
+            nestedLoc, arith::CmpFPredicate::UNO, newValue, newValue);
+        Value oldIsNotNaN = nestedBuilder.create<arith::CmpFOp>(
+            nestedLoc, arith::CmpFPredicate::ORD, oldValue, oldValue);
+        Value isFirstNaN = nestedBuilder.create<arith::AndIOp>(
+            nestedLoc, newIsNaN, oldIsNotNaN);
+        Value takeNew = nestedBuilder.create<arith::OrIOp>(
+            nestedLoc, isGreater, isFirstNaN);
+        Value resultMax = nestedBuilder.create<arith::SelectOp>(
+            nestedLoc, takeNew, newValue, oldValue);
+        Value resultIndex = nestedBuilder.create<arith::SelectOp>(
+            nestedLoc, takeNew, newIndex, oldIndex);
+        nestedBuilder.create<linalg::YieldOp>(
+            nestedLoc, ValueRange({resultMax, resultIndex}));
+      });
+  return {linalgOp.getResult(0), linalgOp.getResult(1)};
+}
+
 namespace {
-// Aten maxdim lowering represents the MaxDim op as an linalg.indexed_generic
-// op, producing two output buffers.
+// Aten maxdim lowering represents the MaxDim op as a `linalg.generic` op
+// producing two results: the maximum value found and its index.
 //
-// The first output buffer contains the maximum value found. It is initialized
-// to the minimum representable value of the input element type.
-//
-// The second output buffer contains the index of the found maximum value. It is
-// initialized to 0 and is resulting integer type.
-//
-// The indexed_generic op updates both the maximum value and index if the
-// current value exceeds the running max.
+// Long reductions are lowered as a two-level tree instead, so that the
+// reduction is not a single serial loop: the reduced dim is padded with -inf
+// to a multiple of the tile size and split into tiles, each tile is reduced
+// independently (a parallel loop over the tiles), and a second reduction
+// combines the partial maxima and their indices. Combining the tiles in order
+// with the same strict comparison preserves the first-index tie-break.
 class ConvertAtenMaxDimOp : public OpConversionPattern<AtenMaxDimOp> {
 public:
   using OpConversionPattern<AtenMaxDimOp>::OpConversionPattern;
@@ -86,87 +178,84 @@ public:
           "aten.max_dim to linalg.* requires Float input element type");
     }
 
-    // Constant op to account for the reduction along dim.
-    auto c1 = rewriter.create<arith::ConstantIndexOp>(loc, /*value=*/1);
-    SmallVector<Value> resultShape;
-    for (int64_t i = 0; i < inputType.getRank(); i++) {
-      if (dim != i) {
-        auto currentDimSize = rewriter.create<tensor::DimOp>(loc, input, i);
-        resultShape.push_back(currentDimSize);
-      } else if (keepDim)
-        resultShape.push_back(c1);
-    }
-    // First fill the output buffer for the index.
-    Value filledTensorIdx =
-        createZeroInitTensor(rewriter, loc, resultShape, idxElementType);
-
-    // Second fill the output buffer for the running max.
-    Value initTensorMax = rewriter.create<tensor::EmptyOp>(
-        loc, getAsOpFoldResult(resultShape), inElementType);
-
-    FloatAttr fillValueMaxAttr = rewriter.getFloatAttr(
-        inElementType,
-        APFloat::getLargest(
-            inElementType.cast<mlir::FloatType>().getFloatSemantics(), true));
-
-    Value fillValueMax =
-        rewriter.create<arith::ConstantOp>(loc, fillValueMaxAttr);
-    Value filledTensorMax =
-        rewriter.create<linalg::FillOp>(loc, fillValueMax, initTensorMax)
-            .result();
-
-    // Create the affine expressions that will be used to
-    // iterate over the input and output tensors.
-    // Here we also set the type of iterator: parallel or reduction.
-    SmallVector<AffineExpr> exprs;
-    SmallVector<utils::IteratorType> iteratorTypes;
-    SmallVector<AffineExpr> resultExprs;
-    for (auto size :
-         llvm::enumerate(makeShapeTorchCompatible(inputType.getShape()))) {
-      exprs.push_back(rewriter.getAffineDimExpr(size.index()));
-
-      if (unsigned(dim) == size.index()) {
-        iteratorTypes.push_back(utils::IteratorType::reduction);
-        // If `keepDim`, create affine map to the first element
-        // in the current dimension.
-        if (keepDim)
-          resultExprs.push_back(rewriter.getAffineConstantExpr(0));
-      } else {
-        iteratorTypes.push_back(utils::IteratorType::parallel);
-        resultExprs.push_back(rewriter.getAffineDimExpr(size.index()));
+    int64_t dimSize = inputType.getDimSize(dim);
+    std::pair<Value, Value> maxAndIndex;
+    if (ShapedType::isDynamic(dimSize) ||
+        dimSize < kMaxWithIndexTreeThreshold) {
+      maxAndIndex = createMaxWithIndexReduction(
+          rewriter, loc, input, dim, keepDim, idxElementType,
+          [&](OpBuilder &b, Location loc, ValueRange) -> Value {
+            return b.create<arith::IndexCastOp>(
+                loc, idxElementType, b.create<linalg::IndexOp>(loc, dim));
+          });
+    } else {
+      int64_t tileSize = kMaxWithIndexTileSize;
+      int64_t numTiles = llvm::divideCeil(dimSize, tileSize);
+      int64_t rank = inputType.getRank();
+
+      // Pad the reduced dim to a multiple of the tile size with -inf, which
+      // never replaces an earlier element.
+      SmallVector<int64_t> lowPadding(rank, 0);
+      SmallVector<int64_t> highPadding(rank, 0);
+      highPadding[dim] = numTiles * tileSize - dimSize;
+      Value paddedInput = input;
+      if (highPadding[dim] != 0) {
+        Value negInf = rewriter.create<arith::ConstantOp>(
+            loc, rewriter.getFloatAttr(
+                     inElementType,
+                     APFloat::getInf(
+                         inElementType.cast<mlir::FloatType>()
+                             .getFloatSemantics(),
+                         /*Negative=*/true)));
+        paddedInput = torch_to_linalg::getPaddedTensor(
+            maxDimOp, rewriter, input, lowPadding, highPadding, negInf);
+      }
+
+      // Split the reduced dim into (numTiles, tileSize).
+      SmallVector<ReassociationIndices> reassociation;
+      SmallVector<int64_t> tiledShape;
+      for (int64_t i = 0; i < rank; i++) {
+        if (i == dim) {
+          reassociation.push_back({i, i + 1});
+          tiledShape.push_back(numTiles);
+          tiledShape.push_back(tileSize);
+          continue;
+        }
+        reassociation.push_back({i < dim ? i : i + 1});
+        tiledShape.push_back(inputType.getDimSize(i));
       }
+      Value tiledInput = rewriter.create<tensor::ExpandShapeOp>(
+          loc, RankedTensorType::get(tiledShape, inElementType), paddedInput,
+          reassociation);
+
+      // Reduce each tile, recording indices into the untiled dim.
+      Value tileSizeValue =
+          rewriter.create<arith::ConstantIndexOp>(loc, tileSize);
+      std::pair<Value, Value> partial = createMaxWithIndexReduction(
+          rewriter, loc, tiledInput, dim + 1, /*keepDim=*/false,
+          idxElementType,
+          [&](OpBuilder &b, Location loc, ValueRange) -> Value {
+            Value tileOffset = b.create<arith::MulIOp>(
+                loc, b.create<linalg::IndexOp>(loc, dim), tileSizeValue);
+            Value index = b.create<arith::AddIOp>(
+                loc, tileOffset, b.create<linalg::IndexOp>(loc, dim + 1));
+            return b.create<arith::IndexCastOp>(loc, idxElementType, index);
+          });
+
+      // Combine the partial results of the tiles.
+      maxAndIndex = createMaxWithIndexReduction(
+          rewriter, loc, ValueRange{partial.first, partial.second}, dim,
+          keepDim, idxElementType,
+          [](OpBuilder &b, Location loc, ValueRange args) -> Value {
+            return args[1];
+          });
     }
-    auto maps = AffineMap::inferFromExprList({exprs, resultExprs, resultExprs});
-    auto linalgOp = rewriter.create<linalg::GenericOp>(
-        loc,
-        ArrayRef<Type>({filledTensorMax.getType(), filledTensorIdx.getType()}),
-        input, ValueRange({filledTensorMax, filledTensorIdx}), maps,
-        iteratorTypes,
-        [&](OpBuilder &nestedBuilder, Location nestedLoc,
-            ValueRange blockArgs) {
-          Value newValue = blockArgs[0];
-          Value oldValue = blockArgs[1];
-          Value oldIndex = blockArgs[2];
-
-          Value newIndex = rewriter.create<arith::IndexCastOp>(
-              nestedLoc, oldIndex.getType(),
-              rewriter.create<linalg::IndexOp>(loc, dim));
-
-          auto resultMax = rewriter.create<arith::MaxFOp>(
-              nestedLoc, newValue, oldValue);
-          Value predicate = rewriter.create<arith::CmpFOp>(
-              nestedLoc, arith::CmpFPredicate::OGT, newValue, oldValue);
-          auto resultIndex = rewriter.create<arith::SelectOp>(
-              nestedLoc, predicate, newIndex, oldIndex);
-          nestedBuilder.create<linalg::YieldOp>(
-              nestedLoc, ValueRange({resultMax, resultIndex}));
-        });
 
     // This cast is required to fix the shape in the case of keepDim=True
-    Value maxValuesCast = rewriter.create<tensor::CastOp>(
-        loc, valResultType, linalgOp.getResult(0));
-    Value maxIdxCast = rewriter.create<tensor::CastOp>(loc, idxResultType,
-                                                       linalgOp.getResult(1));
+    Value maxValuesCast =
+        rewriter.create<tensor::CastOp>(loc, valResultType, maxAndIndex.first);
+    Value maxIdxCast =
+        rewriter.create<tensor::CastOp>(loc, idxResultType, maxAndIndex.second);
     rewriter.replaceOp(maxDimOp, {maxValuesCast, maxIdxCast});
     return success();
   }
@@ -16,6 +16,7 @@
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Math/IR/Math.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "torch-mlir/Dialect/Torch/IR/TorchDialect.h"
 #include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
@@ -38,6 +39,11 @@ namespace {
 class ConvertTorchToLinalg
     : public ConvertTorchToLinalgBase<ConvertTorchToLinalg> {
 public:
+  ConvertTorchToLinalg() = default;
+  ConvertTorchToLinalg(bool useNhwcLayout) {
+    this->useNhwcLayout = useNhwcLayout;
+  }
+
   void getDependentDialects(DialectRegistry &registry) const override {
     registry.insert<linalg::LinalgDialect>();
     registry.insert<math::MathDialect>();
@@ -45,6 +51,7 @@ public:
     registry.insert<tensor::TensorDialect>();
     registry.insert<arith::ArithDialect>();
     registry.insert<cf::ControlFlowDialect>();
+    registry.insert<scf::SCFDialect>();
     TorchConversion::getBackendTypeConversionDependentDialects(registry);
   }
 
@@ -53,21 +60,35 @@ public:
     ConversionTarget target(*context);
     target.addLegalDialect<linalg::LinalgDialect, func::FuncDialect,
                            cf::ControlFlowDialect, math::MathDialect,
-                           tensor::TensorDialect, arith::ArithDialect>();
+                           scf::SCFDialect, tensor::TensorDialect,
+                           arith::ArithDialect>();
     target.addLegalOp<TorchConversion::GetNextSeedOp>();
 
     TypeConverter typeConverter;
     typeConverter.addConversion([](Type type) { return type; });
     TorchConversion::setupBackendTypeConversion(target, typeConverter);
 
+    // Only the quantized patterns see quantized tensors as their integer
+    // representation, since they read the scale and zero point from the
+    // producing op. Every other pattern fails to convert them.
+    TypeConverter quantizedTypeConverter;
+    quantizedTypeConverter.addConversion([](Type type) { return type; });
+    TorchConversion::setupBackendTypeConversion(target,
+                                                quantizedTypeConverter);
+    TorchConversion::setupQuantizedTensorToBuiltinTensorConversion(
+        quantizedTypeConverter);
+
     RewritePatternSet patterns(context);
 
+    torch_to_linalg::TorchToLinalgOptions options{useNhwcLayout};
     torch_to_linalg::populateTensorScalarInteropPatternsAndLegality(
         typeConverter, patterns, target);
     torch_to_linalg::populateLinearPatternsAndLegality(typeConverter, patterns,
-                                                       target);
+                                                       target, options);
     torch_to_linalg::populatePoolingPatternsAndLegality(typeConverter, patterns,
-                                                        target);
+                                                        target, options);
+    torch_to_linalg::populateQuantizedPatternsAndLegality(
+        quantizedTypeConverter, patterns, target);
     torch_to_linalg::populateRandomPatternsAndLegality(typeConverter, patterns,
                                                        target);
     torch_to_linalg::populateUncategorizedPatternsAndLegality(typeConverter,
@@ -92,3 +113,8 @@ std::unique_ptr<OperationPass<func::FuncOp>>
 mlir::torch::createConvertTorchToLinalgPass() {
   return std::make_unique<ConvertTorchToLinalg>();
 }
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::torch::createConvertTorchToLinalgPass(bool useNhwcLayout) {
+  return std::make_unique<ConvertTorchToLinalg>(useNhwcLayout);
+}
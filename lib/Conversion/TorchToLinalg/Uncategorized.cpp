@@ -1231,8 +1231,8 @@ public:
 static Value calculateRSTD(OpBuilder &b, Location loc, Type elemTy, Value eps,
                            Value var) {
   // The eps is always f64.
-  Value truncatedEps = b.create<arith::TruncFOp>(loc, elemTy, eps);
-  Value varPlusEps = b.create<arith::AddFOp>(loc, var, truncatedEps);
+  Value castedEps = convertScalarToDtype(b, loc, eps, elemTy);
+  Value varPlusEps = b.create<arith::AddFOp>(loc, var, castedEps);
   Value rSTD = b.create<math::RsqrtOp>(loc, varPlusEps);
   return rSTD;
 }
@@ -1365,6 +1365,188 @@ public:
 };
 } // namespace
 
+namespace {
+// Lowers `aten.native_layer_norm` to two passes over the input instead of the
+// mean/sub/mul/mean/rsqrt chain produced by its decomposition:
+//   1. a single Welford pass per row computing the mean and the sum of
+//      squared deviations (M2),
+//   2. a fully parallel pass computing (x - mean) * rSTD * weight + bias.
+// The rows are the leading dimensions that are not normalized, and are
+// parallel in both passes.
+class ConvertAtenNativeLayerNormOp
+    : public OpConversionPattern<AtenNativeLayerNormOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+  LogicalResult
+  matchAndRewrite(AtenNativeLayerNormOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (failed(verifyLinalgCompatibleTypes(op, rewriter)))
+      return failure();
+
+    MLIRContext *context = op->getContext();
+    Location loc = op->getLoc();
+    Value input = adaptor.getInput();
+    Value weight = adaptor.getWeight();
+    Value bias = adaptor.getBias();
+    Value eps = adaptor.getEps();
+    bool hasWeight = !op.getWeight().getType().isa<Torch::NoneType>();
+    bool hasBias = !op.getBias().getType().isa<Torch::NoneType>();
+
+    auto inputType = input.getType().cast<RankedTensorType>();
+    Type elemTy = inputType.getElementType();
+    if (!elemTy.isa<mlir::FloatType>())
+      return rewriter.notifyMatchFailure(op, "input must be a float tensor");
+
+    SmallVector<Value> normalizedShape;
+    if (!getListConstructElements(op.getNormalizedShape(), normalizedShape))
+      return rewriter.notifyMatchFailure(
+          op, "unimplemented: normalized_shape must be a list construct");
+    int64_t inputRank = inputType.getRank();
+    int64_t meanAndVarShapeRank = normalizedShape.size();
+    if (meanAndVarShapeRank > inputRank)
+      return rewriter.notifyMatchFailure(
+          op, "normalized_shape has more dimensions than the input");
+    int64_t axis = inputRank - meanAndVarShapeRank;
+
+    SmallVector<Value> inputSizes = getTensorSizes(rewriter, loc, input);
+    SmallVector<Value> rowSizes(inputSizes.begin(), inputSizes.begin() + axis);
+    Value elemCount = rewriter.create<arith::ConstantIndexOp>(loc, 1);
+    for (Value size : ArrayRef<Value>(inputSizes).drop_front(axis))
+      elemCount = rewriter.create<arith::MulIOp>(loc, elemCount, size);
+    elemCount = convertScalarToDtype(
+        rewriter, loc, castIndexToInt64(rewriter, loc, elemCount), elemTy);
+
+    SmallVector<AffineExpr> rowExprs, normalizedExprs;
+    for (int64_t i = 0; i < inputRank; i++) {
+      if (i < axis)
+        rowExprs.push_back(rewriter.getAffineDimExpr(i));
+      else
+        normalizedExprs.push_back(rewriter.getAffineDimExpr(i));
+    }
+    AffineMap identityMap = rewriter.getMultiDimIdentityMap(inputRank);
+    AffineMap rowMap = AffineMap::get(inputRank, /*symbolCount=*/0, rowExprs,
+                                      context);
+    AffineMap normalizedMap = AffineMap::get(
+        inputRank, /*symbolCount=*/0, normalizedExprs, context);
+
+    // Welford pass. The running count is carried as a third reduction output
+    // rather than derived from the iteration position, so the update does
+    // not depend on the order in which the reduction visits the elements.
+    SmallVector<utils::IteratorType> welfordIteratorTypes(
+        axis, utils::IteratorType::parallel);
+    welfordIteratorTypes.append(meanAndVarShapeRank,
+                                utils::IteratorType::reduction);
+    Value meanInit = createZeroInitTensor(rewriter, loc, rowSizes, elemTy);
+    Value countInit =
+        createZeroInitTensor(rewriter, loc, rowSizes, rewriter.getI64Type());
+    SmallVector<AffineMap> welfordIndexingMaps = {identityMap, rowMap, rowMap,
+                                                  rowMap};
+    auto welford = rewriter.create<linalg::GenericOp>(
+        loc,
+        TypeRange{meanInit.getType(), meanInit.getType(),
+                  countInit.getType()},
+        input, ValueRange{meanInit, meanInit, countInit}, welfordIndexingMaps,
+        welfordIteratorTypes,
+        [&](OpBuilder &b, Location loc, ValueRange args) {
+          Value x = args[0], mean = args[1], m2 = args[2], count = args[3];
+          Value one = b.create<arith::ConstantOp>(
+              loc, b.getIntegerAttr(count.getType(), 1));
+          Value newCount = b.create<arith::AddIOp>(loc, count, one);
+          Value newCountFloat = convertScalarToDtype(b, loc, newCount, elemTy);
+          Value delta = b.create<arith::SubFOp>(loc, x, mean);
+          Value newMean = b.create<arith::AddFOp>(
+              loc, mean, b.create<arith::DivFOp>(loc, delta, newCountFloat));
+          Value newDelta = b.create<arith::SubFOp>(loc, x, newMean);
+          Value newM2 = b.create<arith::AddFOp>(
+              loc, m2, b.create<arith::MulFOp>(loc, delta, newDelta));
+          b.create<linalg::YieldOp>(loc, ValueRange{newMean, newM2, newCount});
+        });
+    Value mean = welford.getResult(0);
+    Value m2 = welford.getResult(1);
+
+    // rSTD = 1 / sqrt(M2 / N + eps), once per row.
+    SmallVector<AffineMap> rowIndexingMaps(
+        2, rewriter.getMultiDimIdentityMap(axis));
+    SmallVector<utils::IteratorType> rowIteratorTypes(
+        axis, utils::IteratorType::parallel);
+    Value rSTD =
+        rewriter
+            .create<linalg::GenericOp>(
+                loc, meanInit.getType(), m2, meanInit, rowIndexingMaps,
+                rowIteratorTypes,
+                [&](OpBuilder &b, Location loc, ValueRange args) {
+                  Value var = b.create<arith::DivFOp>(loc, args[0], elemCount);
+                  b.create<linalg::YieldOp>(
+                      loc, calculateRSTD(b, loc, elemTy, eps, var));
+                })
+            .getResult(0);
+
+    // Normalization pass.
+    SmallVector<Value> normInputs = {input, mean, rSTD};
+    SmallVector<AffineMap> normIndexingMaps = {identityMap, rowMap, rowMap};
+    if (hasWeight) {
+      normInputs.push_back(weight);
+      normIndexingMaps.push_back(normalizedMap);
+    }
+    if (hasBias) {
+      normInputs.push_back(bias);
+      normIndexingMaps.push_back(normalizedMap);
+    }
+    normIndexingMaps.push_back(identityMap);
+    SmallVector<utils::IteratorType> normIteratorTypes(
+        inputRank, utils::IteratorType::parallel);
+    Value outInit = rewriter.create<tensor::EmptyOp>(
+        loc, getAsOpFoldResult(inputSizes), elemTy);
+    Value layerNorm =
+        rewriter
+            .create<linalg::GenericOp>(
+                loc, outInit.getType(), normInputs, outInit, normIndexingMaps,
+                normIteratorTypes,
+                [&](OpBuilder &b, Location loc, ValueRange args) {
+                  Value x = args[0], mean = args[1], rSTD = args[2];
+                  unsigned nextArg = 3;
+                  Value weight = hasWeight ? args[nextArg++]
+                                           : getConstant(b, loc, 1, elemTy);
+                  Value bias = hasBias ? args[nextArg++]
+                                       : getConstant(b, loc, 0, elemTy);
+                  Value result =
+                      createLinalgPayloadCalculationForNormOpsWithRSTD(
+                          b, loc, elemTy, x, mean, rSTD, eps, weight, bias);
+                  b.create<linalg::YieldOp>(loc, result);
+                })
+            .getResult(0);
+
+    // The mean and rSTD results keep the normalized dimensions as 1s.
+    SmallVector<int64_t> meanAndVarShape(
+        inputType.getShape().take_front(axis));
+    meanAndVarShape.append(meanAndVarShapeRank, 1);
+    auto meanAndVarType = RankedTensorType::get(meanAndVarShape, elemTy);
+    SmallVector<ReassociationIndices> reassociation;
+    for (int64_t i = 0; i < axis; i++)
+      reassociation.push_back({i});
+    if (axis > 0) {
+      for (int64_t i = axis; i < inputRank; i++)
+        reassociation.back().push_back(i);
+    }
+    auto expandRowResult = [&](Value rowResult, Type resultType) -> Value {
+      Value expanded = rewriter.create<tensor::ExpandShapeOp>(
+          loc, meanAndVarType, rowResult, reassociation);
+      return rewriter.create<tensor::CastOp>(loc, resultType, expanded);
+    };
+
+    TypeConverter *typeConverter = getTypeConverter();
+    Value outResult = rewriter.create<tensor::CastOp>(
+        loc, typeConverter->convertType(op.getResult(0).getType()), layerNorm);
+    Value meanResult = expandRowResult(
+        mean, typeConverter->convertType(op.getResult(1).getType()));
+    Value rSTDResult = expandRowResult(
+        rSTD, typeConverter->convertType(op.getResult(2).getType()));
+    rewriter.replaceOp(op, {outResult, meanResult, rSTDResult});
+    return success();
+  }
+};
+} // namespace
+
 namespace {
 class ConvertAtenNllLossBackwardOp
     : public OpConversionPattern<AtenNllLossBackwardOp> {
@@ -1574,6 +1756,8 @@ void mlir::torch::torch_to_linalg::populateUncategorizedPatternsAndLegality(
   patterns.add<ConvertAtenNllLossForwardOp>(typeConverter, context);
   target.addIllegalOp<AtenBatchNormOp>();
   patterns.add<ConvertAtenBatchNormOp>(typeConverter, context);
+  target.addIllegalOp<AtenNativeLayerNormOp>();
+  patterns.add<ConvertAtenNativeLayerNormOp>(typeConverter, context);
   target.addIllegalOp<AtenNllLossBackwardOp>();
   patterns.add<ConvertAtenNllLossBackwardOp>(typeConverter, context);
   patterns.add<ConvertTensorStaticInfoCastOp>(typeConverter, context);
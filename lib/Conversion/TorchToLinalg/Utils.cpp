@@ -68,11 +68,11 @@ Value torch_to_linalg::getZeroPaddedTensor(
 }
 
 // Helper function that adds dynamic padding to a tensor, ignoring unpaddedDims
-// dimensions at the beginning. The high and low padding are the same, and the
-// padding value is zero.
+// dimensions at the beginning and unpaddedTrailingDims dimensions at the end.
+// The high and low padding are the same, and the padding value is zero.
 Value torch_to_linalg::getDynamicZeroPaddedTensor(
     Operation *op, OpBuilder &b, Value &input, SmallVectorImpl<Value> &padding,
-    int unpaddedDims) {
+    int unpaddedDims, int unpaddedTrailingDims) {
   assert(input.getType().isa<RankedTensorType>() &&
          "input must be RankedTensorType");
   unsigned int inRank = input.getType().cast<RankedTensorType>().getRank();
@@ -82,8 +82,10 @@ Value torch_to_linalg::getDynamicZeroPaddedTensor(
   Value c0 = b.create<arith::ConstantOp>(loc, b.getI64IntegerAttr(0));
   SmallVector<Value> paddingIncludingUnchanged(unpaddedDims, c0);
   paddingIncludingUnchanged.append(padding);
-  assert(unpaddedDims + padding.size() == inRank &&
-         "sum of unpaddedDims and padding.size() must equal to inputRank");
+  paddingIncludingUnchanged.append(unpaddedTrailingDims, c0);
+  assert(unpaddedDims + padding.size() + unpaddedTrailingDims == inRank &&
+         "sum of unpaddedDims, unpaddedTrailingDims and padding.size() must "
+         "equal to inputRank");
   for (auto pad = paddingIncludingUnchanged.begin();
        pad < paddingIncludingUnchanged.end(); pad++)
     *pad = castIntToIndex(b, loc, *pad);
@@ -319,6 +321,39 @@ Value torch_to_linalg::createElementwiseLinalgGeneric(
       .getResult(0);
 }
 
+Value torch_to_linalg::createTransposeLinalgGeneric(
+    OpBuilder &b, Location loc, Value input, ArrayRef<int64_t> permutation) {
+  auto inputType = input.getType().cast<RankedTensorType>();
+  int64_t rank = inputType.getRank();
+  assert(static_cast<int64_t>(permutation.size()) == rank &&
+         "permutation must have one entry per input dimension");
+
+  // The iteration space is the one of the result, so dimension `i` of the
+  // input is read at the loop index of the result dimension it moves to.
+  SmallVector<Value> resultShape;
+  SmallVector<AffineExpr> inputExprs(rank);
+  for (auto en : llvm::enumerate(permutation)) {
+    resultShape.push_back(getDimOp(b, loc, input, en.value()));
+    inputExprs[en.value()] = b.getAffineDimExpr(en.index());
+  }
+
+  Value initTensor = b.create<tensor::EmptyOp>(
+      loc, getAsOpFoldResult(resultShape), inputType.getElementType());
+  SmallVector<AffineMap> indexingMaps = {
+      AffineMap::get(rank, /*symbolCount=*/0, inputExprs, b.getContext()),
+      b.getMultiDimIdentityMap(rank)};
+  SmallVector<utils::IteratorType> iteratorTypes(rank,
+                                                 utils::IteratorType::parallel);
+  return b
+      .create<linalg::GenericOp>(
+          loc, initTensor.getType(), input, initTensor, indexingMaps,
+          iteratorTypes,
+          [](OpBuilder &b, Location loc, ValueRange args) {
+            b.create<linalg::YieldOp>(loc, args[0]);
+          })
+      .getResult(0);
+}
+
 // Broadcasts input tensor based on the broadcastToShape.
 LogicalResult torch_to_linalg::broadcastToGivenShape(
     Operation *op, PatternRewriter &rewriter, Value input,
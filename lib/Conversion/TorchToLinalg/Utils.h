@@ -31,11 +31,12 @@ Value getZeroPaddedTensor(Operation *op, OpBuilder &b, Value &input,
                           SmallVectorImpl<int64_t> &paddingInts);
 
 // Helper function that adds dynamic padding to a tensor, ignoring unpaddedDims
-// dimensions at the beginning. The high and low padding are the same, and the
-// padding value is zero.
+// dimensions at the beginning and unpaddedTrailingDims dimensions at the end.
+// The high and low padding are the same, and the padding value is zero.
 Value getDynamicZeroPaddedTensor(Operation *op, OpBuilder &b, Value &input,
                                  SmallVectorImpl<Value> &padding,
-                                 int unpaddedDims = 0);
+                                 int unpaddedDims = 0,
+                                 int unpaddedTrailingDims = 0);
 
 // Helper function to caculate the output tensor dims for convolution-like ops.
 // Along each dim:
@@ -70,6 +71,11 @@ Value createElementwiseLinalgGeneric(
     Type resultElementType,
     function_ref<void(OpBuilder &, Location, ValueRange)> bodyBuild);
 
+// Create a linalg.generic that transposes `input`, such that dimension `i` of
+// the result is dimension `permutation[i]` of `input`.
+Value createTransposeLinalgGeneric(OpBuilder &b, Location loc, Value input,
+                                   ArrayRef<int64_t> permutation);
+
 // Broadcasts input tensor based on the broadcastToShape.
 LogicalResult broadcastToGivenShape(Operation *op, PatternRewriter &rewriter,
                                     Value input,
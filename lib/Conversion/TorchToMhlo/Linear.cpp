@@ -177,6 +177,54 @@ void getBmmBroadcast(PatternRewriter &rewriter, Operation *op, Value &inpLhs,
   inpRhs = rhs;
 }
 
+// Broadcasts the batch dimensions of two operands of the same rank where one
+// side is statically 1 and the other is not. Batch dimensions that already
+// agree are left alone, so the common bmm case emits no broadcast at all.
+void getEqualRankBmmBroadcast(PatternRewriter &rewriter, Operation *op,
+                              Value &lhs, Value &rhs, int64_t nBatchDims,
+                              size_t dimSizeIndexBits) {
+  auto lhsShape = lhs.getType().cast<RankedTensorType>().getShape();
+  auto rhsShape = rhs.getType().cast<RankedTensorType>().getShape();
+
+  bool broadcastLhs = false, broadcastRhs = false;
+  for (int64_t i = 0; i < nBatchDims; ++i) {
+    if (lhsShape[i] == 1 && rhsShape[i] != 1)
+      broadcastLhs = true;
+    else if (rhsShape[i] == 1 && lhsShape[i] != 1)
+      broadcastRhs = true;
+  }
+  if (!broadcastLhs && !broadcastRhs)
+    return;
+
+  auto lhsDimSizes =
+      *mhlo::getDimSizesOfTensor(rewriter, op, lhs, dimSizeIndexBits);
+  auto rhsDimSizes =
+      *mhlo::getDimSizesOfTensor(rewriter, op, rhs, dimSizeIndexBits);
+  SmallVector<int64_t> batchShape;
+  SmallVector<Value> batchDimSizes;
+  for (int64_t i = 0; i < nBatchDims; ++i) {
+    bool fromRhs = lhsShape[i] == 1 && rhsShape[i] != 1;
+    batchShape.push_back(fromRhs ? rhsShape[i] : lhsShape[i]);
+    batchDimSizes.push_back(fromRhs ? rhsDimSizes[i] : lhsDimSizes[i]);
+  }
+
+  auto broadcastBatchDims = [&](Value &tensor, ArrayRef<int64_t> shape,
+                                ArrayRef<Value> dimSizes) {
+    SmallVector<int64_t> newShape(batchShape);
+    newShape.append(shape.begin() + nBatchDims, shape.end());
+    SmallVector<Value> newDimSizes(batchDimSizes);
+    newDimSizes.append(dimSizes.begin() + nBatchDims, dimSizes.end());
+    auto broadcastDims = llvm::to_vector<4>(
+        llvm::seq<int64_t>(0, static_cast<int64_t>(shape.size())));
+    tensor = getBroadcastTensor(rewriter, op, tensor, newShape, newDimSizes,
+                                broadcastDims);
+  };
+  if (broadcastLhs)
+    broadcastBatchDims(lhs, lhsShape, lhsDimSizes);
+  if (broadcastRhs)
+    broadcastBatchDims(rhs, rhsShape, rhsDimSizes);
+}
+
 // Perform the basic n-dim matmul operation encompassing the handling of
 // broadcasting and dynamic shape propagation.
 // All PyTorch ops that leverage matrix multiplication will derive this and
@@ -226,15 +274,18 @@ public:
     const auto &options = ConvertAtenOp<AtenOpT>::getOptions();
     int64_t nBatchDims;
     if (rhsRank <= 2) {
-      auto leadingRank = lhsRank - 2;
-      getBmmBroadcast(rewriter, op, lhs, rhs, leadingRank,
-                      options.dimSizeIndexBits);
-      nBatchDims = leadingRank;
+      // The batch dimensions only exist on lhs, so dot_general keeps them as
+      // free dimensions of lhs and no broadcast is needed.
+      nBatchDims = 0;
     } else if (lhsRank <= 2) {
       auto leadingRank = rhsRank - 2;
       getBmmBroadcast(rewriter, op, lhs, rhs, leadingRank,
                       options.dimSizeIndexBits);
       nBatchDims = leadingRank;
+    } else if (lhsRank == rhsRank) {
+      nBatchDims = lhsRank - 2;
+      getEqualRankBmmBroadcast(rewriter, op, lhs, rhs, nBatchDims,
+                               options.dimSizeIndexBits);
     } else {
       assert(rhsRank > 2 && lhsRank > 2);
       auto leadingRank = std::max(lhsRank - rhsRank, rhsRank - lhsRank);
@@ -244,14 +295,15 @@ public:
     }
     auto batchDims = llvm::to_vector<4>(llvm::seq<int64_t>(0, nBatchDims));
 
-    auto lhsResultDim = nBatchDims;
-    auto rhsResultDim = nBatchDims + 1;
-    auto lhsContractingDim = nBatchDims + 1;
+    // lhs contracts its last dimension and rhs the one following the batch
+    // dimensions. An lhs of rank 1 has no result dimension, which is encoded
+    // as an out-of-range index.
+    auto broadcastedLhsRank = lhs.getType().cast<RankedTensorType>().getRank();
+    auto lhsContractingDim = broadcastedLhsRank - 1;
+    auto lhsResultDim =
+        lhsRank == 1 ? broadcastedLhsRank : broadcastedLhsRank - 2;
     auto rhsContractingDim = nBatchDims;
-    if (lhsRank == 1) {
-      lhsResultDim = nBatchDims + 1;
-      lhsContractingDim = nBatchDims;
-    }
+    auto rhsResultDim = nBatchDims + 1;
 
     mhlo::DotDimensionNumbersAttr dotDimensionNumbers =
         mhlo::DotDimensionNumbersAttr::get(
@@ -404,25 +456,38 @@ public:
       return op.emitError("only ranked tensor types are supported in MHLO "
                           "matmul for bias tensor");
 
-    // weight.T
-    rhs = getPermutedTensor(rewriter, op, rhs, {1, 0});
-
     auto lhsTy = lhs.getType().cast<RankedTensorType>();
     auto rhsTy = rhs.getType().cast<RankedTensorType>();
-    auto leadingRank = std::max(lhsTy.getRank() - rhsTy.getRank(),
-                                rhsTy.getRank() - lhsTy.getRank());
 
-    const auto &options = ConvertAtenOp<AtenOpT>::getOptions();
-    getBmmBroadcast(rewriter, op, lhs, rhs, leadingRank,
-                    options.dimSizeIndexBits);
-    auto resultRank = std::max(lhsTy.getRank(), rhsTy.getRank());
-    auto nBatchDims = resultRank - 2;
-    auto batchDims = llvm::to_vector<4>(llvm::seq<int64_t>(0, nBatchDims));
+    SmallVector<int64_t> batchDims;
+    int64_t lhsResultDim, rhsResultDim, lhsContractingDim, rhsContractingDim;
+    if (rhsTy.getRank() == 2) {
+      // Contract with dimension 1 of the weight directly instead of
+      // materializing weight.T, and keep the batch dimensions of the input as
+      // free dimensions of lhs instead of broadcasting the weight over them.
+      lhsResultDim = lhsTy.getRank() - 2;
+      lhsContractingDim = lhsTy.getRank() - 1;
+      rhsResultDim = 0;
+      rhsContractingDim = 1;
+    } else {
+      // weight.T
+      rhs = getPermutedTensor(rewriter, op, rhs, {1, 0});
+      rhsTy = rhs.getType().cast<RankedTensorType>();
+      auto leadingRank = std::max(lhsTy.getRank() - rhsTy.getRank(),
+                                  rhsTy.getRank() - lhsTy.getRank());
 
-    auto lhsResultDim = nBatchDims;
-    auto rhsResultDim = nBatchDims + 1;
-    auto lhsContractingDim = nBatchDims + 1;
-    auto rhsContractingDim = nBatchDims;
+      const auto &options = ConvertAtenOp<AtenOpT>::getOptions();
+      getBmmBroadcast(rewriter, op, lhs, rhs, leadingRank,
+                      options.dimSizeIndexBits);
+      auto resultRank = std::max(lhsTy.getRank(), rhsTy.getRank());
+      auto nBatchDims = resultRank - 2;
+      batchDims = llvm::to_vector<4>(llvm::seq<int64_t>(0, nBatchDims));
+
+      lhsResultDim = nBatchDims;
+      rhsResultDim = nBatchDims + 1;
+      lhsContractingDim = nBatchDims + 1;
+      rhsContractingDim = nBatchDims;
+    }
 
     auto outTy =
         castContractingDim(rewriter, op, lhs, rhs, lhsResultDim, rhsResultDim,
@@ -0,0 +1,400 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+//
+// The TorchToTosa lowering of NCHW ops such as convolution and pooling wraps
+// each TOSA NHWC op in a pair of `tosa.transpose` ops. This pass sinks those
+// transposes through layout-agnostic ops (elementwise ops, reductions, concat)
+// so that an NHWC->NCHW transpose meets the NCHW->NHWC transpose of the next
+// layer and both cancel. Transposes of constants (e.g. convolution weights)
+// are folded into the constant.
+//
+//===----------------------------------------------------------------------===//
+
+#include "torch-mlir/Conversion/TorchToTosa/TorchToTosa.h"
+#include "torch-mlir/Conversion/TorchToTosa/TosaLegalizeUtils.h"
+
+#include "../PassDetail.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/Dialect/Tosa/IR/TosaOps.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+
+using namespace mlir;
+using namespace mlir::torch;
+
+namespace {
+
+// Returns the permutation of a `tosa.transpose` if it is a constant.
+static std::optional<SmallVector<int64_t>>
+getTransposePerms(tosa::TransposeOp op) {
+  DenseIntElementsAttr permsAttr;
+  if (!matchPattern(op.getPerms(), m_Constant(&permsAttr)))
+    return std::nullopt;
+  SmallVector<int64_t> perms;
+  for (const APInt &perm : permsAttr.getValues<APInt>())
+    perms.push_back(perm.getSExtValue());
+  return perms;
+}
+
+static SmallVector<int64_t> invertPermutation(ArrayRef<int64_t> perms) {
+  SmallVector<int64_t> inverse(perms.size());
+  for (auto en : llvm::enumerate(perms))
+    inverse[en.value()] = en.index();
+  return inverse;
+}
+
+static bool isIdentityPermutation(ArrayRef<int64_t> perms) {
+  for (auto en : llvm::enumerate(perms))
+    if (en.value() != static_cast<int64_t>(en.index()))
+      return false;
+  return true;
+}
+
+// `tosa.transpose` defines result dim `i` as input dim `perms[i]`. Returns the
+// type that, once transposed by `perms`, gives `type`.
+static RankedTensorType getUntransposedType(RankedTensorType type,
+                                            ArrayRef<int64_t> perms) {
+  SmallVector<int64_t> shape(type.getRank());
+  for (auto en : llvm::enumerate(perms))
+    shape[en.value()] = type.getDimSize(en.index());
+  return RankedTensorType::get(shape, type.getElementType());
+}
+
+static RankedTensorType getTransposedType(RankedTensorType type,
+                                          ArrayRef<int64_t> perms) {
+  SmallVector<int64_t> shape;
+  for (int64_t perm : perms)
+    shape.push_back(type.getDimSize(perm));
+  return RankedTensorType::get(shape, type.getElementType());
+}
+
+// Transposes the contents of a constant. Only static shapes are supported.
+static DenseElementsAttr transposeElementsAttr(DenseElementsAttr attr,
+                                               ArrayRef<int64_t> perms) {
+  auto type = attr.getType().cast<RankedTensorType>();
+  RankedTensorType resultType = getTransposedType(type, perms);
+  if (attr.isSplat())
+    return DenseElementsAttr::get(resultType,
+                                  attr.getSplatValue<Attribute>());
+
+  ArrayRef<int64_t> shape = type.getShape();
+  int64_t rank = type.getRank();
+  SmallVector<int64_t> strides(rank, 1);
+  for (int64_t i = rank - 2; i >= 0; i--)
+    strides[i] = strides[i + 1] * shape[i + 1];
+
+  SmallVector<Attribute> values = llvm::to_vector(attr.getValues<Attribute>());
+  SmallVector<Attribute> transposed;
+  transposed.reserve(values.size());
+  SmallVector<int64_t> resultIndex(rank, 0);
+  ArrayRef<int64_t> resultShape = resultType.getShape();
+  for (size_t linear = 0, e = values.size(); linear < e; linear++) {
+    int64_t sourceLinear = 0;
+    for (int64_t i = 0; i < rank; i++)
+      sourceLinear += resultIndex[i] * strides[perms[i]];
+    transposed.push_back(values[sourceLinear]);
+    for (int64_t i = rank - 1; i >= 0; i--) {
+      if (++resultIndex[i] < resultShape[i])
+        break;
+      resultIndex[i] = 0;
+    }
+  }
+  return DenseElementsAttr::get(resultType, transposed);
+}
+
+static Value createTranspose(PatternRewriter &rewriter, Operation *op,
+                             Value input, ArrayRef<int64_t> perms) {
+  SmallVector<int32_t> perms32(perms.begin(), perms.end());
+  Value permsConst =
+      tosa::getConstTensor<int32_t>(
+          rewriter, op, perms32, {static_cast<int64_t>(perms32.size())})
+          .value();
+  auto resultType =
+      getTransposedType(input.getType().cast<RankedTensorType>(), perms);
+  return rewriter.create<tosa::TransposeOp>(op->getLoc(), resultType, input,
+                                            permsConst);
+}
+
+// Folds `transpose(transpose(x, p), q)` into `x` or `transpose(x, p . q)`.
+class FoldTransposeOfTranspose : public OpRewritePattern<tosa::TransposeOp> {
+public:
+  using OpRewritePattern::OpRewritePattern;
+  LogicalResult matchAndRewrite(tosa::TransposeOp op,
+                                PatternRewriter &rewriter) const override {
+    auto producer = op.getInput1().getDefiningOp<tosa::TransposeOp>();
+    if (!producer)
+      return rewriter.notifyMatchFailure(op, "input is not a transpose");
+    std::optional<SmallVector<int64_t>> outerPerms = getTransposePerms(op);
+    std::optional<SmallVector<int64_t>> innerPerms =
+        getTransposePerms(producer);
+    if (!outerPerms || !innerPerms)
+      return rewriter.notifyMatchFailure(op, "non-const perms unsupported");
+
+    SmallVector<int64_t> composed;
+    for (int64_t perm : *outerPerms)
+      composed.push_back((*innerPerms)[perm]);
+
+    Value input = producer.getInput1();
+    if (isIdentityPermutation(composed)) {
+      if (input.getType() == op.getType()) {
+        rewriter.replaceOp(op, input);
+      } else {
+        rewriter.replaceOpWithNewOp<tensor::CastOp>(op, op.getType(), input);
+      }
+      return success();
+    }
+    rewriter.replaceOp(op, createTranspose(rewriter, op, input, composed));
+    return success();
+  }
+};
+
+// Folds a transpose of a constant (typically a convolution weight) into a new
+// constant. Non-splat constants are only folded if they have no other user, so
+// that weights are never duplicated.
+class FoldTransposeOfConst : public OpRewritePattern<tosa::TransposeOp> {
+public:
+  using OpRewritePattern::OpRewritePattern;
+  LogicalResult matchAndRewrite(tosa::TransposeOp op,
+                                PatternRewriter &rewriter) const override {
+    DenseElementsAttr inputAttr;
+    if (!matchPattern(op.getInput1(), m_Constant(&inputAttr)))
+      return rewriter.notifyMatchFailure(op, "input is not a constant");
+    if (!inputAttr.isSplat() && !op.getInput1().hasOneUse())
+      return rewriter.notifyMatchFailure(op, "constant has other users");
+    if (!inputAttr.getType().cast<RankedTensorType>().hasStaticShape())
+      return rewriter.notifyMatchFailure(op, "constant must be static");
+    std::optional<SmallVector<int64_t>> perms = getTransposePerms(op);
+    if (!perms)
+      return rewriter.notifyMatchFailure(op, "non-const perms unsupported");
+
+    DenseElementsAttr transposed = transposeElementsAttr(inputAttr, *perms);
+    Value newConst = rewriter.create<tosa::ConstOp>(
+        op.getLoc(), transposed.getType(), transposed);
+    if (newConst.getType() == op.getType()) {
+      rewriter.replaceOp(op, newConst);
+    } else {
+      rewriter.replaceOpWithNewOp<tensor::CastOp>(op, op.getType(), newConst);
+    }
+    return success();
+  }
+};
+
+// Returns true if `op` computes each result element only from the operand
+// elements at the same position, so that it commutes with any transpose.
+static bool isLayoutAgnosticElementwiseOp(Operation *op) {
+  return isa<tosa::AbsOp, tosa::AddOp, tosa::CastOp, tosa::CeilOp,
+             tosa::ClampOp, tosa::EqualOp, tosa::ExpOp, tosa::FloorOp,
+             tosa::GreaterEqualOp, tosa::GreaterOp, tosa::LogOp,
+             tosa::LogicalAndOp, tosa::LogicalNotOp, tosa::LogicalOrOp,
+             tosa::MaximumOp, tosa::MinimumOp, tosa::MulOp, tosa::NegateOp,
+             tosa::PowOp, tosa::ReciprocalOp, tosa::RsqrtOp, tosa::SelectOp,
+             tosa::SigmoidOp, tosa::SubOp, tosa::TanhOp>(op);
+}
+
+// Rewrites `op(transpose(a, p), transpose(b, p), const)` into
+// `transpose(op(a, b, const'), p)`, where `const'` is `const` pre-transposed by
+// the inverse of `p`. Every transpose operand must have a single use, so that
+// the number of transposes never grows.
+class SinkTransposeThroughElementwise : public RewritePattern {
+public:
+  SinkTransposeThroughElementwise(MLIRContext *context)
+      : RewritePattern(MatchAnyOpTypeTag(), /*benefit=*/1, context) {}
+  LogicalResult matchAndRewrite(Operation *op,
+                                PatternRewriter &rewriter) const override {
+    if (!isLayoutAgnosticElementwiseOp(op) || op->getNumResults() != 1)
+      return rewriter.notifyMatchFailure(op, "not an elementwise op");
+    auto resultType = op->getResult(0).getType().dyn_cast<RankedTensorType>();
+    if (!resultType)
+      return rewriter.notifyMatchFailure(op, "result must be ranked");
+
+    std::optional<SmallVector<int64_t>> perms;
+    for (Value operand : op->getOperands()) {
+      auto transpose = operand.getDefiningOp<tosa::TransposeOp>();
+      if (!transpose)
+        continue;
+      std::optional<SmallVector<int64_t>> operandPerms =
+          getTransposePerms(transpose);
+      if (!operandPerms || (perms && *perms != *operandPerms))
+        return rewriter.notifyMatchFailure(op, "mismatching transposes");
+      perms = operandPerms;
+    }
+    if (!perms)
+      return rewriter.notifyMatchFailure(op, "no transposed operand");
+    if (static_cast<int64_t>(perms->size()) != resultType.getRank())
+      return rewriter.notifyMatchFailure(op, "rank-changing broadcast");
+
+    SmallVector<int64_t> inversePerms = invertPermutation(*perms);
+    SmallVector<Value> newOperands;
+    // The operands that are constants, which must be pre-transposed. Operands
+    // that were transposes are replaced by their input, which may also be a
+    // constant but is already in the untransposed layout.
+    SmallVector<std::pair<unsigned, DenseElementsAttr>> constOperands;
+    for (Value operand : op->getOperands()) {
+      if (auto transpose = operand.getDefiningOp<tosa::TransposeOp>()) {
+        if (!operand.hasOneUse())
+          return rewriter.notifyMatchFailure(op, "transpose has other users");
+        newOperands.push_back(transpose.getInput1());
+        continue;
+      }
+      DenseElementsAttr constAttr;
+      auto operandType = operand.getType().dyn_cast<RankedTensorType>();
+      if (!operandType || operandType.getRank() != resultType.getRank() ||
+          !operandType.hasStaticShape() ||
+          !matchPattern(operand, m_Constant(&constAttr)))
+        return rewriter.notifyMatchFailure(
+            op, "operand is neither a transpose nor a constant");
+      if (!constAttr.isSplat() && !operand.hasOneUse())
+        return rewriter.notifyMatchFailure(op, "constant has other users");
+      constOperands.push_back({newOperands.size(), constAttr});
+      newOperands.push_back(operand);
+    }
+
+    // Only commit to IR changes once all operands are known to be supported.
+    for (auto &indexAndAttr : constOperands) {
+      DenseElementsAttr transposed =
+          transposeElementsAttr(indexAndAttr.second, inversePerms);
+      newOperands[indexAndAttr.first] = rewriter.create<tosa::ConstOp>(
+          op->getLoc(), transposed.getType(), transposed);
+    }
+
+    OperationState state(op->getLoc(), op->getName().getStringRef(),
+                         newOperands,
+                         getUntransposedType(resultType, *perms),
+                         op->getAttrs());
+    Operation *newOp = rewriter.create(state);
+    rewriter.replaceOp(op,
+                       createTranspose(rewriter, op, newOp->getResult(0),
+                                       *perms));
+    return success();
+  }
+};
+
+// Rewrites `reduce(transpose(x, p), axis)` into
+// `transpose(reduce(x, p[axis]), p)`. TOSA reductions keep the reduced
+// dimension with size 1, so the rank is unchanged.
+template <typename TosaReduceOpT>
+class SinkTransposeThroughReduction : public OpRewritePattern<TosaReduceOpT> {
+public:
+  using OpRewritePattern<TosaReduceOpT>::OpRewritePattern;
+  LogicalResult matchAndRewrite(TosaReduceOpT op,
+                                PatternRewriter &rewriter) const override {
+    auto transpose = op.getInput().template getDefiningOp<tosa::TransposeOp>();
+    if (!transpose || !transpose->hasOneUse())
+      return rewriter.notifyMatchFailure(op, "input is not a transpose");
+    std::optional<SmallVector<int64_t>> perms = getTransposePerms(transpose);
+    auto resultType = op.getType().template dyn_cast<RankedTensorType>();
+    if (!perms || !resultType)
+      return rewriter.notifyMatchFailure(op, "unsupported transpose");
+
+    int64_t axis = (*perms)[op.getAxis()];
+    auto newOp = rewriter.create<TosaReduceOpT>(
+        op.getLoc(), getUntransposedType(resultType, *perms),
+        transpose.getInput1(), rewriter.getI64IntegerAttr(axis));
+    rewriter.replaceOp(op, createTranspose(rewriter, op, newOp, *perms));
+    return success();
+  }
+};
+
+// Rewrites `concat(transpose(a, p), transpose(b, p), axis)` into
+// `transpose(concat(a, b, p[axis]), p)`.
+class SinkTransposeThroughConcat : public OpRewritePattern<tosa::ConcatOp> {
+public:
+  using OpRewritePattern::OpRewritePattern;
+  LogicalResult matchAndRewrite(tosa::ConcatOp op,
+                                PatternRewriter &rewriter) const override {
+    auto resultType = op.getType().dyn_cast<RankedTensorType>();
+    if (!resultType)
+      return rewriter.notifyMatchFailure(op, "result must be ranked");
+
+    std::optional<SmallVector<int64_t>> perms;
+    SmallVector<Value> newInputs;
+    for (Value input : op.getInput1()) {
+      auto transpose = input.getDefiningOp<tosa::TransposeOp>();
+      if (!transpose || !input.hasOneUse())
+        return rewriter.notifyMatchFailure(op, "input is not a transpose");
+      std::optional<SmallVector<int64_t>> inputPerms =
+          getTransposePerms(transpose);
+      if (!inputPerms || (perms && *perms != *inputPerms))
+        return rewriter.notifyMatchFailure(op, "mismatching transposes");
+      perms = inputPerms;
+      newInputs.push_back(transpose.getInput1());
+    }
+
+    int64_t axis = (*perms)[op.getAxis()];
+    auto newOp = rewriter.create<tosa::ConcatOp>(
+        op.getLoc(), getUntransposedType(resultType, *perms), newInputs,
+        rewriter.getI64IntegerAttr(axis));
+    rewriter.replaceOp(op, createTranspose(rewriter, op, newOp, *perms));
+    return success();
+  }
+};
+
+// Rewrites `tensor.cast(transpose(x, p))` into `transpose(tensor.cast(x), p)`.
+// TorchToTosa ends many lowerings with such a cast, which would otherwise
+// block transposes from meeting.
+class SinkTransposeThroughCast : public OpRewritePattern<tensor::CastOp> {
+public:
+  using OpRewritePattern::OpRewritePattern;
+  LogicalResult matchAndRewrite(tensor::CastOp op,
+                                PatternRewriter &rewriter) const override {
+    auto transpose = op.getSource().getDefiningOp<tosa::TransposeOp>();
+    if (!transpose || !transpose->hasOneUse())
+      return rewriter.notifyMatchFailure(op, "source is not a transpose");
+    std::optional<SmallVector<int64_t>> perms = getTransposePerms(transpose);
+    auto resultType = op.getType().dyn_cast<RankedTensorType>();
+    if (!perms || !resultType)
+      return rewriter.notifyMatchFailure(op, "unsupported transpose");
+
+    Value newCast = rewriter.create<tensor::CastOp>(
+        op.getLoc(), getUntransposedType(resultType, *perms),
+        transpose.getInput1());
+    rewriter.replaceOp(op, createTranspose(rewriter, op, newCast, *perms));
+    return success();
+  }
+};
+
+class PropagateTosaLayout
+    : public PropagateTosaLayoutBase<PropagateTosaLayout> {
+public:
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<tosa::TosaDialect>();
+    registry.insert<tensor::TensorDialect>();
+  }
+
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+    auto countTransposes = [&]() {
+      int64_t count = 0;
+      getOperation().walk([&](tosa::TransposeOp) { count++; });
+      return count;
+    };
+    numTransposesBefore = countTransposes();
+
+    RewritePatternSet patterns(context);
+    patterns.add<FoldTransposeOfTranspose, FoldTransposeOfConst,
+                 SinkTransposeThroughElementwise, SinkTransposeThroughConcat,
+                 SinkTransposeThroughCast>(context);
+    patterns.add<SinkTransposeThroughReduction<tosa::ReduceSumOp>,
+                 SinkTransposeThroughReduction<tosa::ReduceMaxOp>,
+                 SinkTransposeThroughReduction<tosa::ReduceMinOp>,
+                 SinkTransposeThroughReduction<tosa::ReduceProdOp>>(context);
+    tensor::CastOp::getCanonicalizationPatterns(patterns, context);
+    if (failed(applyPatternsAndFoldGreedily(getOperation(),
+                                            std::move(patterns))))
+      return signalPassFailure();
+
+    numTransposesAfter = countTransposes();
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::torch::createPropagateTosaLayoutPass() {
+  return std::make_unique<PropagateTosaLayout>();
+}
@@ -2222,6 +2222,17 @@ OpFoldResult AtenIntTensorOp::fold(ArrayRef<Attribute> operands) {
   // aten.Int.Tensor, fold to the scalar number.
   if (auto numToTensorScalar = getA().getDefiningOp<PrimNumToTensorScalarOp>())
     return numToTensorScalar.getA();
+  // A one-element tensor literal, such as the zero point buffer of a
+  // quantization stub, folds to its element.
+  if (auto attr = operands[0].dyn_cast_or_null<DenseIntElementsAttr>()) {
+    if (attr.getNumElements() != 1)
+      return nullptr;
+    APInt value = *attr.getValues<APInt>().begin();
+    Type elementType = attr.getElementType();
+    if (elementType.isUnsignedInteger() || elementType.isInteger(1))
+      return getI64IntegerAttr(getContext(), value.getZExtValue());
+    return getI64IntegerAttr(getContext(), value.getSExtValue());
+  }
   return nullptr;
 }
 
@@ -2234,9 +2245,50 @@ OpFoldResult AtenFloatTensorOp::fold(ArrayRef<Attribute> operands) {
   // aten.Float.Tensor, fold to the scalar number.
   if (auto numToTensorScalar = getA().getDefiningOp<PrimNumToTensorScalarOp>())
     return numToTensorScalar.getA();
+  // A one-element tensor literal, such as the scale buffer of a quantization
+  // stub, folds to its element.
+  if (auto attr = operands[0].dyn_cast_or_null<DenseFPElementsAttr>()) {
+    if (attr.getNumElements() != 1)
+      return nullptr;
+    FloatAttr value = *attr.getValues<FloatAttr>().begin();
+    return getF64FloatAttr(getContext(), value.getValueAsDouble());
+  }
   return nullptr;
 }
 
+//===----------------------------------------------------------------------===//
+// QuantizedLinearOp
+//===----------------------------------------------------------------------===//
+
+void QuantizedLinearOp::getCanonicalizationPatterns(RewritePatternSet &patterns,
+                                                    MLIRContext *context) {
+  // The shape library cannot see through `!torch.LinearParams`, so refine the
+  // result sizes from the weight packed by `torch.linear_params.create`.
+  patterns.add(+[](QuantizedLinearOp op, PatternRewriter &rewriter) {
+    auto resultType = op.getType().cast<BaseTensorType>();
+    if (resultType.hasSizes())
+      return failure();
+    auto params = op.getWPrepack().getDefiningOp<LinearParamsCreateOp>();
+    if (!params)
+      return failure();
+    auto inputType = op.getX().getType().cast<BaseTensorType>();
+    auto weightType = params.getWeight().getType().cast<BaseTensorType>();
+    if (!inputType.hasSizes() || inputType.getSizes().empty() ||
+        !weightType.hasSizes() || weightType.getSizes().size() != 2)
+      return failure();
+    SmallVector<int64_t> sizes(inputType.getSizes());
+    sizes.back() = weightType.getSizes()[0];
+    Type refinedType =
+        resultType.getWithSizesAndDtype(sizes, resultType.getOptionalDtype());
+    Value refined = rewriter.create<QuantizedLinearOp>(
+        op.getLoc(), refinedType, op.getX(), op.getWPrepack(),
+        op.getYScaleI(), op.getYZeroPointI());
+    rewriter.replaceOpWithNewOp<TensorStaticInfoCastOp>(op, resultType,
+                                                        refined);
+    return success();
+  });
+}
+
 //===----------------------------------------------------------------------===//
 // AtenDivFloatOp
 //===----------------------------------------------------------------------===//
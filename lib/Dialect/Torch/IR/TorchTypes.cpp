@@ -372,6 +372,13 @@ static Type convertDtypeToBuiltinElementType(MLIRContext *context, Type dtype) {
   } else if (auto integerType = dtype.dyn_cast<IntegerType>()) {
     return IntegerType::get(context, integerType.getWidth(),
                             IntegerType::Signless);
+  } else if (dtype.isa<QInt8Type, QUInt8Type>()) {
+    // Quantized tensors are represented by their integer representation. The
+    // quantization parameters are carried by the op that created the tensor
+    // (e.g. `torch.per_tensor_affine.create`). The backend type conversion
+    // rejects quantized tensors unless a pattern opts in with
+    // `setupQuantizedTensorToBuiltinTensorConversion`.
+    return IntegerType::get(context, 8, IntegerType::Signless);
   }
   emitError(UnknownLoc::get(context))
       << "unimplemented: conversion of dtype " << dtype
@@ -16,6 +16,7 @@
 #include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
 #include "torch-mlir/Dialect/Torch/IR/TorchTypes.h"
 #include "torch-mlir/Dialect/Torch/Transforms/Passes.h"
+#include "torch-mlir/Dialect/Torch/Transforms/Telemetry.h"
 #include "torch-mlir/Dialect/Torch/Utils/Utils.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/StringExtras.h"
@@ -3546,11 +3547,40 @@ public:
 };
 } // namespace
 
+namespace {
+/// Wraps a decomposition pattern to count how many times it applies, for
+/// telemetry.
+class CountingDecompositionPattern : public RewritePattern {
+public:
+  CountingDecompositionPattern(std::unique_ptr<RewritePattern> pattern,
+                               int64_t &count)
+      : RewritePattern(pattern->getRootKind()->getStringRef(),
+                       pattern->getBenefit(), pattern->getContext()),
+        pattern(std::move(pattern)), count(count) {
+    setHasBoundedRewriteRecursion(
+        this->pattern->hasBoundedRewriteRecursion());
+  }
+  LogicalResult matchAndRewrite(Operation *op,
+                                PatternRewriter &rewriter) const override {
+    if (failed(pattern->matchAndRewrite(op, rewriter)))
+      return failure();
+    ++count;
+    return success();
+  }
+
+private:
+  std::unique_ptr<RewritePattern> pattern;
+  int64_t &count;
+};
+} // namespace
+
 namespace {
 class DecomposeComplexOpsPass
     : public DecomposeComplexOpsBase<DecomposeComplexOpsPass> {
 private:
   llvm::StringSet<> legalOpsSet;
+  // The number of times each op was decomposed, if telemetry is enabled.
+  llvm::StringMap<int64_t> *decompositionCounts = nullptr;
 
   template <typename DecomposePattern>
   void addPatternIfTargetOpIsIllegal(RewritePatternSet &patterns) {
@@ -3564,8 +3594,15 @@ private:
     // on `Operation *` are not allowed, since there is no way of telling if
     // that pattern will match on an op in the `legalOpsSet` or not.
     assert(opName && "All decomposition patterns must target a single op");
-    if (!legalOpsSet.contains(opName->getStringRef()))
+    if (legalOpsSet.contains(opName->getStringRef()))
+      return;
+    if (decompositionCounts) {
+      patterns.add(std::make_unique<CountingDecompositionPattern>(
+          RewritePattern::create<DecomposePattern>(context),
+          (*decompositionCounts)[opName->getStringRef()]));
+    } else {
       patterns.add<DecomposePattern>(context);
+    }
   }
 
 public:
@@ -3581,6 +3618,8 @@ public:
     // `legalOpsSet` must be delayed to when `runOnOperation` gets called.
     legalOpsSet.clear();
     legalOpsSet.insert(legalOps.begin(), legalOps.end());
+    llvm::StringMap<int64_t> counts;
+    decompositionCounts = isTelemetryEnabled(context) ? &counts : nullptr;
 
     addPatternIfTargetOpIsIllegal<DecomposeAtenSoftmaxIntOp>(patterns);
     addPatternIfTargetOpIsIllegal<DecomposeAten_SoftmaxOp>(patterns);
@@ -3707,6 +3746,10 @@ public:
                                             config))) {
       return signalPassFailure();
     }
+    if (decompositionCounts) {
+      recordDecompositions(context, counts);
+      decompositionCounts = nullptr;
+    }
   }
 };
 } // namespace
@@ -0,0 +1,163 @@
+//===- LiftWeightsToArguments.cpp --------------------------------*- C++-*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "PassDetail.h"
+
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "torch-mlir/Dialect/Torch/IR/TorchDialect.h"
+#include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
+#include "torch-mlir/Dialect/Torch/Transforms/Passes.h"
+#include "llvm/ADT/MapVector.h"
+
+using namespace mlir;
+using namespace mlir::torch;
+using namespace mlir::torch::Torch;
+
+namespace {
+class LiftWeightsToArgumentsPass
+    : public LiftWeightsToArgumentsBase<LiftWeightsToArgumentsPass> {
+public:
+  LiftWeightsToArgumentsPass() = default;
+  LiftWeightsToArgumentsPass(int64_t minElements) {
+    this->minElements = minElements;
+  }
+  void runOnOperation() override {
+    ModuleOp module = getOperation();
+    MLIRContext *context = module.getContext();
+    SymbolTable symbolTable(module);
+
+    InitializeGlobalSlotsOp initialize;
+    for (auto moduleInitializer :
+         module.getOps<GlobalSlotModuleInitializerOp>()) {
+      initialize = cast<InitializeGlobalSlotsOp>(
+          moduleInitializer.getBody()->getTerminator());
+    }
+    if (!initialize)
+      return;
+
+    // Find the slots that hold a large enough tensor literal which is not
+    // used for anything else in the initializer.
+    llvm::MapVector</*FlatSymbolRefAttr*/ Attribute, NonValueTensorLiteralOp>
+        candidates;
+    for (int i = 0, e = initialize.getNumOperands(); i != e; i++) {
+      auto literal =
+          initialize.getOperand(i).getDefiningOp<NonValueTensorLiteralOp>();
+      if (!literal || !literal->hasOneUse())
+        continue;
+      auto type = literal.getType().cast<BaseTensorType>();
+      if (!type.hasSizes() || !type.hasDtype())
+        continue;
+      if (literal.getValue().getNumElements() < minElements)
+        continue;
+      candidates.insert({initialize.getSlotSymNames()[i], literal});
+    }
+    if (candidates.empty())
+      return;
+
+    // A slot can only be lifted if it is never set, and only read directly
+    // in public functions, since those are the only functions whose callers
+    // can provide the extra arguments.
+    llvm::MapVector<func::FuncOp,
+                    llvm::MapVector<Attribute, SmallVector<GlobalSlotGetOp>>>
+        getsByFunc;
+    module.walk([&](Operation *op) {
+      if (auto set = dyn_cast<GlobalSlotSetOp>(op)) {
+        candidates.erase(set.getSlotAttr());
+        return;
+      }
+      auto get = dyn_cast<GlobalSlotGetOp>(op);
+      if (!get || !candidates.count(get.getSlotAttr()))
+        return;
+      auto func = dyn_cast<func::FuncOp>(get->getParentOp());
+      if (!func || !func.isPublic()) {
+        candidates.erase(get.getSlotAttr());
+        return;
+      }
+      getsByFunc[func][get.getSlotAttr()].push_back(get);
+    });
+    if (candidates.empty())
+      return;
+
+    auto typeBoundIdent = StringAttr::get(context, "torch.type_bound");
+    SmallVector<NamedAttribute> weightArguments;
+    if (auto existing = module->getAttrOfType<DictionaryAttr>(
+            "torch.weight_arguments"))
+      llvm::append_range(weightArguments, existing.getValue());
+    for (auto &funcAndGets : getsByFunc) {
+      func::FuncOp func = funcAndGets.first;
+      SmallVector<Attribute> liftedNames;
+      for (auto &slotAndGets : funcAndGets.second) {
+        auto slotSymName = slotAndGets.first.cast<FlatSymbolRefAttr>();
+        auto it = candidates.find(slotSymName);
+        if (it == candidates.end())
+          continue;
+        auto literalType = it->second.getType().cast<NonValueTensorType>();
+        auto argAttrs = DictionaryAttr::get(
+            context, {NamedAttribute(
+                         typeBoundIdent,
+                         TypeAttr::get(literalType.getWithValueSemantics()))});
+        func.insertArgument(func.getNumArguments(),
+                            NonValueTensorType::getWithLeastStaticInformation(
+                                context),
+                            argAttrs, slotAndGets.second.front().getLoc());
+        BlockArgument arg = func.getArgument(func.getNumArguments() - 1);
+        for (GlobalSlotGetOp get : slotAndGets.second) {
+          Value replacement = arg;
+          if (get.getType() != arg.getType()) {
+            OpBuilder builder(get);
+            replacement = builder.create<TensorStaticInfoCastOp>(
+                get.getLoc(), get.getType(), arg);
+          }
+          get.replaceAllUsesWith(replacement);
+          get.erase();
+        }
+        liftedNames.push_back(
+            StringAttr::get(context, slotSymName.getValue()));
+      }
+      if (liftedNames.empty())
+        continue;
+      weightArguments.push_back(NamedAttribute(
+          StringAttr::get(context, func.getName()),
+          ArrayAttr::get(context, liftedNames)));
+    }
+    module->setAttr("torch.weight_arguments",
+                    DictionaryAttr::get(context, weightArguments));
+
+    // Remove the lifted slots and their values from the initializer.
+    SmallVector<Attribute> newSlotSymNames;
+    SmallVector<Value> newInitialValues;
+    for (int i = 0, e = initialize.getNumOperands(); i != e; i++) {
+      Attribute slotSymName = initialize.getSlotSymNames()[i];
+      if (!candidates.count(slotSymName)) {
+        newSlotSymNames.push_back(slotSymName);
+        newInitialValues.push_back(initialize.getOperand(i));
+      }
+    }
+    {
+      OpBuilder builder(initialize);
+      builder.create<InitializeGlobalSlotsOp>(
+          initialize.getLoc(), ArrayAttr::get(context, newSlotSymNames),
+          newInitialValues);
+    }
+    initialize.erase();
+    for (auto &slotAndLiteral : candidates) {
+      slotAndLiteral.second.erase();
+      auto slotSymName = slotAndLiteral.first.cast<FlatSymbolRefAttr>();
+      symbolTable.lookup<GlobalSlotOp>(slotSymName.getValue()).erase();
+    }
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<ModuleOp>>
+mlir::torch::Torch::createLiftWeightsToArgumentsPass(int64_t minElements) {
+  return std::make_unique<LiftWeightsToArgumentsPass>(minElements);
+}
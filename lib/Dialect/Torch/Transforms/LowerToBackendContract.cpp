@@ -10,15 +10,20 @@
 #include "PassDetail.h"
 
 #include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/Threading.h"
 #include "mlir/Pass/PassManager.h"
 #include "mlir/Transforms/DialectConversion.h"
 #include "mlir/Transforms/Passes.h"
 #include "torch-mlir/Dialect/Torch/IR/TorchDialect.h"
 #include "torch-mlir/Dialect/Torch/IR/TorchOps.h"
 #include "torch-mlir/Dialect/Torch/Transforms/Passes.h"
+#include "torch-mlir/Dialect/Torch/Transforms/Telemetry.h"
 #include "torch-mlir/Dialect/Torch/Utils/Utils.h"
 #include "llvm/Support/Debug.h"
 
+#include <chrono>
+#include <mutex>
+
 #define DEBUG_TYPE "torch-lower-to-backend-contract"
 
 using namespace mlir;
@@ -48,6 +53,12 @@ static LogicalResult checkType(Operation *op, Type type,
   if (type.isa<Torch::NoneType, Torch::StringType>())
     return success();
 
+  // Packed quantized linear params are only consumed by `quantized::linear`,
+  // which backends lower by reading the weight and bias from the
+  // `torch.linear_params.create` op statically.
+  if (type.isa<Torch::LinearParamsType>())
+    return success();
+
   // We blanket prohibit non-value-semantic tensors.
   // All of our backends are currently based on value-semantic tensors, so
   // we consider it our responsibility to lower all non-value-semantic tensors
@@ -199,11 +210,7 @@ static bool satisfiesBackendContract(ModuleOp module,
 
   // Check all the types of all Value's in the program and the legality of all
   // the ops.
-  //
-  // A pre-order walk gives a more intuitive "first error".
-  // TODO: Should we report more than the first error?
-  // How do we avoid making it too spammy?
-  auto walkResult1 = module.walk<WalkOrder::PreOrder>([&](Block *block) {
+  auto checkBlock = [&](Block *block) {
     for (BlockArgument arg : block->getArguments())
       if (failed(checkType(block->getParentOp(), arg.getType(),
                            actuallyEmitDiagnostics))) {
@@ -219,12 +226,59 @@ static bool satisfiesBackendContract(ModuleOp module,
     }
 
     return WalkResult::advance();
-  });
+  };
+
+  // When only the answer is needed, check the top-level ops (and so each
+  // function) in parallel. This check runs after every iteration of the
+  // simplification pipeline, so for modules with many functions it is worth
+  // spreading over the context's thread pool.
+  if (!actuallyEmitDiagnostics) {
+    if (checkBlock(module.getBody()).wasInterrupted())
+      return false;
+    SmallVector<Operation *> topLevelOps;
+    for (Operation &op : *module.getBody())
+      topLevelOps.push_back(&op);
+    return succeeded(failableParallelForEach(
+        module.getContext(), topLevelOps, [&](Operation *op) {
+          WalkResult result = op->walk<WalkOrder::PreOrder>(
+              [&](Block *block) { return checkBlock(block); });
+          return failure(result.wasInterrupted());
+        }));
+  }
+
+  // A pre-order walk gives a more intuitive "first error".
+  // TODO: Should we report more than the first error?
+  // How do we avoid making it too spammy?
+  auto walkResult1 = module.walk<WalkOrder::PreOrder>(checkBlock);
   if (walkResult1.wasInterrupted())
     return false;
   return true;
 }
 
+/// Counts the tensors in `module` whose rank or whose dtype is unknown.
+static std::pair<int64_t, int64_t> countUnresolvedTensors(ModuleOp module) {
+  int64_t numUnresolvedShapes = 0;
+  int64_t numUnresolvedDtypes = 0;
+  auto countType = [&](Type type) {
+    auto tensorType = type.dyn_cast<BaseTensorType>();
+    if (!tensorType)
+      return;
+    if (!tensorType.hasSizes())
+      numUnresolvedShapes++;
+    if (!tensorType.hasDtype())
+      numUnresolvedDtypes++;
+  };
+  module.walk([&](Operation *op) {
+    for (Region &region : op->getRegions())
+      for (Block &block : region)
+        for (BlockArgument arg : block.getArguments())
+          countType(arg.getType());
+    for (Type type : op->getResultTypes())
+      countType(type);
+  });
+  return {numUnresolvedShapes, numUnresolvedDtypes};
+}
+
 // Explicitly set ops and dialects allowed and not allowed in backend contract.
 static ConversionTarget
 getBackendContractTarget(MLIRContext *context, bool decompose,
@@ -253,30 +307,87 @@ public:
     ConversionTarget target =
         getBackendContractTarget(context, decompose, backendLegalOps);
 
-    OpPassManager pm(module.getOperationName());
     TorchLoweringPipelineOptions options;
     options.decompose = decompose;
     options.backendLegalOps = backendLegalOps;
-    createTorchSimplificationPipeline(pm, options);
+    // The stages of the simplification pipeline run one at a time, so that
+    // the time spent in each can be reported.
+    ArrayRef<TorchSimplificationStage> stages = getTorchSimplificationStages();
+    SmallVector<OpPassManager> stagePipelines;
+    for (const TorchSimplificationStage &stage : stages) {
+      stagePipelines.emplace_back(module.getOperationName());
+      stage.build(stagePipelines.back(), options);
+    }
+
+    using Clock = std::chrono::steady_clock;
+    auto secondsSince = [](Clock::time_point start) {
+      return std::chrono::duration<double>(Clock::now() - start).count();
+    };
+    bool collectTelemetry = isTelemetryEnabled(context);
+    if (collectTelemetry)
+      (void)takeDecompositions(context);
+    Clock::time_point passStart = Clock::now();
 
+    bool satisfied = false;
     int i = 0;
-    do {
-      if (i++ == maxIterations) {
-        LLVM_DEBUG({
-          llvm::dbgs() << "LowerToBackendContractPass: "
-                       << "failed to satisfy backend contract after "
-                       << maxIterations
-                       << " iterations of the simplification pipeline\n";
-        });
-        // Show the diagnostics.
-        (void)satisfiesBackendContract(module, target,
-                                       /*actuallyEmitDiagnostics=*/true);
-        return signalPassFailure();
+    while (!satisfied) {
+      if (i == maxIterations)
+        break;
+      i++;
+
+      llvm::json::Object stageSeconds;
+      for (auto [stage, stagePipeline] : llvm::zip(stages, stagePipelines)) {
+        Clock::time_point stageStart = Clock::now();
+        if (failed(runPipeline(stagePipeline, module)))
+          return signalPassFailure();
+        if (collectTelemetry)
+          stageSeconds[stage.name] = secondsSince(stageStart);
       }
+      Clock::time_point checkStart = Clock::now();
+      satisfied = satisfiesBackendContract(module, target);
+      double checkSeconds = secondsSince(checkStart);
 
-      if (failed(runPipeline(pm, module)))
-        return signalPassFailure();
-    } while (!satisfiesBackendContract(module, target));
+      if (collectTelemetry) {
+        llvm::json::Object decompositions;
+        for (const auto &entry : takeDecompositions(context))
+          decompositions[entry.getKey().str()] = entry.getValue();
+        auto [numUnresolvedShapes, numUnresolvedDtypes] =
+            countUnresolvedTensors(module);
+        emitTelemetry(context,
+                      llvm::json::Object{
+                          {"event", "lower_to_backend_contract_iteration"},
+                          {"iteration", i},
+                          {"stage_seconds", std::move(stageSeconds)},
+                          {"contract_check_seconds", checkSeconds},
+                          {"decompositions", std::move(decompositions)},
+                          {"unresolved_shapes", numUnresolvedShapes},
+                          {"unresolved_dtypes", numUnresolvedDtypes},
+                          {"satisfies_backend_contract", satisfied},
+                      });
+      }
+    }
+    if (collectTelemetry) {
+      emitTelemetry(context, llvm::json::Object{
+                                 {"event", "lower_to_backend_contract"},
+                                 {"iterations", i},
+                                 {"max_iterations", maxIterations.getValue()},
+                                 {"satisfies_backend_contract", satisfied},
+                                 {"seconds", secondsSince(passStart)},
+                             });
+    }
+
+    if (!satisfied) {
+      LLVM_DEBUG({
+        llvm::dbgs() << "LowerToBackendContractPass: "
+                     << "failed to satisfy backend contract after "
+                     << maxIterations
+                     << " iterations of the simplification pipeline\n";
+      });
+      // Show the diagnostics.
+      (void)satisfiesBackendContract(module, target,
+                                     /*actuallyEmitDiagnostics=*/true);
+      return signalPassFailure();
+    }
     LLVM_DEBUG({
       llvm::dbgs() << "LowerToBackendContractPass: "
                    << "succeeded after " << i
@@ -11,6 +11,10 @@
 #include "mlir/Pass/PassManager.h"
 #include "mlir/Transforms/Passes.h"
 
+using namespace mlir;
+using namespace mlir::torch;
+using namespace mlir::torch::Torch;
+
 void mlir::torch::registerTorchPasses() {
   mlir::torch::registerPasses();
   mlir::PassPipelineRegistration<Torch::TorchLoweringPipelineOptions>(
@@ -55,6 +59,12 @@ void mlir::torch::Torch::createTorchScriptModuleToTorchBackendPipeline(
   // calls, so inline everything.
   // TODO: Improve shape inference.
   pm.addPass(createInlinerPass());
+  // Keep large weights out of the program if requested, before they are
+  // inlined as literals by the simplification pipeline.
+  if (options.liftWeightsToArguments) {
+    pm.addPass(
+        createLiftWeightsToArgumentsPass(options.liftWeightsMinElements));
+  }
 
   createTorchFunctionToTorchBackendPipeline(pm, options);
 }
@@ -93,8 +103,8 @@ void mlir::torch::Torch::createTorchFunctionToTorchBackendPipeline(
 // O(module size) number of iterations of this simplification pipeline, then
 // we may need to adjust the approach, such as to do some of the transformations
 // together at finer granularity.
-void mlir::torch::Torch::createTorchSimplificationPipeline(
-    OpPassManager &pm, const TorchLoweringPipelineOptions &options) {
+static void createCleanupStage(OpPassManager &pm,
+                               const TorchLoweringPipelineOptions &options) {
   // General cleanup.
   pm.addNestedPass<func::FuncOp>(createCanonicalizerPass());
   // Inline global slots to expose a bunch of simplification opportunities
@@ -112,32 +122,63 @@ void mlir::torch::Torch::createTorchSimplificationPipeline(
   // Remove dead global slots.
   pm.addPass(createSymbolDCEPass());
   // Convert the bulk of non-ABI-visible !torch.tensor's to !torch.vtensor's.
-  pm.addNestedPass<func::FuncOp>(Torch::createMaximizeValueSemanticsPass());
+  pm.addNestedPass<func::FuncOp>(createMaximizeValueSemanticsPass());
   // Update the return op to return value tensors.
-  pm.addPass(Torch::createRefinePublicReturnPass());
+  pm.addPass(createRefinePublicReturnPass());
   pm.addNestedPass<func::FuncOp>(createCanonicalizerPass());
+}
+
+static void
+createShapeRefinementStage(OpPassManager &pm,
+                           const TorchLoweringPipelineOptions &options) {
   // Do shape refinement.
   // This should be run before RefineTypes (which primarily does dtype
   // inference), because Torch type promotion rules actually depend on the shape
   // of the operand.
   createTorchShapeRefinementPipeline(pm);
+}
+
+static void
+createDtypeRefinementStage(OpPassManager &pm,
+                           const TorchLoweringPipelineOptions &options) {
   createTorchDtypeRefinementPipeline(pm);
   // Refine types in the program, which mainly means inferring dtypes of ops.
-  pm.addNestedPass<func::FuncOp>(Torch::createRefineTypesPass());
+  pm.addNestedPass<func::FuncOp>(createRefineTypesPass());
   // Propagate to ABI return types the shape/dtype information discovered by
   // the previous pass. Doing this is ABI-compatible for our backends.
-  pm.addPass(Torch::createRefinePublicReturnPass());
+  pm.addPass(createRefinePublicReturnPass());
   // This can fold away some branches given the information got from
   // RefineTypes before doing maximize value sematics which only works with
   // basic blocks.
   pm.addNestedPass<func::FuncOp>(createCanonicalizerPass());
+}
+
+static void createDecomposeStage(OpPassManager &pm,
+                                 const TorchLoweringPipelineOptions &options) {
   if (options.decompose) {
     pm.addNestedPass<func::FuncOp>(
-        Torch::createDecomposeComplexOpsPass(options.backendLegalOps));
+        createDecomposeComplexOpsPass(options.backendLegalOps));
     pm.addNestedPass<func::FuncOp>(createCanonicalizerPass());
   }
 }
 
+ArrayRef<TorchSimplificationStage>
+mlir::torch::Torch::getTorchSimplificationStages() {
+  static const TorchSimplificationStage stages[] = {
+      {"cleanup", createCleanupStage},
+      {"shape-refinement", createShapeRefinementStage},
+      {"dtype-refinement", createDtypeRefinementStage},
+      {"decompose", createDecomposeStage},
+  };
+  return stages;
+}
+
+void mlir::torch::Torch::createTorchSimplificationPipeline(
+    OpPassManager &pm, const TorchLoweringPipelineOptions &options) {
+  for (const TorchSimplificationStage &stage : getTorchSimplificationStages())
+    stage.build(pm, options);
+}
+
 static void createRefinementPipeline(
     mlir::OpPassManager &pm,
     llvm::function_ref<std::unique_ptr<mlir::OperationPass<mlir::ModuleOp>>()>
@@ -673,6 +673,7 @@ void TypeAnalysis::visitOperation(Operation *op,
   }
 
   // Dtype is always float32, except for bfloat16, float16, float64 and nullptr.
+  // Quantized tanh keeps its quantized dtype.
   if (isa<AtenTanhOp, AtenExpOp, AtenSinOp, AtenCosOp, AtenSigmoidOp,
           AtenReciprocalOp, AtenLogOp, AtenSqrtOp, AtenLog2Op, AtenLog1pOp,
           AtenRsqrtOp, AtenErfOp, AtenSoftplusOp, AtenFrobeniusNormDimOp,
@@ -682,7 +683,8 @@ void TypeAnalysis::visitOperation(Operation *op,
     Type dtype = operands[0]->getValue().dtype;
     if (dtype) {
       knowledge.dtype = Float32Type::get(op->getContext());
-      if (dtype.isa<BFloat16Type, Float16Type, Float64Type>())
+      if (dtype.isa<BFloat16Type, Float16Type, Float64Type>() ||
+          (isa<AtenTanhOp>(op) && dtype.isa<QInt8Type, QUInt8Type>()))
         knowledge.dtype = dtype;
     }
     incorporateKnowledge(op->getResult(0), knowledge);
@@ -1180,6 +1182,33 @@ void TypeAnalysis::visitOperation(Operation *op,
     return;
   }
 
+  if (auto dequantize = dyn_cast<AtenDequantizeSelfOp>(op)) {
+    auto knowledge =
+        ValueKnowledge::getTensorPessimisticValueState(op->getContext());
+    knowledge.dtype = Float32Type::get(op->getContext());
+    incorporateKnowledge(dequantize.getResult(), knowledge);
+    return;
+  }
+
+  if (auto quantize = dyn_cast<AtenQuantizePerTensorOp>(op)) {
+    auto knowledge =
+        ValueKnowledge::getTensorPessimisticValueState(op->getContext());
+    int64_t dtypeInt;
+    if (matchPattern(quantize.getDtype(), m_TorchConstantInt(&dtypeInt)))
+      knowledge.dtype = getTypeForDTypeInteger(op->getContext(), dtypeInt);
+    incorporateKnowledge(quantize.getResult(), knowledge);
+    return;
+  }
+
+  // The result of `quantized::linear` has the dtype of its input.
+  if (isa<QuantizedLinearOp>(op)) {
+    auto knowledge =
+        ValueKnowledge::getTensorPessimisticValueState(op->getContext());
+    knowledge.dtype = operands[0]->getValue().dtype;
+    incorporateKnowledge(op->getResult(0), knowledge);
+    return;
+  }
+
   // Otherwise, this is an unknown operation, so reset the state.
   setAllToEntryStates(results);
   return;
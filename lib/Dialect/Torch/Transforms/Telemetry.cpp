@@ -0,0 +1,91 @@
+//===- Telemetry.cpp ---------------------------------------------*- C++-*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+// Also available under a BSD-style license. See LICENSE.
+//
+//===----------------------------------------------------------------------===//
+
+#include "torch-mlir/Dialect/Torch/Transforms/Telemetry.h"
+
+#include "llvm/ADT/DenseMap.h"
+
+#include <memory>
+#include <mutex>
+#include <utility>
+
+using namespace mlir;
+using namespace mlir::torch;
+using namespace mlir::torch::Torch;
+
+namespace {
+struct TelemetryState {
+  TelemetryCallback callback;
+  // Guards `decompositions`, which are recorded from the threads that run
+  // DecomposeComplexOps on different functions.
+  std::mutex mutex;
+  llvm::StringMap<int64_t> decompositions;
+};
+} // namespace
+
+// Telemetry is rarely enabled, so the state lives in a side table rather than
+// in the context itself. Contexts must disable telemetry before they are
+// destroyed, since a new context could reuse the address.
+static std::mutex tableMutex;
+
+static llvm::DenseMap<MLIRContext *, std::shared_ptr<TelemetryState>> &
+getTable() {
+  // Intentionally leaked: contexts owned by Python may outlive static
+  // destructors.
+  static auto *table =
+      new llvm::DenseMap<MLIRContext *, std::shared_ptr<TelemetryState>>();
+  return *table;
+}
+
+static std::shared_ptr<TelemetryState> getState(MLIRContext *context) {
+  std::lock_guard<std::mutex> lock(tableMutex);
+  return getTable().lookup(context);
+}
+
+void mlir::torch::Torch::setTelemetryCallback(MLIRContext *context,
+                                              TelemetryCallback callback) {
+  std::lock_guard<std::mutex> lock(tableMutex);
+  if (!callback) {
+    getTable().erase(context);
+    return;
+  }
+  auto state = std::make_shared<TelemetryState>();
+  state->callback = std::move(callback);
+  getTable()[context] = std::move(state);
+}
+
+bool mlir::torch::Torch::isTelemetryEnabled(MLIRContext *context) {
+  return getState(context) != nullptr;
+}
+
+void mlir::torch::Torch::emitTelemetry(MLIRContext *context,
+                                       llvm::json::Object record) {
+  if (std::shared_ptr<TelemetryState> state = getState(context))
+    state->callback(record);
+}
+
+void mlir::torch::Torch::recordDecompositions(
+    MLIRContext *context, const llvm::StringMap<int64_t> &counts) {
+  std::shared_ptr<TelemetryState> state = getState(context);
+  if (!state)
+    return;
+  std::lock_guard<std::mutex> lock(state->mutex);
+  for (const auto &entry : counts)
+    if (entry.getValue() != 0)
+      state->decompositions[entry.getKey()] += entry.getValue();
+}
+
+llvm::StringMap<int64_t>
+mlir::torch::Torch::takeDecompositions(MLIRContext *context) {
+  std::shared_ptr<TelemetryState> state = getState(context);
+  if (!state)
+    return {};
+  std::lock_guard<std::mutex> lock(state->mutex);
+  return std::exchange(state->decompositions, {});
+}
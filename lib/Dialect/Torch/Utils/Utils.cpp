@@ -61,6 +61,10 @@ torch_upstream::ScalarType Torch::getScalarTypeForType(Type type) {
     return torch_upstream::ScalarType::Byte;
   if (type.isSignedInteger(8))
     return torch_upstream::ScalarType::Char;
+  if (type.isa<QInt8Type>())
+    return torch_upstream::ScalarType::QInt8;
+  if (type.isa<QUInt8Type>())
+    return torch_upstream::ScalarType::QUInt8;
   if (type.isa<ComplexType>()) {
     mlir::Type complexElemType = type.cast<ComplexType>().getElementType();
     if (complexElemType.isF32())
@@ -104,6 +108,10 @@ Type Torch::getTypeForScalarType(
   case torch_upstream::ScalarType::Byte:
   case torch_upstream::ScalarType::Char:
     return mlir::IntegerType::get(context, 8, signedness);
+  case torch_upstream::ScalarType::QInt8:
+    return QInt8Type::get(context);
+  case torch_upstream::ScalarType::QUInt8:
+    return QUInt8Type::get(context);
   case torch_upstream::ScalarType::ComplexHalf:
     return mlir::ComplexType::get(Float32Type::get(context));
   case torch_upstream::ScalarType::ComplexFloat:
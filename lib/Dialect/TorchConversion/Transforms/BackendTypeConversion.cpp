@@ -23,6 +23,11 @@ void mlir::torch::TorchConversion::getBackendTypeConversionDependentDialects(
 // Type conversion setup.
 //===----------------------------------------------------------------------===//
 
+static bool hasQuantizedDtype(Torch::ValueTensorType type) {
+  return type.hasDtype() &&
+         type.getDtype().isa<Torch::QInt8Type, Torch::QUInt8Type>();
+}
+
 static void
 setupValueTensorToBuiltinTensorConversion(ConversionTarget &target,
                                           TypeConverter &typeConverter) {
@@ -30,6 +35,9 @@ setupValueTensorToBuiltinTensorConversion(ConversionTarget &target,
                     TorchConversion::FromBuiltinTensorOp>();
   typeConverter.addConversion(
       [](Torch::ValueTensorType type) -> Optional<Type> {
+        // A null type fails the conversion rather than trying the next one.
+        if (hasQuantizedDtype(type))
+          return Type();
         return type.toBuiltinTensor();
       });
   typeConverter.addTargetMaterialization([](OpBuilder &builder, TensorType type,
@@ -166,3 +174,16 @@ void mlir::torch::TorchConversion::setupBackendTypeConversion(
   setupTorchFloatToF64Conversion(target, typeConverter);
   setupTorchGeneratorToI64Conversion(target, typeConverter);
 }
+
+void mlir::torch::TorchConversion::
+    setupQuantizedTensorToBuiltinTensorConversion(
+        TypeConverter &typeConverter) {
+  // Conversions are tried in reverse order of registration, so this takes
+  // precedence over the rejection of quantized tensors above.
+  typeConverter.addConversion(
+      [](Torch::ValueTensorType type) -> Optional<Type> {
+        if (!hasQuantizedDtype(type))
+          return std::nullopt;
+        return type.toBuiltinTensor();
+      });
+}
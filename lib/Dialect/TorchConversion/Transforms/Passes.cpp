@@ -42,7 +42,8 @@ namespace reg {
 
 void mlir::torch::registerTorchConversionPasses() {
   reg::registerPasses();
-  mlir::PassPipelineRegistration<>(
+  mlir::PassPipelineRegistration<
+      TorchConversion::LinalgOnTensorsBackendPipelineOptions>(
       "torch-backend-to-linalg-on-tensors-backend-pipeline",
       "Pipeline lowering torch backend contract to linalg-on-tensors backend "
       "contract.",
@@ -63,13 +64,14 @@ void mlir::torch::registerTorchConversionPasses() {
 }
 
 void TorchConversion::createTorchBackendToLinalgOnTensorsBackendPipeline(
-    OpPassManager &pm) {
+    OpPassManager &pm, const LinalgOnTensorsBackendPipelineOptions &options) {
   // Lower to linalg + guards which is the input to codegen backends.
   // We do this first as it tends to involve pattern-matching against constants,
   // (e.g. dimensions which must be constant in a ranked programming model)
   // and those constants get somewhat obscured by TorchToArith.
   pm.addNestedPass<func::FuncOp>(createConvertTorchToTMTensorPass());
-  pm.addNestedPass<func::FuncOp>(createConvertTorchToLinalgPass());
+  pm.addNestedPass<func::FuncOp>(
+      createConvertTorchToLinalgPass(options.useNhwcLayout));
   pm.addNestedPass<func::FuncOp>(createConvertTorchToSCFPass());
   pm.addNestedPass<func::FuncOp>(createConvertTorchToArithPass());
   pm.addNestedPass<func::FuncOp>(createConvertTorchConversionToMLProgramPass());
@@ -83,6 +85,13 @@ void TorchConversion::createTorchBackendToLinalgOnTensorsBackendPipeline(
       memref::createResolveShapedTypeResultDimsPass());
   // The resolution of `dim` ops tends to create identical ops. CSE them.
   pm.addNestedPass<func::FuncOp>(createCSEPass());
+  if (options.useNhwcLayout) {
+    // Cancel the NCHW<->NHWC transposes around convolutions and pooling ops,
+    // and fold the transposes of constant weights. This runs after
+    // TorchToArith so that weights are `arith.constant`s.
+    pm.addNestedPass<func::FuncOp>(createPropagateLinalgLayoutPass());
+    pm.addNestedPass<func::FuncOp>(createCanonicalizerPass());
+  }
 
   // Finish the type conversion from `torch` types to the types of the
   // linalg-on-tensors backend contract.
@@ -105,6 +114,9 @@ void TorchConversion::createTorchBackendToTosaBackendPipeline(
 
   // Clean up any non-canonical code introduced above..
   pm.addNestedPass<func::FuncOp>(createCanonicalizerPass());
+  // Cancel the NCHW<->NHWC transposes around convolutions and pooling ops.
+  pm.addNestedPass<func::FuncOp>(createPropagateTosaLayoutPass());
+  pm.addNestedPass<func::FuncOp>(createCanonicalizerPass());
   // The resolution of `dim` ops tends to create identical ops. CSE them.
   pm.addNestedPass<func::FuncOp>(createCSEPass());
 
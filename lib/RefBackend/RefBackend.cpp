@@ -16,6 +16,7 @@
 
 #include "PassDetail.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Arith/Utils/Utils.h"
 #include "mlir/Dialect/Bufferization/IR/Bufferization.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
@@ -24,6 +25,12 @@
 #include "mlir/Dialect/Math/Transforms/Approximation.h"
 #include "mlir/Dialect/Math/Transforms/Passes.h"
 #include "mlir/Dialect/MLProgram/IR/MLProgram.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/IR/Dominance.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/Interfaces/ViewLikeInterface.h"
 #include "mlir/Transforms/DialectConversion.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 #include "torch-mlir/Dialect/TorchConversion/IR/TorchConversionOps.h"
@@ -343,6 +350,61 @@ mlir::torch::RefBackend::createMLProgramBufferizePass() {
   return std::make_unique<MLProgramBufferize>();
 }
 
+//===----------------------------------------------------------------------===//
+// InsertRngStateArgument
+//===----------------------------------------------------------------------===//
+
+// The global created by `convert-torch-conversion-to-mlprogram` to hold the
+// state of the RNG.
+static constexpr StringRef getSeedGlobalVarName() { return "global_seed"; }
+
+namespace {
+class InsertRngStateArgument
+    : public InsertRngStateArgumentBase<InsertRngStateArgument> {
+  void runOnOperation() override {
+    auto module = getOperation();
+    auto seedGlobal =
+        module.lookupSymbol<memref::GlobalOp>(getSeedGlobalVarName());
+    if (!seedGlobal)
+      return;
+    auto stateType = seedGlobal.getType();
+
+    for (auto func : module.getOps<func::FuncOp>()) {
+      SmallVector<memref::GetGlobalOp> seedAccesses;
+      func.walk([&](memref::GetGlobalOp op) {
+        if (op.getName() == getSeedGlobalVarName())
+          seedAccesses.push_back(op);
+      });
+      if (func.isPrivate()) {
+        if (!seedAccesses.empty()) {
+          func.emitError("unimplemented: RNG state in a private function");
+          return signalPassFailure();
+        }
+        continue;
+      }
+      // Every public function takes the state, so that callers do not need
+      // to know which of them use the RNG.
+      unsigned stateIndex = func.getNumArguments();
+      func.insertArgument(stateIndex, stateType, /*argAttrs=*/{},
+                          seedGlobal.getLoc());
+      Value state = func.getArgument(stateIndex);
+      for (memref::GetGlobalOp op : seedAccesses) {
+        op.replaceAllUsesWith(state);
+        op.erase();
+      }
+    }
+
+    seedGlobal.erase();
+    module->setAttr("refback.rng_state", UnitAttr::get(&getContext()));
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<ModuleOp>>
+mlir::torch::RefBackend::createInsertRngStateArgumentPass() {
+  return std::make_unique<InsertRngStateArgument>();
+}
+
 //===----------------------------------------------------------------------===//
 // ExpandOpsForLLVM
 //===----------------------------------------------------------------------===//
@@ -430,6 +492,302 @@ mlir::torch::RefBackend::createMungeMemrefCopyPass() {
   return std::make_unique<MungeMemrefCopy>();
 }
 
+//===----------------------------------------------------------------------===//
+// FoldConvPadding
+//===----------------------------------------------------------------------===//
+
+namespace {
+// Splits a 2D convolution whose input is a zero `tensor.pad` of the spatial
+// dimensions, so that the padded copy of the input is never materialized:
+//
+// - The interior of the output, whose windows only read the unpadded input,
+//   is computed by the same named convolution on a slice of the unpadded
+//   input.
+// - The border strips around it are computed by a `linalg.generic` that reads
+//   the unpadded input with `tensor.extract`. Reads that fall in the padding
+//   (the halo) are clamped to a valid index and their value replaced by zero,
+//   so the loop nest stays branch-free.
+//
+// Each part is inserted into the output in place. Only static shapes and
+// padding are handled.
+//
+// The generic iterates in the same order as the named op:
+//   NCHW/FCHW: (n, f, oh, ow, c, kh, kw)
+//   NHWC/HWCF: (n, oh, ow, f, kh, kw, c)
+template <typename ConvOpTy>
+class FoldZeroPadIntoConv2D : public OpRewritePattern<ConvOpTy> {
+public:
+  using OpRewritePattern<ConvOpTy>::OpRewritePattern;
+  LogicalResult matchAndRewrite(ConvOpTy op,
+                                PatternRewriter &rewriter) const override {
+    constexpr bool isNhwc = std::is_same<ConvOpTy, linalg::Conv2DNhwcHwcfOp>();
+    constexpr int64_t nDim = 0, fDim = isNhwc ? 3 : 1, ohDim = isNhwc ? 1 : 2,
+                      owDim = isNhwc ? 2 : 3, cDim = isNhwc ? 6 : 4,
+                      khDim = isNhwc ? 4 : 5, kwDim = isNhwc ? 5 : 6;
+    // The input and the output have their spatial dimensions at the same
+    // positions.
+    constexpr int64_t hDim = isNhwc ? 1 : 2, wDim = isNhwc ? 2 : 3;
+    constexpr int64_t weightHDim = isNhwc ? 0 : 2, weightWDim = isNhwc ? 1 : 3;
+
+    if (!op.hasTensorSemantics())
+      return rewriter.notifyMatchFailure(op, "expected tensor semantics");
+    Value paddedInput = op.getDpsInputOperand(0)->get();
+    Value weight = op.getDpsInputOperand(1)->get();
+    Value init = op.getDpsInitOperand(0)->get();
+    auto pad = paddedInput.getDefiningOp<tensor::PadOp>();
+    if (!pad)
+      return rewriter.notifyMatchFailure(op, "input is not a tensor.pad");
+
+    Value padValue = pad.getConstantPaddingValue();
+    if (!padValue ||
+        !(matchPattern(padValue, m_AnyZeroFloat()) ||
+          matchPattern(padValue, m_Zero())))
+      return rewriter.notifyMatchFailure(op, "expected zero padding");
+
+    // Only the spatial dimensions may be padded, by constant amounts.
+    SmallVector<OpFoldResult> lowPadding = pad.getMixedLowPad();
+    SmallVector<OpFoldResult> highPadding = pad.getMixedHighPad();
+    for (int64_t dim = 0; dim < 4; ++dim) {
+      if (dim == hDim || dim == wDim)
+        continue;
+      if (!isConstantIntValue(lowPadding[dim], 0) ||
+          !isConstantIntValue(highPadding[dim], 0))
+        return rewriter.notifyMatchFailure(op, "non-spatial padding");
+    }
+    auto lowH = getConstantIntValue(lowPadding[hDim]);
+    auto lowW = getConstantIntValue(lowPadding[wDim]);
+    if (!lowH || !lowW)
+      return rewriter.notifyMatchFailure(op, "expected constant padding");
+
+    Value input = pad.getSource();
+    auto inputType = input.getType().cast<RankedTensorType>();
+    auto weightType = weight.getType().cast<RankedTensorType>();
+    auto initType = init.getType().cast<RankedTensorType>();
+    if (!inputType.hasStaticShape() || !weightType.hasStaticShape() ||
+        !initType.hasStaticShape())
+      return rewriter.notifyMatchFailure(op, "expected static shapes");
+    Type elementType = initType.getElementType();
+    if (inputType.getElementType() != elementType ||
+        weightType.getElementType() != elementType)
+      return rewriter.notifyMatchFailure(op, "mixed element types");
+    bool isFloat = elementType.isa<FloatType>();
+    if (!isFloat && !elementType.isa<IntegerType>())
+      return rewriter.notifyMatchFailure(op, "unsupported element type");
+
+    SmallVector<int64_t> strides =
+        llvm::to_vector(op.getStrides().template getValues<int64_t>());
+    SmallVector<int64_t> dilations =
+        llvm::to_vector(op.getDilations().template getValues<int64_t>());
+
+    // Returns the range [begin, end) of output positions along a spatial
+    // dimension whose windows only read the unpadded input.
+    auto getInteriorRange = [](int64_t low, int64_t inputSize,
+                               int64_t kernelSize, int64_t outputSize,
+                               int64_t stride, int64_t dilation) {
+      int64_t begin = llvm::divideCeil(low, stride);
+      int64_t lastStart = inputSize - 1 - (kernelSize - 1) * dilation + low;
+      int64_t end = lastStart < 0 ? 0 : lastStart / stride + 1;
+      end = std::min(end, outputSize);
+      return std::make_pair(std::min(begin, end), end);
+    };
+    ArrayRef<int64_t> outputShape = initType.getShape();
+    auto [beginH, endH] = getInteriorRange(
+        *lowH, inputType.getDimSize(hDim), weightType.getDimSize(weightHDim),
+        outputShape[hDim], strides[0], dilations[0]);
+    auto [beginW, endW] = getInteriorRange(
+        *lowW, inputType.getDimSize(wDim), weightType.getDimSize(weightWDim),
+        outputShape[wDim], strides[1], dilations[1]);
+
+    Location loc = op.getLoc();
+    MLIRContext *context = op.getContext();
+
+    // Returns the offsets, sizes and strides of the slice of `shape` that
+    // covers [offsetH, offsetH + sizeH) x [offsetW, offsetW + sizeW) in the
+    // spatial dimensions, and everything in the others.
+    struct Slice {
+      SmallVector<OpFoldResult> offsets, sizes, strides;
+    };
+    auto getSpatialSlice = [&](ArrayRef<int64_t> shape, int64_t offsetH,
+                               int64_t sizeH, int64_t offsetW, int64_t sizeW) {
+      Slice slice;
+      for (int64_t dim = 0; dim < 4; ++dim) {
+        int64_t offset = 0, size = shape[dim];
+        if (dim == hDim) {
+          offset = offsetH;
+          size = sizeH;
+        } else if (dim == wDim) {
+          offset = offsetW;
+          size = sizeW;
+        }
+        slice.offsets.push_back(rewriter.getIndexAttr(offset));
+        slice.sizes.push_back(rewriter.getIndexAttr(size));
+        slice.strides.push_back(rewriter.getIndexAttr(1));
+      }
+      return slice;
+    };
+
+    Value result = init;
+    int64_t interiorH = endH - beginH, interiorW = endW - beginW;
+    if (interiorH > 0 && interiorW > 0) {
+      Slice inputSlice = getSpatialSlice(
+          inputType.getShape(), beginH * strides[0] - *lowH,
+          (interiorH - 1) * strides[0] +
+              (weightType.getDimSize(weightHDim) - 1) * dilations[0] + 1,
+          beginW * strides[1] - *lowW,
+          (interiorW - 1) * strides[1] +
+              (weightType.getDimSize(weightWDim) - 1) * dilations[1] + 1);
+      Slice outputSlice =
+          getSpatialSlice(outputShape, beginH, interiorH, beginW, interiorW);
+      Value interiorInput = rewriter.create<tensor::ExtractSliceOp>(
+          loc, input, inputSlice.offsets, inputSlice.sizes,
+          inputSlice.strides);
+      Value interiorInit = rewriter.create<tensor::ExtractSliceOp>(
+          loc, result, outputSlice.offsets, outputSlice.sizes,
+          outputSlice.strides);
+      Value interior =
+          rewriter
+              .create<ConvOpTy>(loc, interiorInit.getType(),
+                                ValueRange{interiorInput, weight},
+                                interiorInit, op.getStrides(),
+                                op.getDilations())
+              .getResult(0);
+      result = rewriter.create<tensor::InsertSliceOp>(
+          loc, interior, result, outputSlice.offsets, outputSlice.sizes,
+          outputSlice.strides);
+    }
+
+    auto d = [&](int64_t dim) { return rewriter.getAffineDimExpr(dim); };
+    SmallVector<AffineExpr> weightExprs =
+        isNhwc ? SmallVector<AffineExpr>{d(khDim), d(kwDim), d(cDim), d(fDim)}
+               : SmallVector<AffineExpr>{d(fDim), d(cDim), d(khDim), d(kwDim)};
+    SmallVector<AffineExpr> outputExprs =
+        isNhwc ? SmallVector<AffineExpr>{d(nDim), d(ohDim), d(owDim), d(fDim)}
+               : SmallVector<AffineExpr>{d(nDim), d(fDim), d(ohDim), d(owDim)};
+    SmallVector<AffineMap> indexingMaps = {
+        AffineMap::get(7, 0, weightExprs, context),
+        AffineMap::get(7, 0, outputExprs, context)};
+    SmallVector<utils::IteratorType> iteratorTypes(
+        4, utils::IteratorType::parallel);
+    iteratorTypes.append(3, utils::IteratorType::reduction);
+
+    Value inputH = rewriter.create<arith::ConstantIndexOp>(
+        loc, inputType.getDimSize(hDim));
+    Value inputW = rewriter.create<arith::ConstantIndexOp>(
+        loc, inputType.getDimSize(wDim));
+    Value zeroIndex = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+    Value zero = rewriter.create<arith::ConstantOp>(
+        loc, rewriter.getZeroAttr(elementType));
+
+    // Returns `(out + offset) * stride + k * dilation - low` and whether it
+    // is in [0, size).
+    auto inputIndex = [&](OpBuilder &b, Location loc, int64_t outDim,
+                          int64_t offset, int64_t kDim, int64_t stride,
+                          int64_t dilation, int64_t low,
+                          Value size) -> std::pair<Value, Value> {
+      Value out = b.create<linalg::IndexOp>(loc, outDim);
+      Value k = b.create<linalg::IndexOp>(loc, kDim);
+      Value idx = b.create<arith::AddIOp>(
+          loc,
+          b.create<arith::MulIOp>(
+              loc, out, b.create<arith::ConstantIndexOp>(loc, stride)),
+          b.create<arith::MulIOp>(
+              loc, k, b.create<arith::ConstantIndexOp>(loc, dilation)));
+      idx = b.create<arith::AddIOp>(
+          loc, idx,
+          b.create<arith::ConstantIndexOp>(loc, offset * stride - low));
+      Value inBounds = b.create<arith::AndIOp>(
+          loc,
+          b.create<arith::CmpIOp>(loc, arith::CmpIPredicate::sge, idx,
+                                  zeroIndex),
+          b.create<arith::CmpIOp>(loc, arith::CmpIPredicate::slt, idx, size));
+      return {idx, inBounds};
+    };
+
+    // Computes the output positions in [offsetH, offsetH + sizeH) x
+    // [offsetW, offsetW + sizeW) with bounds-checked reads of the input.
+    auto computeBorder = [&](int64_t offsetH, int64_t sizeH, int64_t offsetW,
+                             int64_t sizeW) {
+      if (sizeH <= 0 || sizeW <= 0)
+        return;
+      Slice outputSlice =
+          getSpatialSlice(outputShape, offsetH, sizeH, offsetW, sizeW);
+      Value borderInit = rewriter.create<tensor::ExtractSliceOp>(
+          loc, result, outputSlice.offsets, outputSlice.sizes,
+          outputSlice.strides);
+      auto border = rewriter.create<linalg::GenericOp>(
+          loc, borderInit.getType(), weight, borderInit, indexingMaps,
+          iteratorTypes, [&](OpBuilder &b, Location loc, ValueRange args) {
+            auto [ih, hInBounds] =
+                inputIndex(b, loc, ohDim, offsetH, khDim, strides[0],
+                           dilations[0], *lowH, inputH);
+            auto [iw, wInBounds] =
+                inputIndex(b, loc, owDim, offsetW, kwDim, strides[1],
+                           dilations[1], *lowW, inputW);
+            Value inBounds =
+                b.create<arith::AndIOp>(loc, hInBounds, wInBounds);
+            ih = b.create<arith::SelectOp>(loc, inBounds, ih, zeroIndex);
+            iw = b.create<arith::SelectOp>(loc, inBounds, iw, zeroIndex);
+            Value n = b.create<linalg::IndexOp>(loc, nDim);
+            Value c = b.create<linalg::IndexOp>(loc, cDim);
+            SmallVector<Value> indices =
+                isNhwc ? SmallVector<Value>{n, ih, iw, c}
+                       : SmallVector<Value>{n, c, ih, iw};
+            Value x = b.create<tensor::ExtractOp>(loc, input, indices);
+            x = b.create<arith::SelectOp>(loc, inBounds, x, zero);
+            Value sum;
+            if (isFloat) {
+              Value product = b.create<arith::MulFOp>(loc, x, args[0]);
+              sum = b.create<arith::AddFOp>(loc, args[1], product);
+            } else {
+              Value product = b.create<arith::MulIOp>(loc, x, args[0]);
+              sum = b.create<arith::AddIOp>(loc, args[1], product);
+            }
+            b.create<linalg::YieldOp>(loc, sum);
+          });
+      result = rewriter.create<tensor::InsertSliceOp>(
+          loc, border.getResult(0), result, outputSlice.offsets,
+          outputSlice.sizes, outputSlice.strides);
+    };
+
+    int64_t outputH = outputShape[hDim], outputW = outputShape[wDim];
+    if (interiorH > 0 && interiorW > 0) {
+      // Top and bottom rows, then the left and right columns between them.
+      computeBorder(0, beginH, 0, outputW);
+      computeBorder(endH, outputH - endH, 0, outputW);
+      computeBorder(beginH, interiorH, 0, beginW);
+      computeBorder(beginH, interiorH, endW, outputW - endW);
+    } else {
+      computeBorder(0, outputH, 0, outputW);
+    }
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+};
+
+class FoldConvPadding : public FoldConvPaddingBase<FoldConvPadding> {
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<linalg::LinalgDialect>();
+    registry.insert<tensor::TensorDialect>();
+  }
+
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+    RewritePatternSet patterns(context);
+    patterns.insert<FoldZeroPadIntoConv2D<linalg::Conv2DNchwFchwOp>,
+                    FoldZeroPadIntoConv2D<linalg::Conv2DNhwcHwcfOp>>(context);
+    if (failed(applyPatternsAndFoldGreedily(getOperation(),
+                                            std::move(patterns)))) {
+      return signalPassFailure();
+    }
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::torch::RefBackend::createFoldConvPaddingPass() {
+  return std::make_unique<FoldConvPadding>();
+}
+
 namespace {
 class GeneralizeTensorPad
     : public GeneralizeTensorPadBase<GeneralizeTensorPad> {
@@ -453,3 +811,173 @@ std::unique_ptr<OperationPass<func::FuncOp>>
 mlir::torch::RefBackend::createGeneralizeTensorPadPass() {
   return std::make_unique<GeneralizeTensorPad>();
 }
+
+//===----------------------------------------------------------------------===//
+// ElideInsertSliceCopies
+//===----------------------------------------------------------------------===//
+
+// Collects the ops accessing `buffer`, looking through all the views of it.
+// Fails if an op that is not a view may return an alias of `buffer`, since
+// the accesses through that alias cannot be tracked.
+static LogicalResult collectAccesses(Value buffer,
+                                     SmallVectorImpl<Operation *> &accesses) {
+  for (Operation *user : buffer.getUsers()) {
+    if (isa<ViewLikeOpInterface>(user)) {
+      for (Value view : user->getResults()) {
+        if (failed(collectAccesses(view, accesses)))
+          return failure();
+      }
+      continue;
+    }
+    if (llvm::any_of(user->getResultTypes(),
+                     [](Type type) { return type.isa<BaseMemRefType>(); }))
+      return failure();
+    accesses.push_back(user);
+  }
+  return success();
+}
+
+// Rewrites
+//   memref.copy %src, %dst
+// where %src and %dst are allocations, %src is not accessed after the copy
+// and %dst is not accessed before it, by replacing %dst with %src. Partial
+// bufferization copies the destination of each `tensor.insert_slice` into a
+// new buffer, so this turns a chain of insertions back into a single buffer.
+static bool forwardCopyToFreshAlloc(memref::CopyOp copy) {
+  auto srcAlloc = copy.getSource().getDefiningOp<memref::AllocOp>();
+  auto dstAlloc = copy.getTarget().getDefiningOp<memref::AllocOp>();
+  if (!srcAlloc || !dstAlloc || srcAlloc.getType() != dstAlloc.getType())
+    return false;
+  Block *block = copy->getBlock();
+  if (srcAlloc->getBlock() != block || dstAlloc->getBlock() != block)
+    return false;
+
+  SmallVector<Operation *> srcAccesses;
+  if (failed(collectAccesses(srcAlloc, srcAccesses)))
+    return false;
+  for (Operation *access : srcAccesses) {
+    Operation *ancestor = block->findAncestorOpInBlock(*access);
+    if (!ancestor || (ancestor != copy && !ancestor->isBeforeInBlock(copy)))
+      return false;
+  }
+  SmallVector<Operation *> dstAccesses;
+  if (failed(collectAccesses(dstAlloc, dstAccesses)))
+    return false;
+  for (Operation *access : dstAccesses) {
+    Operation *ancestor = block->findAncestorOpInBlock(*access);
+    if (!ancestor || (ancestor != copy && !copy->isBeforeInBlock(ancestor)))
+      return false;
+  }
+  // The uses of %dst have to be dominated by %src once it replaces %dst.
+  for (Operation *user : dstAlloc->getUsers()) {
+    Operation *ancestor = block->findAncestorOpInBlock(*user);
+    if (!ancestor || !srcAlloc->isBeforeInBlock(ancestor))
+      return false;
+  }
+
+  copy.erase();
+  dstAlloc.replaceAllUsesWith(srcAlloc.getResult());
+  dstAlloc.erase();
+  return true;
+}
+
+// Rewrites
+//   %src = memref.alloc
+//   <linalg ops computing %src>
+//   %view = memref.subview %base
+//   memref.copy %src, %view
+// so that the linalg ops write into %view directly, hoisting %base and %view
+// above them. This requires %src to only be used by linalg ops (and the
+// copies initializing it) before the copy, and %base to not be accessed
+// while those ops run, since their writes to it are moved earlier.
+static bool forwardProducerIntoSubview(memref::CopyOp copy,
+                                       DominanceInfo &domInfo) {
+  auto srcAlloc = copy.getSource().getDefiningOp<memref::AllocOp>();
+  auto subView = copy.getTarget().getDefiningOp<memref::SubViewOp>();
+  if (!srcAlloc || !subView || !subView->hasOneUse())
+    return false;
+  auto baseAlloc = subView.getSource().getDefiningOp<memref::AllocOp>();
+  if (!baseAlloc)
+    return false;
+  Block *block = copy->getBlock();
+  if (srcAlloc->getBlock() != block || subView->getBlock() != block ||
+      baseAlloc->getBlock() != block)
+    return false;
+
+  Operation *firstAccess = copy;
+  for (OpOperand &use : srcAlloc->getUses()) {
+    Operation *user = use.getOwner();
+    if (user == copy)
+      continue;
+    auto userCopy = dyn_cast<memref::CopyOp>(user);
+    bool isInitialization = userCopy && userCopy.getTarget() == use.get();
+    if (!isa<linalg::LinalgOp, memref::DimOp>(user) && !isInitialization)
+      return false;
+    Operation *ancestor = block->findAncestorOpInBlock(*user);
+    if (!ancestor || !ancestor->isBeforeInBlock(copy))
+      return false;
+    if (ancestor->isBeforeInBlock(firstAccess))
+      firstAccess = ancestor;
+  }
+  if (firstAccess == copy)
+    return false;
+
+  SmallVector<Operation *> baseAccesses;
+  if (failed(collectAccesses(baseAlloc, baseAccesses)))
+    return false;
+  for (Operation *access : baseAccesses) {
+    if (access == copy)
+      continue;
+    Operation *ancestor = block->findAncestorOpInBlock(*access);
+    if (!ancestor)
+      return false;
+    if (!ancestor->isBeforeInBlock(firstAccess) &&
+        ancestor->isBeforeInBlock(copy))
+      return false;
+  }
+
+  auto dominatesFirstAccess = [&](Value value) {
+    return domInfo.properlyDominates(value, firstAccess);
+  };
+  bool hoistBase = !baseAlloc->isBeforeInBlock(firstAccess);
+  if (hoistBase &&
+      !llvm::all_of(baseAlloc->getOperands(), dominatesFirstAccess))
+    return false;
+  for (Value operand : subView->getOperands()) {
+    if (operand != subView.getSource() && !dominatesFirstAccess(operand))
+      return false;
+  }
+
+  if (hoistBase)
+    baseAlloc->moveBefore(firstAccess);
+  if (!subView->isBeforeInBlock(firstAccess))
+    subView->moveBefore(firstAccess);
+  copy.erase();
+  srcAlloc.replaceAllUsesWith(subView.getResult());
+  srcAlloc.erase();
+  return true;
+}
+
+namespace {
+class ElideInsertSliceCopies
+    : public ElideInsertSliceCopiesBase<ElideInsertSliceCopies> {
+  void runOnOperation() override {
+    SmallVector<memref::CopyOp> copies;
+    getOperation().walk([&](memref::CopyOp copy) { copies.push_back(copy); });
+
+    SmallVector<memref::CopyOp> remainingCopies;
+    for (memref::CopyOp copy : copies) {
+      if (!forwardCopyToFreshAlloc(copy))
+        remainingCopies.push_back(copy);
+    }
+    DominanceInfo &domInfo = getAnalysis<DominanceInfo>();
+    for (memref::CopyOp copy : remainingCopies)
+      forwardProducerIntoSubview(copy, domInfo);
+  }
+};
+} // namespace
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::torch::RefBackend::createElideInsertSliceCopiesPass() {
+  return std::make_unique<ElideInsertSliceCopies>();
+}
@@ -10,9 +10,81 @@
 #include "mlir/Bindings/Python/PybindAdaptors.h"
 #include "torch-mlir-c/Dialects.h"
 #include "torch-mlir-c/Registration.h"
+#include "torch-mlir-c/Telemetry.h"
+#include "torch-mlir-c/Threading.h"
+
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 namespace py = pybind11;
 
+namespace {
+/// Collects the chunks produced by the C API printing callbacks, which can be
+/// as small as a single token, and writes them to a file descriptor in large
+/// blocks.
+class FileDescriptorWriter {
+public:
+  explicit FileDescriptorWriter(int fd) : fd(fd) { buffer.reserve(kBlockSize); }
+
+  static void callback(MlirStringRef part, void *userData) {
+    static_cast<FileDescriptorWriter *>(userData)->append(part.data,
+                                                          part.length);
+  }
+
+  void append(const char *data, size_t length) {
+    if (length >= kBlockSize) {
+      flush();
+      writeAll(data, length);
+      return;
+    }
+    if (buffer.size() + length > kBlockSize)
+      flush();
+    buffer.append(data, length);
+  }
+
+  void flush() {
+    writeAll(buffer.data(), buffer.size());
+    buffer.clear();
+  }
+
+  /// The `errno` of the first failed write, or 0. Writes after a failure are
+  /// dropped, since the callbacks have no way to abort printing.
+  int error = 0;
+
+private:
+  void writeAll(const char *data, size_t length) {
+    while (length != 0 && error == 0) {
+#ifdef _WIN32
+      auto written = ::_write(fd, data, static_cast<unsigned>(length));
+#else
+      auto written = ::write(fd, data, length);
+#endif
+      if (written < 0) {
+        if (errno != EINTR)
+          error = errno;
+        continue;
+      }
+      data += written;
+      length -= written;
+    }
+  }
+
+  static constexpr size_t kBlockSize = 1 << 20;
+  int fd;
+  std::string buffer;
+};
+} // namespace
+
 PYBIND11_MODULE(_torchMlir, m) {
   torchMlirRegisterAllPasses();
 
@@ -28,4 +100,83 @@ PYBIND11_MODULE(_torchMlir, m) {
         }
       },
       py::arg("context"), py::arg("load") = true);
+
+  m.def(
+      "set_context_num_threads",
+      [](MlirContext context, intptr_t numThreads) {
+        torchMlirContextSetNumThreads(context, numThreads);
+      },
+      py::arg("context"), py::arg("num_threads"),
+      "Sets the number of threads that passes run on in `context`. 1 disables "
+      "multithreading and 0 uses all the hardware threads.");
+
+  m.def(
+      "set_context_telemetry_callback",
+      [](MlirContext context, py::object callback) {
+        // Keeps the Python callbacks alive while they are set.
+        static auto *callbacks =
+            new std::unordered_map<void *, std::unique_ptr<py::object>>();
+        if (callback.is_none()) {
+          torchMlirContextSetTelemetryCallback(context, nullptr, nullptr);
+          callbacks->erase(context.ptr);
+          return;
+        }
+        auto stored = std::make_unique<py::object>(std::move(callback));
+        torchMlirContextSetTelemetryCallback(
+            context,
+            [](MlirStringRef record, void *userData) {
+              py::gil_scoped_acquire acquire;
+              try {
+                (*static_cast<py::object *>(userData))(
+                    py::str(record.data, record.length));
+              } catch (py::error_already_set &e) {
+                // Exceptions must not unwind through the passes.
+                e.discard_as_unraisable("telemetry callback");
+              }
+            },
+            stored.get());
+        (*callbacks)[context.ptr] = std::move(stored);
+      },
+      py::arg("context"), py::arg("callback"),
+      "Sets the function that receives the telemetry records of the passes "
+      "that run in `context`, as JSON strings, or disables telemetry if "
+      "`callback` is None.");
+
+  m.def(
+      "write_operation",
+      [](MlirOperation operation, int fd, bool bytecode,
+         intptr_t largeElementsLimit, bool enableDebugInfo) {
+        FileDescriptorWriter writer(fd);
+        {
+          // Printing a large module takes a while and only touches MLIR.
+          py::gil_scoped_release release;
+          if (bytecode) {
+            mlirOperationWriteBytecode(operation,
+                                       FileDescriptorWriter::callback,
+                                       &writer);
+          } else {
+            MlirOpPrintingFlags flags = mlirOpPrintingFlagsCreate();
+            if (largeElementsLimit >= 0)
+              mlirOpPrintingFlagsElideLargeElementsAttrs(flags,
+                                                         largeElementsLimit);
+            mlirOpPrintingFlagsEnableDebugInfo(flags, enableDebugInfo,
+                                               /*prettyForm=*/false);
+            mlirOperationPrintWithFlags(operation, flags,
+                                        FileDescriptorWriter::callback,
+                                        &writer);
+            mlirOpPrintingFlagsDestroy(flags);
+          }
+          writer.flush();
+        }
+        if (writer.error != 0)
+          throw std::runtime_error(std::string("Failed to write operation: ") +
+                                   std::strerror(writer.error));
+      },
+      py::arg("operation"), py::arg("fd"), py::arg("bytecode") = false,
+      py::arg("large_elements_limit") = -1,
+      py::arg("enable_debug_info") = false,
+      "Writes `operation` to the file descriptor `fd` as it is printed, "
+      "without building its textual or bytecode form in memory. Elements "
+      "attributes with more than `large_elements_limit` elements are elided "
+      "from textual output if it is not negative.");
 }
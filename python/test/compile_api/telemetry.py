@@ -0,0 +1,44 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+import torch
+import torch_mlir
+
+
+class SoftmaxModule(torch.nn.Module):
+    def forward(self, x):
+        return torch.ops.aten.softmax(x, 1)
+
+
+records = []
+torch_mlir.compile(SoftmaxModule(), torch.ones(2, 3),
+                   telemetry_callback=records.append)
+
+iterations = [r for r in records
+              if r["event"] == "lower_to_backend_contract_iteration"]
+summary = [r for r in records if r["event"] == "lower_to_backend_contract"]
+
+print(len(summary), summary[0]["iterations"] == len(iterations))
+# CHECK: 1 True
+print(summary[0]["satisfies_backend_contract"],
+      iterations[-1]["satisfies_backend_contract"])
+# CHECK: True True
+print(sorted(iterations[0]["stage_seconds"]))
+# CHECK: ['cleanup', 'decompose', 'dtype-refinement', 'shape-refinement']
+print(all(r["contract_check_seconds"] >= 0 for r in iterations))
+# CHECK: True
+print(sum(r["decompositions"].get("torch.aten.softmax.int", 0)
+          for r in iterations))
+# CHECK: 1
+print(iterations[-1]["unresolved_shapes"], iterations[-1]["unresolved_dtypes"])
+# CHECK: 0 0
+
+# Telemetry is disabled again after `compile`, and not collected by default.
+records.clear()
+torch_mlir.compile(SoftmaxModule(), torch.ones(2, 3))
+print(records)
+# CHECK: []
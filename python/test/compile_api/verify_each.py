@@ -0,0 +1,28 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+import torch
+import torch_mlir
+
+
+class TanhModule(torch.nn.Module):
+    def forward(self, x):
+        return torch.ops.aten.tanh(x)
+
+
+# Skipping the verification of intermediate steps gives the same result.
+for output_type in ["torch", "linalg-on-tensors", "tosa", "mhlo"]:
+    verified = torch_mlir.compile(TanhModule(), torch.ones(2, 3),
+                                  output_type=output_type)
+    unverified = torch_mlir.compile(TanhModule(), torch.ones(2, 3),
+                                    output_type=output_type,
+                                    verify_each=False)
+    print(output_type, str(verified) == str(unverified))
+# CHECK: torch True
+# CHECK: linalg-on-tensors True
+# CHECK: tosa True
+# CHECK: mhlo True
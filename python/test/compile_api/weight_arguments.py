@@ -0,0 +1,108 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+import torch
+
+from torch_mlir import OutputType
+from torch_mlir.incremental import (
+    WeightArgumentsCache,
+    _CacheEntry,
+    compile_with_weight_arguments,
+    compute_structure_key,
+)
+
+
+class LinearModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+        self.linear = torch.nn.Linear(3, 4)
+
+    def forward(self, x):
+        return self.linear(x)
+
+
+num_compiles = 0
+
+
+def count_compiles(module):
+    global num_compiles
+    num_compiles += 1
+    return module
+
+
+cache = WeightArgumentsCache()
+program = compile_with_weight_arguments(LinearModule(), torch.ones(2, 3),
+                                        "torch", cache, count_compiles)
+print(program.weight_names)
+# CHECK: ['linear.weight', 'linear.bias']
+print(program.artifact)
+# CHECK-LABEL: module attributes
+# CHECK-SAME:    torch.weight_arguments = {forward = ["linear.weight", "linear.bias"]}
+# CHECK:       func.func @forward(%{{.*}}: !torch.vtensor<[2,3],f32>, %{{.*}}: !torch.vtensor<[4,3],f32>, %{{.*}}: !torch.vtensor<[4],f32>) -> !torch.vtensor<[2,4],f32>
+# CHECK-NOT:     torch.vtensor.literal
+# CHECK:         torch.aten.linear
+
+# Different weights reuse the compiled program.
+other = LinearModule()
+with torch.no_grad():
+    other.linear.weight.fill_(1.0)
+other_program = compile_with_weight_arguments(other, torch.ones(2, 3),
+                                              "torch", cache, count_compiles)
+print(num_compiles, other_program.key == program.key,
+      bool(torch.all(other_program.weights[0] == 1.0)))
+# CHECK: 1 True True
+
+# A different structure is compiled again.
+compile_with_weight_arguments(torch.nn.Sequential(LinearModule(),
+                                                  torch.nn.ReLU()),
+                              torch.ones(2, 3), "torch", cache, count_compiles)
+print(num_compiles, len(cache))
+# CHECK: 2 2
+
+# Compile options are part of the key.
+compile_with_weight_arguments(LinearModule(), torch.ones(2, 3), "torch", cache,
+                              count_compiles, use_tracing=True)
+print(num_compiles, len(cache))
+# CHECK: 3 3
+
+# Plain Python attributes that `forward` reads are part of the key.
+class ScaledLinearModule(LinearModule):
+    def __init__(self, scale):
+        super().__init__()
+        self.scale = scale
+
+    def forward(self, x):
+        return self.linear(x) * self.scale
+
+
+for scale in (2.0, 3.0, 2.0):
+    compile_with_weight_arguments(ScaledLinearModule(scale), torch.ones(2, 3),
+                                  "torch", cache, count_compiles)
+print(num_compiles, len(cache))
+# CHECK: 5 5
+
+# An entry whose program embeds a weight is only reused while that weight
+# keeps its value.
+model = LinearModule()
+key = compute_structure_key(model, [torch.ones(2, 3)], OutputType.TORCH)
+cache.put(
+    key,
+    _CacheEntry(artifact=program.artifact,
+                weight_names=["linear.weight"],
+                embedded_weights={
+                    "linear.bias": model.linear.bias.detach().clone()
+                }))
+hit = compile_with_weight_arguments(model, torch.ones(2, 3), "torch", cache,
+                                    count_compiles)
+print(num_compiles, hit.weight_names)
+# CHECK: 5 ['linear.weight']
+with torch.no_grad():
+    model.linear.bias.add_(1.0)
+miss = compile_with_weight_arguments(model, torch.ones(2, 3), "torch", cache,
+                                     count_compiles)
+print(num_compiles, miss.weight_names)
+# CHECK: 6 ['linear.weight', 'linear.bias']
@@ -0,0 +1,36 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+import torch
+import torch_mlir
+
+
+class LinearModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+        self.linear = torch.nn.Linear(64, 32)
+
+    def forward(self, x):
+        return self.linear(x)
+
+
+# The weight has 2048 elements and becomes an argument. The bias has only 32,
+# so it is still a literal.
+print(torch_mlir.compile(LinearModule(), torch.ones(4, 64),
+                         weights_as_arguments=True))
+# CHECK-LABEL: module attributes
+# CHECK-SAME:    torch.weight_arguments = {forward = ["linear.weight"]}
+# CHECK:       func.func @forward(%{{.*}}: !torch.vtensor<[4,64],f32>, %{{.*}}: !torch.vtensor<[32,64],f32>) -> !torch.vtensor<[4,32],f32>
+# CHECK:         torch.vtensor.literal({{.*}} : tensor<32xf32>)
+# CHECK-NOT:     tensor<32x64xf32>
+
+print(torch_mlir.compile(LinearModule(), torch.ones(4, 64),
+                         weights_as_arguments=True,
+                         weights_as_arguments_min_elements=1))
+# CHECK-LABEL: module attributes
+# CHECK-SAME:    torch.weight_arguments = {forward = ["linear.weight", "linear.bias"]}
+# CHECK:       func.func @forward(%{{.*}}: !torch.vtensor<[4,64],f32>, %{{.*}}: !torch.vtensor<[32,64],f32>, %{{.*}}: !torch.vtensor<[32],f32>) -> !torch.vtensor<[4,32],f32>
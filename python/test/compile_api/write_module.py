@@ -0,0 +1,57 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+import os
+import tempfile
+
+import torch
+import torch_mlir
+from torch_mlir.ir import Module
+
+
+class LinearModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+        self.linear = torch.nn.Linear(64, 32)
+
+    def forward(self, x):
+        return self.linear(x)
+
+
+module = torch_mlir.compile(LinearModule(), torch.ones(4, 64))
+
+with tempfile.TemporaryDirectory() as directory:
+    path = os.path.join(directory, "module.mlir")
+
+    # The streamed text is the same as `str(module)`.
+    torch_mlir.write_module(module, path)
+    with open(path) as f:
+        print(f.read() == str(module))
+    # CHECK: True
+
+    # Elided weights.
+    with open(path, "wb") as f:
+        torch_mlir.write_module(module, f, large_elements_limit=16)
+    with open(path) as f:
+        print(f.read())
+    # CHECK: torch.vtensor.literal(dense_resource<__elided__> : tensor<32x64xf32>)
+
+    # Bytecode, written to a file descriptor.
+    fd = os.open(path, os.O_WRONLY | os.O_TRUNC)
+    torch_mlir.write_module(module, fd, bytecode=True)
+    os.close(fd)
+    with open(path, "rb") as f:
+        reparsed = Module.parse(f.read(), context=module.context)
+    print(str(reparsed) == str(module))
+    # CHECK: True
+
+try:
+    torch_mlir.write_module(module, os.devnull, bytecode=True,
+                            large_elements_limit=16)
+except Exception as e:
+    print(e)
+# CHECK: `large_elements_limit` is only supported for textual IR
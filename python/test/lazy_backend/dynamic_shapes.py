@@ -0,0 +1,47 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: env LTC_ENABLE_DYNAMIC_SHAPES=1 %PYTHON %s | FileCheck %s
+
+
+import torch
+import torch._lazy
+import torch._lazy.metrics
+
+import torch_mlir._mlir_libs._REFERENCE_LAZY_BACKEND as lazy_backend
+
+from run_test import run_test
+
+lazy_backend._initialize()
+
+device = "lazy"
+
+
+# CHECK: Compiles: 1
+# -----
+# CHECK: PASS - test_two_batch_sizes_compile_once
+@run_test
+def test_two_batch_sizes_compile_once():
+    torch._lazy.metrics.reset()
+    for batch_size in (2, 3):
+        x = torch.rand(batch_size, 5).to(device)
+        y = torch.tanh(x) * x
+        torch._lazy.mark_step()
+    print("Compiles:", torch._lazy.metrics.counter_value("UncachedCompile"))
+
+
+# Sizes that were already seen are not counted again.
+# CHECK: Recompiles avoided: 2
+# -----
+# CHECK: PASS - test_varying_batch_size
+@run_test
+def test_varying_batch_size():
+    torch._lazy.metrics.reset()
+    for batch_size in (2, 3, 2, 4, 3):
+        x = torch.rand(batch_size, 5).to(device)
+        y = torch.tanh(x) + x
+        torch._lazy.mark_step()
+    print("Recompiles avoided:",
+          torch._lazy.metrics.counter_value("TorchMlirRecompilesAvoided"))
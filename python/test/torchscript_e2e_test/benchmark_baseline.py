@@ -0,0 +1,44 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# RUN: %PYTHON %s | FileCheck %s
+
+from torch_mlir_e2e_test.benchmarking import (
+    BenchmarkResult,
+    benchmark_results_to_json,
+    report_benchmarks,
+)
+
+
+def make_results(steady_state_times, warmup=3):
+    result = BenchmarkResult(unique_name="Test_basic",
+                             error=None,
+                             compile_time=1.0,
+                             first_call_time=0.1,
+                             steady_state_times=steady_state_times)
+    return benchmark_results_to_json([result], "torchscript", warmup,
+                                     len(steady_state_times))
+
+
+baseline = make_results([1.0, 1.0, 1.0, 1.0, 1.0])
+
+# A 20% slower median, beyond the spread of both runs, is a regression.
+# CHECK: Found 1 regressions
+# CHECK: Test_basic: steady_state_median x1.20
+# CHECK: failed True
+print("failed",
+      report_benchmarks(make_results([1.2, 1.2, 1.2, 1.2, 1.2]), baseline))
+
+# The same median with a spread that covers the slowdown is not.
+# CHECK: Found 0 regressions
+# CHECK: failed False
+print("failed",
+      report_benchmarks(make_results([0.9, 1.0, 1.2, 1.5, 1.6]), baseline))
+
+# Results with different settings are not compared.
+# CHECK: ERROR: the baseline was recorded with different settings: warmup 3 (now 0)
+# CHECK: failed True
+print("failed",
+      report_benchmarks(make_results([1.0] * 5, warmup=0), baseline))
@@ -3,7 +3,7 @@
 # SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 # Also available under a BSD-style license. See LICENSE.
 
-from typing import Optional, Sequence, Union, List, Dict, Tuple
+from typing import Any, Callable, Optional, Sequence, Union, List, Dict, Tuple
 from enum import Enum
 
 import sys
@@ -13,7 +13,8 @@ from torch._functorch.compile_utils import strip_overloads
 import torch
 
 from torch_mlir.passmanager import PassManager
-from .compiler_utils import run_pipeline_with_repro_report
+from torch_mlir._mlir_libs._torchMlir import set_context_num_threads
+from .compiler_utils import run_pipeline_with_repro_report, telemetry, write_module
 from torch_mlir.dialects.torch.importer.jit_ir import ClassAnnotator, ImportOptions, ModuleBuilder
 
 
@@ -241,7 +242,13 @@ class ExampleArgs:
 # compiler where each backend can "own" its set of legal ops.
 BACKEND_LEGAL_OPS = {
     OutputType.TOSA: ['torch.aten.flatten.using_ints', 'torch.aten.native_layer_norm', 'torch.aten.linear'],
-    OutputType.LINALG_ON_TENSORS: ['torch.aten.flatten.using_ints', ],
+    OutputType.LINALG_ON_TENSORS: [
+        'torch.aten.flatten.using_ints',
+        'torch.aten.native_layer_norm',
+        'torch.aten.randn.generator',
+        'torch.aten.bernoulli',
+        'torch.valsem.aten.bernoulli.float',
+    ],
     OutputType.MHLO: [],
 }
 
@@ -252,6 +259,11 @@ def compile(model: torch.nn.Module,
             use_tracing: bool = False,
             ignore_traced_shapes=False,
             backend_legal_ops: Optional[Sequence[str]] = None,
+            num_threads: Optional[int] = None,
+            weights_as_arguments: bool = False,
+            weights_as_arguments_min_elements: int = 1024,
+            verify_each: bool = True,
+            telemetry_callback: Optional[Callable[[Dict[str, Any]], None]] = None,
             verbose: bool = False):
     """Convert a PyTorch model to MLIR.
 
@@ -277,6 +289,40 @@ def compile(model: torch.nn.Module,
         backend_legal_ops: A list of ops that should be considered legal for
             the backend. An op that is considered legal will not be decomposed.
             This option is only valid with the `"torch"` output type.
+        num_threads: The number of threads that the compiler passes run on.
+            Passes on independent functions, such as the methods of a model
+            compiled with an `ExampleArgs` with several methods, run in
+            parallel. 1 compiles on the calling thread only, and 0 uses all
+            the hardware threads. Compilations asking for the same number of
+            threads share a thread pool. By default, MLIR's default thread
+            pool is used.
+        weights_as_arguments: If True, parameters and buffers with at least
+            `weights_as_arguments_min_elements` elements are not embedded in
+            the compiled module as constants. Instead, each method that uses
+            them takes them as trailing arguments, after its own arguments.
+            Their names, which are the keys of the model's `state_dict()`, are
+            listed per method in the `torch.weight_arguments` attribute of the
+            module. Their shapes and dtypes are still known to the compiler.
+            This keeps the module small, and lets the same compiled module run
+            with different weights.
+        weights_as_arguments_min_elements: The minimum number of elements of
+            a parameter or buffer for it to become an argument. Smaller ones
+            are still embedded, so that the compiler can simplify using their
+            values.
+        verify_each: If True, verify the IR after every compiler pass, which
+            pinpoints a pass that produces invalid IR. If False, verify it
+            only once at the end of each lowering pipeline, which is much
+            faster for large models.
+        telemetry_callback: If set, called with a dict describing each
+            iteration of the simplification pipeline that lowers the model to
+            the backend contract, and then with a dict summarizing all of
+            them. An iteration record has the seconds spent in each stage of
+            the pipeline ("stage_seconds"), the seconds spent checking the
+            backend contract after it ("contract_check_seconds"), the number
+            of times each op was decomposed ("decompositions"), and the
+            number of tensors with an unknown shape or dtype after it
+            ("unresolved_shapes" and "unresolved_dtypes"). The records are
+            distinguished by their "event" key.
         verbose: If true, print extra information about the conversion.
 
     Returns:
@@ -347,6 +393,10 @@ def compile(model: torch.nn.Module,
             scripted._c._type(), [method_name], annotation)
 
     mb = ModuleBuilder()
+    if num_threads is not None:
+        if num_threads < 0:
+            raise Exception("`num_threads` must not be negative")
+        set_context_num_threads(mb.module.context, num_threads)
     import_options = ImportOptions()
     import_options.ignoreExistingTensorShapesAndDtypes = ignore_traced_shapes
     try:
@@ -367,12 +417,19 @@ PyTorch TorchScript module -> torch-mlir Object Graph IR import failed with:
     if output_type == OutputType.RAW:
         return mb.module
 
-    option_string = "{backend-legal-ops=" + ",".join(backend_legal_ops) + "}"
-    run_pipeline_with_repro_report(
-        mb.module,
-        f"builtin.module(torchscript-module-to-torch-backend-pipeline{option_string})",
-        "Lowering TorchScript IR -> Torch Backend IR",
-    )
+    option_string = "{backend-legal-ops=" + ",".join(backend_legal_ops)
+    if weights_as_arguments:
+        option_string += (" lift-weights-to-arguments=true"
+                          " lift-weights-min-elements="
+                          f"{weights_as_arguments_min_elements}")
+    option_string += "}"
+    with telemetry(mb.module.context, telemetry_callback):
+        run_pipeline_with_repro_report(
+            mb.module,
+            f"builtin.module(torchscript-module-to-torch-backend-pipeline{option_string})",
+            "Lowering TorchScript IR -> Torch Backend IR",
+            verify_each=verify_each,
+        )
 
     if verbose:
         print("\n====================")
@@ -386,7 +443,8 @@ PyTorch TorchScript module -> torch-mlir Object Graph IR import failed with:
         run_pipeline_with_repro_report(
             mb.module,
             "builtin.module(torch-backend-to-tosa-backend-pipeline)",
-            "Lowering Torch Backend IR -> TOSA Backend IR")
+            "Lowering Torch Backend IR -> TOSA Backend IR",
+            verify_each=verify_each)
         if verbose:
             print("\n====================")
             print("TOSA Backend IR")
@@ -397,7 +455,8 @@ PyTorch TorchScript module -> torch-mlir Object Graph IR import failed with:
         run_pipeline_with_repro_report(
             mb.module,
             "builtin.module(torch-backend-to-linalg-on-tensors-backend-pipeline)",
-            "Lowering Torch Backend IR -> Linalg-on-Tensors Backend IR")
+            "Lowering Torch Backend IR -> Linalg-on-Tensors Backend IR",
+            verify_each=verify_each)
         if verbose:
             print("\n====================")
             print("LINALG Backend IR")
@@ -408,7 +467,8 @@ PyTorch TorchScript module -> torch-mlir Object Graph IR import failed with:
         run_pipeline_with_repro_report(
             mb.module,
             "builtin.module(torch-backend-to-mhlo-backend-pipeline)",
-            "Lowering Torch Backend IR -> MHLO Backend IR")
+            "Lowering Torch Backend IR -> MHLO Backend IR",
+            verify_each=verify_each)
         if verbose:
             print("\n====================")
             print("MHLO Backend IR")
@@ -4,12 +4,18 @@
 # Also available under a BSD-style license. See LICENSE.
 
 from io import StringIO
+from typing import Any, Callable, Dict, Optional
+import contextlib
+import json
 import os
+import shutil
 import sys
 import tempfile
 
 from torch_mlir.passmanager import PassManager
 from torch_mlir.ir import StringAttr
+from torch_mlir._mlir_libs._torchMlir import (set_context_telemetry_callback,
+                                               write_operation)
 
 
 def get_module_name_for_debug_dump(module):
@@ -31,20 +37,96 @@ class TorchMlirCompilerError(Exception):
         return self.value
 
 
+@contextlib.contextmanager
+def telemetry(context, callback: Optional[Callable[[Dict[str, Any]], None]]):
+    """Passes the telemetry records of the passes run in `context` within the
+    `with` block to `callback`, as dicts.
+
+    Every record has an "event" key that says what it describes. The passes
+    only collect telemetry while a callback is set. If `callback` is None,
+    this does nothing.
+    """
+    if callback is None:
+        yield
+        return
+    set_context_telemetry_callback(context,
+                                   lambda record: callback(json.loads(record)))
+    try:
+        yield
+    finally:
+        set_context_telemetry_callback(context, None)
+
+
+def write_module(module,
+                 file,
+                 bytecode: bool = False,
+                 large_elements_limit: Optional[int] = None,
+                 enable_debug_info: bool = False):
+    """Writes `module` to `file` while it is printed.
+
+    Unlike `str(module)`, this never holds the whole textual IR (or bytecode)
+    in memory, which matters for modules with large weights.
+
+    Args:
+        module: The `Module` or `Operation` to write.
+        file: A path, a file descriptor, or a binary file object with a
+            `fileno()`, such as one returned by `open(path, "wb")`.
+        bytecode: If True, write MLIR bytecode instead of textual IR.
+        large_elements_limit: If set, elements attributes (such as weights)
+            with more elements than this are elided from the textual IR.
+            The result cannot be compiled, but is much smaller. To keep the
+            weights out of the module without losing them, compile with
+            `weights_as_arguments=True` instead.
+        enable_debug_info: If True, print locations in the textual IR.
+    """
+    if bytecode and large_elements_limit is not None:
+        raise Exception("`large_elements_limit` is only supported for "
+                        "textual IR")
+    operation = getattr(module, "operation", module)
+    limit = -1 if large_elements_limit is None else large_elements_limit
+
+    def write(fd):
+        write_operation(operation, fd, bytecode, limit, enable_debug_info)
+
+    if isinstance(file, (str, os.PathLike)):
+        with open(file, "wb") as f:
+            write(f.fileno())
+    elif isinstance(file, int):
+        write(file)
+    else:
+        # Anything already buffered in `file` must come first.
+        file.flush()
+        write(file.fileno())
+
+
 def run_pipeline_with_repro_report(module,
                                    pipeline: str,
-                                   description: str):
-    """Runs `pipeline` on `module`, with a nice repro report if it fails."""
+                                   description: str,
+                                   verify_each: bool = True):
+    """Runs `pipeline` on `module`, with a nice repro report if it fails.
+
+    If `verify_each` is False, the module is verified only once, after the
+    whole pipeline, rather than after every pass. This is much faster for
+    large modules, but a pass that produces invalid IR is not identified.
+    """
     module_name = get_module_name_for_debug_dump(module)
+    # The repro is written to an anonymous file, rather than kept as a string,
+    # so that large modules are not duplicated in memory.
+    asm_for_error_report = tempfile.TemporaryFile()
     try:
         original_stderr = sys.stderr
         sys.stderr = StringIO()
-        asm_for_error_report = module.operation.get_asm(
-            large_elements_limit=10, enable_debug_info=True)
+        write_module(module, asm_for_error_report, large_elements_limit=10,
+                     enable_debug_info=True)
         # Lower module in place to make it ready for compiler backends.
         with module.context:
             pm = PassManager.parse(pipeline)
+            pm.enable_verifier(verify_each)
             pm.run(module)
+        if not verify_each and not module.operation.verify():
+            raise TorchMlirCompilerError(
+                f"{description or module_name} produced invalid IR; "
+                f"rerun with `verify_each=True` to find the failing pass")
     except Exception as e:
         # TODO: More robust.
         # - don't arbitrarily clutter up /tmp. When a test suite has many
@@ -55,8 +137,9 @@ def run_pipeline_with_repro_report(module,
         # - if we do have have colliding filenames, writes should at least
         #   avoid being racy.
         filename = os.path.join(tempfile.gettempdir(), module_name + ".mlir")
-        with open(filename, 'w') as f:
-            f.write(asm_for_error_report)
+        asm_for_error_report.seek(0)
+        with open(filename, 'wb') as f:
+            shutil.copyfileobj(asm_for_error_report, f)
         debug_options="-mlir-print-ir-after-all -mlir-disable-threading"
         # Put something descriptive here even if description is empty.
         description = description or f"{module_name} compile"
@@ -73,3 +156,4 @@ def run_pipeline_with_repro_report(module,
         raise TorchMlirCompilerError(trimmed_message) from None
     finally:
         sys.stderr = original_stderr
+        asm_for_error_report.close()
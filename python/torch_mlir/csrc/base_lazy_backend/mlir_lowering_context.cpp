@@ -15,6 +15,7 @@
 #include <torch/csrc/jit/api/compilation_unit.h>
 #include <torch/csrc/jit/passes/refine_tuple_types.h>
 #include <torch/csrc/lazy/core/lazy_graph_executor.h>
+#include <torch/csrc/lazy/core/metrics.h>
 #include "torch-mlir-c/Registration.h"
 
 #include "../../dialects/torch/importer/jit_ir/csrc/function_importer.h"
@@ -89,6 +90,13 @@ bool TorchMlirLoweringContext::CheckResultShape(
       result_idx < root_tuple_.size(), "Tried getting result shape at index ",
       result_idx, " which is out of bounds!");
 
+  // The jit types of results only carry their rank when dynamic shapes are
+  // enabled, so compare against the shape of the lazy output when known.
+  auto result_shape = result_shapes_.find(result_idx);
+  if (result_shape != result_shapes_.end()) {
+    return Shape(parameter_data->shape()) == result_shape->second;
+  }
+
   torch::jit::Value* output = root_tuple_[result_idx];
 
   if (c10::TensorTypePtr tensor_type =
@@ -109,7 +117,9 @@ bool TorchMlirLoweringContext::CheckResultShape(
 size_t TorchMlirLoweringContext::AddResult(const Output& output) {
   PRINT_FUNCTION();
 
-  return AddResult(GetOutputOp(output));
+  size_t result_idx = AddResult(GetOutputOp(output));
+  result_shapes_.emplace(result_idx, output.shape());
+  return result_idx;
 }
 
 // Associates the given output with the input parameter of the given index and
@@ -217,7 +227,7 @@ torch::jit::Value* TorchMlirLoweringContext::GetParameter(BackendDataPtr data) {
       param->setType(torch::jit::TensorType::create(
           /*scalar_type=*/data->shape().scalar_type(),
           /*device=*/c10::nullopt,
-          /*sizes=*/c10::VaryingShape<int64_t>(data->shape().sizes()),
+          /*sizes=*/GetTensorTypeSizes(data->shape()),
           /*strides=*/c10::VaryingShape<int64_t>(),
           /*requires_grad=*/c10::nullopt));
 
@@ -235,6 +245,16 @@ torch::jit::Value* TorchMlirLoweringContext::GetParameter(BackendDataPtr data) {
   return it->second.param;
 }
 
+c10::VaryingShape<int64_t>
+TorchMlirLoweringContext::GetTensorTypeSizes(const Shape& shape) {
+  // Only the rank is kept when dynamic shapes are enabled, since the dag hash
+  // the computation is cached under does not include sizes either.
+  if (enableDynamicShape()) {
+    return c10::VaryingShape<int64_t>(shape.dim());
+  }
+  return c10::VaryingShape<int64_t>(shape.sizes());
+}
+
 std::shared_ptr<torch::jit::Graph> TorchMlirLoweringContext::graph() const {
   return graph_;
 }
@@ -340,6 +360,25 @@ std::shared_ptr<torch::jit::Graph> TorchMlirComputation::graph() const {
   return graph_;
 }
 
+void TorchMlirComputation::RecordArgumentShapes(
+    c10::ArrayRef<BackendDataPtr> arguments) {
+  hash_t shapes_hash = static_cast<uint64_t>(arguments.size());
+  for (const BackendDataPtr& argument : arguments) {
+    shapes_hash =
+        HashCombine(shapes_hash, argument->shape().hash(/*bakeInSizes=*/true));
+  }
+
+  // Computations are cached and may be executed from several threads.
+  std::lock_guard<std::mutex> lock(executed_shapes_mutex_);
+  bool is_first_execution = executed_shapes_.empty();
+  if (executed_shapes_.insert(shapes_hash).second && !is_first_execution) {
+    // The lazy graph executor handed us a cached computation for input sizes
+    // it has not been run with before. Without dynamic shapes this would have
+    // been a fresh lowering and compile.
+    TORCH_LAZY_COUNTER("TorchMlirRecompilesAvoided", 1);
+  }
+}
+
 MlirOperation TorchMlirComputation::func_op() const { return func_op_; }
 
 MlirContext TorchMlirComputation::mlir_context() const {
@@ -12,11 +12,14 @@
 
 #pragma once
 
+#include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <torch/csrc/api/include/torch/jit.h>
 #include <torch/csrc/lazy/backend/lowering_context.h>
+#include <torch/csrc/lazy/core/hash.h>
 
 #include "mlir-c/IR.h"
 #include "mlir_node_lowering.h"
@@ -90,6 +93,11 @@ public:
   // held in data.
   torch::jit::Value* GetParameter(BackendDataPtr data);
 
+  // Returns the sizes to stamp onto a jit::Value of the given shape. These are
+  // the concrete sizes unless dynamic shapes are enabled, in which case every
+  // dimension is left unknown.
+  static c10::VaryingShape<int64_t> GetTensorTypeSizes(const Shape& shape);
+
   std::shared_ptr<torch::jit::Graph> graph() const;
 
 protected:
@@ -114,6 +122,8 @@ protected:
   std::unordered_map<BackendData::Handle, Parameter> parameters_map_;
   std::unordered_map<int, std::string> parameter_names_;
   std::vector<torch::jit::Value*> root_tuple_;
+  // Shapes of the lazy outputs added to the result tuple, by result index.
+  std::unordered_map<size_t, Shape> result_shapes_;
   OutputMap<torch::jit::Value*> emitted_outputs_;
 };
 
@@ -144,6 +154,11 @@ public:
 
   MlirContext mlir_context() const;
 
+  // Records the shapes of the arguments this computation is executed with.
+  // Each set of shapes not seen before, other than the first one, is counted
+  // once in the "TorchMlirRecompilesAvoided" lazy tensor counter.
+  void RecordArgumentShapes(c10::ArrayRef<BackendDataPtr> arguments);
+
   virtual const std::string debug_string() const;
 
   virtual const std::string to_string() const override;
@@ -159,6 +174,8 @@ protected:
   MlirContext mlir_context_;
   std::shared_ptr<torch::jit::Graph> graph_;
   InputOutputAliases input_output_aliases_;
+  std::mutex executed_shapes_mutex_;
+  std::unordered_set<hash_t, HashReducer> executed_shapes_;
 };
 
 } // namespace lazy
@@ -87,12 +87,13 @@ TorchMlirOpVector LowerTorchMlirBuiltin(
     const std::vector<torch::jit::NamedValue>& kwarguments) {
   std::vector<c10::TypePtr> tensor_types;
 
-  // Generate types with fixed tensor shape information.
+  // Generate types with tensor shape information. The sizes are only fixed if
+  // dynamic shapes are disabled.
   for (const Shape& shape : result_shapes) {
     tensor_types.push_back(torch::jit::TensorType::create(
         /*scalar_type=*/shape.scalar_type(),
         /*device=*/c10::nullopt,
-        /*sizes=*/c10::VaryingShape<int64_t>(shape.sizes()),
+        /*sizes=*/TorchMlirLoweringContext::GetTensorTypeSizes(shape),
         /*strides=*/c10::VaryingShape<int64_t>(),
         /*requires_grad=*/c10::nullopt));
   }
@@ -94,6 +94,7 @@ public:
 
     auto mlir_computation =
         static_cast<TorchMlirComputation*>(computation.get());
+    mlir_computation->RecordArgumentShapes(arguments);
 
     int num_inputs = 0;
 
@@ -119,6 +119,12 @@ def aten〇floor〡shape(self: List[int]) -> List[int]:
 def aten〇detach〡shape(self: List[int]) -> List[int]:
     return upstream_shape_functions.unary(self)
 
+def aten〇dequantize〇self〡shape(self: List[int]) -> List[int]:
+    return upstream_shape_functions.unary(self)
+
+def aten〇quantize_per_tensor〡shape(self: List[int], scale: float, zero_point: int, dtype: int) -> List[int]:
+    return upstream_shape_functions.unary(self)
+
 def aten〇log2〡shape(self: List[int]) -> List[int]:
     return upstream_shape_functions.unary(self)
 
@@ -22,6 +22,9 @@
 #include "torch-mlir-c/TorchOps.h"
 #include "torch-mlir-c/TorchTypes.h"
 
+#include <c10/util/hash.h>
+#include <torch/csrc/jit/ir/type_hashing.h>
+
 using namespace torch_mlir;
 
 using Value = torch::jit::Value;
@@ -29,6 +32,21 @@ using Block = torch::jit::Block;
 using Node = torch::jit::Node;
 
 namespace {
+// Hashes types structurally. `torch::jit::HashType` only hashes the kind of
+// most types, which would put all tensor types in the same bucket, so the
+// dtype and sizes of tensor types are hashed too.
+struct TypeStructureHash {
+  size_t operator()(const c10::TypePtr &type) const {
+    size_t hash = torch::jit::HashType()(type);
+    if (auto tensorType = type->cast<c10::TensorType>()) {
+      hash = c10::hash_combine(
+          hash, c10::get_hash(tensorType->scalarType(),
+                              tensorType->sizes().sizes()));
+    }
+    return hash;
+  }
+};
+
 class NodeImporter {
 public:
   NodeImporter(MlirContext context) : context(context) {}
@@ -49,9 +67,30 @@ private:
   void mapResults(Node *node, MlirOperation operation);
   MlirValue lookupMappedValue(Value *jitValue);
   std::vector<MlirValue> lookupMappedValues(c10::ArrayRef<Value *> values);
+  const SchemaOperationName &
+  lookupOperationName(const c10::FunctionSchema &schema);
+  MlirType lookupMlirType(MlirLocation loc, const c10::TypePtr &torchType,
+                          const ImportOptions &importOptions);
+  std::vector<MlirType> lookupMlirTypes(MlirLocation loc,
+                                        c10::ArrayRef<Value *> values,
+                                        const ImportOptions &importOptions);
 
   MlirContext context;
   std::unordered_map<Value *, MlirValue> valueMap;
+  // Memoized schema and type conversions for this import session. A graph
+  // typically uses a handful of distinct operators and types across all of
+  // its nodes, so most nodes hit in these tables instead of redoing the name
+  // munging, the context lookup and the type construction. The import options
+  // are fixed for the lifetime of a NodeImporter, so they are not part of the
+  // type key.
+  std::unordered_map<const c10::FunctionSchema *, SchemaOperationName>
+      operationNames;
+  // Types are keyed by structure rather than identity, since every
+  // jit::Value usually has its own TensorType object even when it is equal to
+  // those of other values.
+  std::unordered_map<c10::TypePtr, MlirType, TypeStructureHash,
+                     torch::jit::EqualType>
+      mlirTypes;
 };
 } // namespace
 
@@ -89,7 +128,7 @@ void NodeImporter::importNode(Node *node, MlirBlock appendToBlock,
     std::vector<MlirValue> mappedInputs = lookupMappedValues(node->inputs());
     MlirOperation operation = createMlirOperationAtEnd(
         appendToBlock, opName, loc,
-        getMlirTypesFromValues(loc, node->outputs(), importOptions),
+        lookupMlirTypes(loc, node->outputs(), importOptions),
         t ? t(mappedInputs) : mappedInputs);
     mapResults(node, operation);
   };
@@ -99,7 +138,7 @@ void NodeImporter::importNode(Node *node, MlirBlock appendToBlock,
           MlirAttribute attr) {
         MlirOperation operation = createMlirOperationAtEnd(
             appendToBlock, opName, loc,
-            getMlirTypesFromValues(loc, node->outputs(), importOptions),
+            lookupMlirTypes(loc, node->outputs(), importOptions),
             lookupMappedValues(node->inputs()),
             toMlirNamedAttribute(attrName.c_str(), attr));
         mapResults(node, operation);
@@ -109,8 +148,8 @@ void NodeImporter::importNode(Node *node, MlirBlock appendToBlock,
   auto maybeSchema = node->maybeSchema();
   if (maybeSchema) {
     MlirOperation operation = createOperationFromSchema(
-        appendToBlock, loc, node->schema(),
-        getMlirTypesFromValues(loc, node->outputs(), importOptions),
+        appendToBlock, loc, lookupOperationName(node->schema()),
+        lookupMlirTypes(loc, node->outputs(), importOptions),
         lookupMappedValues(node->inputs()));
     mapResults(node, operation);
     return;
@@ -133,7 +172,7 @@ void NodeImporter::importNode(Node *node, MlirBlock appendToBlock,
     auto containedTypes = c10::fmap(
         node->output()->type()->cast<c10::TupleType>()->containedTypes(),
         [&](const c10::TypePtr &t) {
-          MlirType type = getMlirTypeFromTorchType(loc, t, importOptions);
+          MlirType type = lookupMlirType(loc, t, importOptions);
           if (mlirTypeIsNull(type)) {
             throw mlir_diagnostic_emitted();
           }
@@ -181,13 +220,13 @@ void NodeImporter::importNode(Node *node, MlirBlock appendToBlock,
     } else if (output->type()->cast<c10::IntType>()) {
       op = createMlirOperation(
           "torch.constant.int", loc,
-          getMlirTypeFromTorchType(loc, output->type(), importOptions),
+          lookupMlirType(loc, output->type(), importOptions),
           toMlirNamedAttribute("value",
                                importAttribute(loc, node, c10::attr::value)));
     } else if (output->type()->cast<c10::FloatType>()) {
       op = createMlirOperation(
           "torch.constant.float", loc,
-          getMlirTypeFromTorchType(loc, output->type(), importOptions),
+          lookupMlirType(loc, output->type(), importOptions),
           toMlirNamedAttribute("value",
                                importAttribute(loc, node, c10::attr::value)));
     } else if (output->type()->cast<c10::StringType>()) {
@@ -212,7 +251,7 @@ void NodeImporter::importNode(Node *node, MlirBlock appendToBlock,
     } else if (output->type()->cast<c10::DeviceObjType>()) {
       op = createMlirOperation(
           "torch.constant.device", loc,
-          getMlirTypeFromTorchType(loc, output->type(), importOptions),
+          lookupMlirType(loc, output->type(), importOptions),
           toMlirNamedAttribute(
               "value", mlirStringAttrGet(context, toMlirStringRef(node->s(
                                                       c10::attr::value)))));
@@ -247,7 +286,7 @@ void NodeImporter::importNode(Node *node, MlirBlock appendToBlock,
 
   if (kind == c10::prim::Loop) {
     std::vector<MlirType> resultTypes =
-        getMlirTypesFromValues(loc, node->outputs(), importOptions);
+        lookupMlirTypes(loc, node->outputs(), importOptions);
     MlirOperation operation = createMlirOperationAtEnd(
         appendToBlock, "torch.prim.Loop", loc, resultTypes,
         lookupMappedValues(node->inputs().slice(0, 2)),
@@ -276,7 +315,7 @@ void NodeImporter::importNode(Node *node, MlirBlock appendToBlock,
 
   if (kind == c10::prim::If) {
     std::vector<MlirType> resultTypes =
-        getMlirTypesFromValues(loc, node->outputs(), importOptions);
+        lookupMlirTypes(loc, node->outputs(), importOptions);
     MlirOperation operation = createMlirOperationAtEnd(
         appendToBlock, "torch.prim.If", loc, lookupMappedValue(node->input()),
         resultTypes, mlirRegionCreate(), mlirRegionCreate());
@@ -310,7 +349,7 @@ void NodeImporter::importNode(Node *node, MlirBlock appendToBlock,
     }
     MlirOperation operation = createMlirOperationAtEnd(
         appendToBlock, "torch.prim.CallMethod", loc,
-        getMlirTypesFromValues(loc, node->outputs(), importOptions),
+        lookupMlirTypes(loc, node->outputs(), importOptions),
         adjustStaticInformationForValues(
             appendToBlock, loc, lookupMappedValues(node->inputs()),
             expectedTypes, /*userAllowsRefinement=*/false),
@@ -325,11 +364,11 @@ void NodeImporter::importNode(Node *node, MlirBlock appendToBlock,
     torch::jit::Block *calleeEntryBlock =
         torch::jit::toGraphFunction(*functionType->function()).graph()->block();
     auto expectedTypes = c10::fmap(calleeEntryBlock->inputs(), [&](Value *v) {
-      return getMlirTypeFromTorchType(loc, v->type(), importOptions);
+      return lookupMlirType(loc, v->type(), importOptions);
     });
     std::string functionName = node->input(0)->node()->s(c10::attr::name);
     std::vector<MlirType> resultTypes =
-        getMlirTypesFromValues(loc, node->outputs(), importOptions);
+        lookupMlirTypes(loc, node->outputs(), importOptions);
     std::vector<MlirValue> adjustedFuncArgs = adjustStaticInformationForValues(
         appendToBlock, loc, lookupMappedValues(node->inputs().slice(1)),
         expectedTypes, /*userAllowsRefinement=*/false);
@@ -379,7 +418,7 @@ MlirBlock NodeImporter::createBlockFor(
   Node *paramNode = jitBlock->param_node();
   MlirLocation loc = getMlirLocationFromNode(context, paramNode);
   std::vector<MlirType> paramNodeTypes =
-      getMlirTypesFromValues(loc, paramNode->outputs(), importOptions);
+      lookupMlirTypes(loc, paramNode->outputs(), importOptions);
   if (!blockArgTypes)
     blockArgTypes = paramNodeTypes;
   else
@@ -427,6 +466,42 @@ NodeImporter::lookupMappedValues(c10::ArrayRef<Value *> values) {
   return ret;
 }
 
+const SchemaOperationName &
+NodeImporter::lookupOperationName(const c10::FunctionSchema &schema) {
+  auto it = operationNames.find(&schema);
+  if (it == operationNames.end()) {
+    it = operationNames
+             .emplace(&schema, getOperationNameFromSchema(context, schema))
+             .first;
+  }
+  return it->second;
+}
+MlirType NodeImporter::lookupMlirType(MlirLocation loc,
+                                      const c10::TypePtr &torchType,
+                                      const ImportOptions &importOptions) {
+  auto it = mlirTypes.find(torchType);
+  if (it != mlirTypes.end())
+    return it->second;
+  MlirType type = getMlirTypeFromTorchType(loc, torchType, importOptions);
+  // Failures are not cached so that every use reports its own diagnostic.
+  if (!mlirTypeIsNull(type))
+    mlirTypes.emplace(torchType, type);
+  return type;
+}
+std::vector<MlirType>
+NodeImporter::lookupMlirTypes(MlirLocation loc, c10::ArrayRef<Value *> values,
+                              const ImportOptions &importOptions) {
+  std::vector<MlirType> ret;
+  ret.reserve(values.size());
+  for (Value *value : values) {
+    MlirType t = lookupMlirType(loc, value->type(), importOptions);
+    if (mlirTypeIsNull(t))
+      throw mlir_diagnostic_emitted("unsupported type");
+    ret.push_back(t);
+  }
+  return ret;
+}
+
 MlirBlock
 torch_mlir::importBlock(MlirContext context, Block *jitBlock,
                         CreateTerminatorFn createTerminator,
@@ -460,13 +460,9 @@ std::vector<MlirValue> torch_mlir::adjustStaticInformationForValues(
   return ret;
 }
 
-MlirOperation
-torch_mlir::createOperationFromSchema(MlirBlock appendToBlock, MlirLocation loc,
-                                      const c10::FunctionSchema &schema,
-                                      c10::ArrayRef<MlirType> resultTypes,
-                                      c10::ArrayRef<MlirValue> operands) {
-  MlirContext context = mlirLocationGetContext(loc);
-
+torch_mlir::SchemaOperationName
+torch_mlir::getOperationNameFromSchema(MlirContext context,
+                                       const c10::FunctionSchema &schema) {
   // Munge the name into the appropriate MLIR operation name.
   // See torch_ods_gen.py:JitOperator for the logic used to construct the MLIR
   // op name from the schema. This logic must be kept in sync with that logic.
@@ -480,10 +476,8 @@ torch_mlir::createOperationFromSchema(MlirBlock appendToBlock, MlirLocation loc,
   }
   std::string opName = "torch." + opNameSuffix;
   // If we have a registered op, use it!
-  if (mlirContextIsRegisteredOperation(context, toMlirStringRef(opName))) {
-    return createMlirOperationAtEnd(appendToBlock, opName, loc, resultTypes,
-                                    operands);
-  }
+  if (mlirContextIsRegisteredOperation(context, toMlirStringRef(opName)))
+    return {opName, /*operatorName=*/""};
   // Oops, no registered op -- create an opaque wrapper so that import can
   // still succeed. This helps a common use case of filling out registered ops
   // support, where it is easier to iterate on an MLIR file with
@@ -493,8 +487,32 @@ torch_mlir::createOperationFromSchema(MlirBlock appendToBlock, MlirLocation loc,
   // - Makes the dialect overall less strict
   // - Makes it hard to see exactly which ops from a model are registered or
   //   not.
-  return createMlirOperationAtEnd(
-      appendToBlock, "torch.operator", loc, resultTypes, operands,
-      toMlirNamedAttribute(
-          "name", mlirStringAttrGet(context, toMlirStringRef(opNameSuffix))));
+  return {"torch.operator", opNameSuffix};
+}
+
+MlirOperation
+torch_mlir::createOperationFromSchema(MlirBlock appendToBlock, MlirLocation loc,
+                                      const SchemaOperationName &name,
+                                      c10::ArrayRef<MlirType> resultTypes,
+                                      c10::ArrayRef<MlirValue> operands) {
+  if (name.operatorName.empty()) {
+    return createMlirOperationAtEnd(appendToBlock, name.opName, loc,
+                                    resultTypes, operands);
+  }
+  MlirAttribute operatorName = mlirStringAttrGet(
+      mlirLocationGetContext(loc), toMlirStringRef(name.operatorName));
+  return createMlirOperationAtEnd(appendToBlock, name.opName, loc, resultTypes,
+                                  operands,
+                                  toMlirNamedAttribute("name", operatorName));
+}
+
+MlirOperation
+torch_mlir::createOperationFromSchema(MlirBlock appendToBlock, MlirLocation loc,
+                                      const c10::FunctionSchema &schema,
+                                      c10::ArrayRef<MlirType> resultTypes,
+                                      c10::ArrayRef<MlirValue> operands) {
+  return createOperationFromSchema(
+      appendToBlock, loc,
+      getOperationNameFromSchema(mlirLocationGetContext(loc), schema),
+      resultTypes, operands);
 }
@@ -13,6 +13,7 @@
 #include "import_options.h"
 
 #include <memory>
+#include <string>
 
 #include "mlir-c/IR.h"
 
@@ -74,11 +75,37 @@ std::vector<MlirValue> adjustStaticInformationForValues(
     MlirBlock appendToBlock, MlirLocation loc, c10::ArrayRef<MlirValue> values,
     c10::ArrayRef<MlirType> desiredTypes, bool userAllowsRefinement);
 
-/// Create the appropriate MLIR operation for the Torch operator with schema
+/// The MLIR operation name that the Torch operator with a given schema is
+/// imported as.
+struct SchemaOperationName {
+  /// The registered `torch.*` op name, or "torch.operator" if there is no
+  /// registered op for the schema.
+  std::string opName;
+  /// For "torch.operator", the munged operator name that is attached to the op
+  /// as its `name` attribute. Empty for registered ops.
+  std::string operatorName;
+};
+
+/// Computes the MLIR operation name for the Torch operator with schema
 /// "schema".
 ///
 /// The primary difficulty here is doing the appropriate name munging and
-/// checking if the have a registered op.
+/// checking if the have a registered op. Both involve string manipulation and
+/// a lookup in the context, so callers importing many nodes should memoize
+/// the result per schema.
+SchemaOperationName
+getOperationNameFromSchema(MlirContext context,
+                           const c10::FunctionSchema &schema);
+
+/// Create the MLIR operation named by `name` for a Torch operator.
+MlirOperation createOperationFromSchema(MlirBlock appendToBlock,
+                                        MlirLocation loc,
+                                        const SchemaOperationName &name,
+                                        c10::ArrayRef<MlirType> resultTypes,
+                                        c10::ArrayRef<MlirValue> operands);
+
+/// Create the appropriate MLIR operation for the Torch operator with schema
+/// "schema".
 MlirOperation createOperationFromSchema(MlirBlock appendToBlock,
                                         MlirLocation loc,
                                         const c10::FunctionSchema &schema,
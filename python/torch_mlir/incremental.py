@@ -0,0 +1,289 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+"""
+Incremental recompilation of models whose weights change but whose structure
+does not.
+
+`compile_with_weight_arguments` compiles a model with `torch_mlir.compile`'s
+`weights_as_arguments` mode, so its parameters and buffers become trailing
+arguments of `forward` and the compiled program does not depend on their
+values. Compiled programs are cached under a hash of the model's
+weight-stripped structure. Compiling the same architecture again with
+different weights is then a cache hit: it only hashes the structure and
+collects the new weight tensors, and none of the compiler runs.
+"""
+
+from typing import Any, Callable, Dict, List, NamedTuple, Optional, Union
+
+import collections
+import functools
+import hashlib
+import inspect
+import itertools
+
+import torch
+
+from . import ExampleArgs, OutputType, TensorPlaceholder, compile
+from .ir import ArrayAttr, DictAttr, StringAttr
+
+
+class WeightArgumentsProgram(NamedTuple):
+    """The result of `compile_with_weight_arguments`.
+
+    The compiled `forward` takes the original arguments of the model's
+    `forward`, followed by `weights` in order. With RefBackend, bind them with
+    `invoker.bind_weights(program.weights_by_name())`.
+    """
+    # The compiled module, or the result of `compile_artifact` on it.
+    artifact: Any
+    # The names of the weights that `forward` takes as arguments, as listed in
+    # the module's `torch.weight_arguments` attribute.
+    weight_names: List[str]
+    # The current values of the model's parameters and buffers.
+    weights: List[torch.Tensor]
+    # The key that `artifact` is cached under.
+    key: str
+
+    def weights_by_name(self) -> Dict[str, torch.Tensor]:
+        return dict(zip(self.weight_names, self.weights))
+
+
+class _CacheEntry(NamedTuple):
+    artifact: Any
+    weight_names: List[str]
+    # The weights that the compiler could not lift to arguments, and so are
+    # embedded in `artifact`. The entry only matches a model with the same
+    # values for them.
+    embedded_weights: Dict[str, torch.Tensor]
+
+    def matches(self, named_weights: Dict[str, torch.Tensor]) -> bool:
+        return all(
+            torch.equal(named_weights[name], value)
+            for name, value in self.embedded_weights.items())
+
+
+class WeightArgumentsCache:
+    """A cache of compiled programs, keyed by weight-stripped structure.
+
+    If `max_entries` is set, the least recently used program is evicted when
+    the cache is full.
+    """
+    def __init__(self, max_entries: Optional[int] = None):
+        self.max_entries = max_entries
+        self._programs = collections.OrderedDict()
+
+    def get(self, key: str) -> Optional[_CacheEntry]:
+        entry = self._programs.get(key)
+        if entry is not None:
+            self._programs.move_to_end(key)
+        return entry
+
+    def put(self, key: str, entry: _CacheEntry):
+        self._programs[key] = entry
+        self._programs.move_to_end(key)
+        if self.max_entries is not None:
+            while len(self._programs) > self.max_entries:
+                self._programs.popitem(last=False)
+
+    def __len__(self):
+        return len(self._programs)
+
+
+@functools.lru_cache(maxsize=None)
+def _get_class_source(cls: type) -> str:
+    try:
+        return inspect.getsource(cls)
+    except (OSError, TypeError):
+        # Classes defined interactively or in C++ have no source. Their
+        # qualified name and `extra_repr` still go into the key.
+        return ""
+
+
+def _named_weights(model: torch.nn.Module):
+    return list(itertools.chain(model.named_parameters(),
+                                model.named_buffers()))
+
+
+# The attributes that every `torch.nn.Module` has, such as `_parameters` and
+# `training`. The remaining entries of a module's `__dict__` are its own plain
+# Python attributes.
+_MODULE_INTERNAL_ATTRIBUTES = frozenset(vars(torch.nn.Module()))
+
+
+def _describe_attribute(value) -> str:
+    """Describes a plain Python attribute of a module.
+
+    TorchScript embeds the attributes that `forward` reads as constants, so
+    the values of those it can represent are described: scalars, strings,
+    dtypes, devices, tensors that are not parameters or buffers, and
+    containers of those. Other objects are only described by their type.
+    """
+    if value is None or isinstance(
+            value, (bool, int, float, str, torch.dtype, torch.device)):
+        return repr(value)
+    if isinstance(value, torch.Tensor):
+        data = value.detach().cpu().flatten().view(torch.uint8)
+        digest = hashlib.sha256(data.numpy().tobytes()).hexdigest()
+        return f"tensor:{list(value.shape)}:{value.dtype}:{digest}"
+    if isinstance(value, (list, tuple)):
+        elements = ",".join(_describe_attribute(v) for v in value)
+        return f"{type(value).__name__}[{elements}]"
+    if isinstance(value, dict):
+        items = sorted(f"{_describe_attribute(k)}:{_describe_attribute(v)}"
+                       for k, v in value.items())
+        return f"dict{{{','.join(items)}}}"
+    cls = type(value)
+    return f"<{cls.__module__}.{cls.__qualname__}>"
+
+
+# Options of `torch_mlir.compile` that do not change the compiled program.
+_KEY_INDEPENDENT_COMPILE_KWARGS = {"num_threads", "verbose"}
+
+
+def compute_structure_key(model: torch.nn.Module,
+                          example_args: List[Union[torch.Tensor,
+                                                   TensorPlaceholder]],
+                          output_type: OutputType,
+                          extra_key: str = "",
+                          compile_kwargs: Optional[Dict[str, Any]] = None
+                          ) -> str:
+    """Hashes everything about `model` that determines its compiled program,
+    except for the values of its weights.
+
+    This covers the module hierarchy (the class, source, `extra_repr` and
+    plain Python attributes of every submodule), the names, shapes and dtypes
+    of the parameters and buffers, the shapes and dtypes of `example_args`,
+    `output_type`, and the `compile_kwargs` passed to `torch_mlir.compile`
+    (such as `backend_legal_ops` or `use_tracing`). Attributes holding objects
+    other than scalars, strings, tensors and containers of those are only
+    hashed by type. A model whose `forward` depends on their contents, or on
+    any other state, must describe that state in `extra_key`.
+    """
+    h = hashlib.sha256()
+
+    def add(s: str):
+        h.update(s.encode())
+        h.update(b"\0")
+
+    add(output_type.value)
+    add(extra_key)
+    for name, value in sorted((compile_kwargs or {}).items()):
+        if name not in _KEY_INDEPENDENT_COMPILE_KWARGS:
+            add(f"{name}={value!r}")
+    for name, module in model.named_modules():
+        cls = type(module)
+        add(name)
+        add(f"{cls.__module__}.{cls.__qualname__}")
+        add(_get_class_source(cls))
+        add(module.extra_repr())
+        add(str(module.training))
+        for attr_name, value in sorted(vars(module).items()):
+            if attr_name not in _MODULE_INTERNAL_ATTRIBUTES:
+                add(f"{attr_name}={_describe_attribute(value)}")
+    for name, weight in _named_weights(model):
+        add(f"{name}:{list(weight.shape)}:{weight.dtype}")
+    for arg in example_args:
+        add(f"{list(arg.shape)}:{arg.dtype}")
+    return h.hexdigest()
+
+
+def _get_weight_argument_names(module) -> List[str]:
+    """Returns the names of the weights that the compiled `forward` takes as
+    arguments, from the module's `torch.weight_arguments` attribute."""
+    with module.context:
+        attributes = module.operation.attributes
+        if "torch.weight_arguments" not in attributes:
+            return []
+        weight_arguments = DictAttr(attributes["torch.weight_arguments"])
+        if "forward" not in weight_arguments:
+            return []
+        return [
+            StringAttr(name).value
+            for name in ArrayAttr(weight_arguments["forward"])
+        ]
+
+
+def compile_with_weight_arguments(
+        model: torch.nn.Module,
+        example_args,
+        output_type: Union[str, OutputType] = OutputType.TORCH,
+        cache: Optional[WeightArgumentsCache] = None,
+        compile_artifact: Optional[Callable[[Any], Any]] = None,
+        extra_key: str = "",
+        **compile_kwargs) -> WeightArgumentsProgram:
+    """Compile `model` so that its weights are arguments of the program.
+
+    On a cache miss, the model is compiled with `torch_mlir.compile` and
+    `weights_as_arguments`, lifting every parameter and buffer that `forward`
+    only reads to a trailing argument. If `compile_artifact` is given, it is
+    applied to the compiled module (for example to compile and load it with a
+    backend), and its result is what gets cached and returned.
+
+    On a cache hit, nothing is compiled. The cached artifact is returned along
+    with the model's current weights, to be passed to the compiled `forward`.
+    Weights that could not be lifted (for example because `forward` assigns
+    them) are embedded in the program, so an entry is only reused if their
+    values did not change.
+
+    Args:
+        model: The model to compile. Only `forward` is compiled.
+        example_args: The example arguments of `forward`, as for
+            `torch_mlir.compile`.
+        output_type: The kind of output to produce, as for
+            `torch_mlir.compile`.
+        cache: The cache to look up and store the compiled program in.
+        compile_artifact: Applied to the compiled module before it is cached.
+        extra_key: Describes any state that `forward` depends on besides the
+            module hierarchy and weights. See `compute_structure_key`.
+        **compile_kwargs: Passed through to `torch_mlir.compile`, and part of
+            the cache key.
+    Returns:
+        A `WeightArgumentsProgram`.
+    """
+    output_type = OutputType.get(output_type)
+    if output_type == OutputType.RAW:
+        raise Exception("`compile_with_weight_arguments` does not support "
+                        "the RAW output type, which does not lift weights")
+    example_args = ExampleArgs.get(example_args)
+    if list(example_args._get_methods()) != ["forward"]:
+        raise Exception("`compile_with_weight_arguments` only supports "
+                        "compiling the `forward` method")
+    forward_args = list(example_args._get_for_annotation()["forward"])
+
+    named_weights = {
+        name: weight.detach()
+        for name, weight in _named_weights(model)
+    }
+    key = compute_structure_key(model, forward_args, output_type, extra_key,
+                                compile_kwargs)
+
+    entry = cache.get(key) if cache is not None else None
+    if entry is None or not entry.matches(named_weights):
+        module = compile(model,
+                         example_args,
+                         output_type=output_type,
+                         weights_as_arguments=True,
+                         weights_as_arguments_min_elements=1,
+                         **compile_kwargs)
+        weight_names = _get_weight_argument_names(module)
+        lifted = set(weight_names)
+        embedded_weights = {
+            name: weight.clone()
+            for name, weight in named_weights.items()
+            if name not in lifted and weight.numel() > 0
+        }
+        artifact = module
+        if compile_artifact is not None:
+            artifact = compile_artifact(artifact)
+        entry = _CacheEntry(artifact=artifact,
+                            weight_names=weight_names,
+                            embedded_weights=embedded_weights)
+        if cache is not None:
+            cache.put(key, entry)
+    return WeightArgumentsProgram(
+        artifact=entry.artifact,
+        weight_names=entry.weight_names,
+        weights=[named_weights[name] for name in entry.weight_names],
+        key=key)
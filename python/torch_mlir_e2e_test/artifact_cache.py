@@ -0,0 +1,144 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+"""
+A content-addressed cache of compiled MLIR artifacts.
+
+Compiling a test through a backend's lowering pipeline is usually the most
+expensive part of running it. The cache stores the output of the pipeline on
+disk, keyed by a hash of everything that determines it:
+
+- the backend's input IR,
+- the backend class, and the source of the modules that define it and any
+  backend it delegates to, which hold its lowering pipeline strings,
+- the torch-mlir build that compiled it.
+
+So one cache directory can be shared by all the worker processes of a run, and
+reused by later runs for every test whose IR did not change.
+
+Only the lowering pipeline run by `backend.compile` is skipped. The cached
+artifact is still loaded with `backend.load`, which for RefBackend is where
+the LLVM code generation happens, so that cost is paid on every run.
+"""
+
+from typing import Optional
+
+import glob
+import hashlib
+import inspect
+import os
+import tempfile
+
+import torch_mlir
+from torch_mlir.compiler_utils import write_module
+from torch_mlir.ir import Context, Module
+
+_build_identity = None
+
+
+def _get_build_identity() -> str:
+    """Identifies the torch-mlir build, so that artifacts compiled by a
+    different build of the passes are never reused."""
+    global _build_identity
+    if _build_identity is None:
+        libs_dir = os.path.join(os.path.dirname(torch_mlir.__file__),
+                                "_mlir_libs")
+        entries = []
+        for path in sorted(glob.glob(os.path.join(libs_dir, "*"))):
+            stat = os.stat(path)
+            entries.append(f"{os.path.basename(path)}:{stat.st_size}:"
+                           f"{stat.st_mtime_ns}")
+        _build_identity = ";".join(entries)
+    return _build_identity
+
+
+_backend_identities = {}
+
+
+def _get_backend_identity(backend) -> str:
+    """Identifies the lowering a backend performs.
+
+    The pipeline strings live in the Python modules that define the backend
+    (e.g. `LOWERING_PIPELINE` in refbackend.py), so the source of those
+    modules is hashed. Backends that wrap another backend (like the TOSA and
+    MHLO backends wrapping RefBackend) also include the wrapped one.
+    """
+    backend_type = type(backend)
+    if backend_type not in _backend_identities:
+        h = hashlib.sha256()
+        h.update(f"{backend_type.__module__}."
+                 f"{backend_type.__qualname__}".encode())
+        for cls in backend_type.__mro__:
+            if not cls.__module__.startswith("torch_mlir_e2e_test."):
+                continue
+            with open(inspect.getsourcefile(cls), "rb") as f:
+                h.update(f.read())
+        for attr in vars(backend).values():
+            if hasattr(attr, "compile") and hasattr(attr, "load"):
+                h.update(_get_backend_identity(attr).encode())
+        _backend_identities[backend_type] = h.hexdigest()
+    return _backend_identities[backend_type]
+
+
+class ArtifactCache:
+    """An on-disk cache of compiled `Module`s.
+
+    Entries are written atomically, so concurrent workers compiling the same
+    program at worst duplicate the work, and never observe a partial entry.
+    """
+    def __init__(self, directory: str):
+        self.directory = directory
+        os.makedirs(directory, exist_ok=True)
+
+    def _path(self, key: str) -> str:
+        return os.path.join(self.directory, key + ".mlir")
+
+    def compute_key(self, backend, module: Module) -> str:
+        h = hashlib.sha256()
+        for part in [
+                _get_build_identity(),
+                _get_backend_identity(backend),
+        ]:
+            h.update(part.encode())
+            h.update(b"\0")
+        # Stream the bytecode of the module through a temporary file, so that
+        # its weights are never held in memory as a string.
+        with tempfile.TemporaryFile() as f:
+            write_module(module, f, bytecode=True)
+            f.seek(0)
+            for chunk in iter(lambda: f.read(1 << 20), b""):
+                h.update(chunk)
+        return h.hexdigest()
+
+    def get(self, key: str) -> Optional[Module]:
+        try:
+            with open(self._path(key)) as f:
+                asm = f.read()
+        except FileNotFoundError:
+            return None
+        # Each entry gets its own context, which is freed along with the
+        # artifact once the test is done with it.
+        return Module.parse(asm, context=Context())
+
+    def put(self, key: str, artifact: Module):
+        fd, temp_path = tempfile.mkstemp(dir=self.directory, suffix=".tmp")
+        try:
+            with os.fdopen(fd, "wb") as f:
+                write_module(artifact, f)
+            os.replace(temp_path, self._path(key))
+        except BaseException:
+            os.remove(temp_path)
+            raise
+
+    def compile(self, backend, module: Module):
+        """Compile `module` with `backend`, reusing a cached artifact if one
+        exists. Artifacts that are not `Module`s are not cached."""
+        key = self.compute_key(backend, module)
+        artifact = self.get(key)
+        if artifact is not None:
+            return artifact
+        artifact = backend.compile(module)
+        if isinstance(artifact, Module):
+            self.put(key, artifact)
+        return artifact
@@ -0,0 +1,17 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+# The workloads here mirror the ops covered by the `test_suite`, but at
+# production-scale shapes that do not fit in cache. They are registered in
+# `GLOBAL_BENCHMARK_REGISTRY` and are meant to be run with
+# `e2e_testing.main --benchmark_suite`.
+
+def register_all_benchmarks():
+    """Registers all the built-in E2E benchmarks that Torch-MLIR provides."""
+    # Side-effecting import statements.
+    from . import matmul
+    from . import conv
+    from . import transformer
+    from . import embedding
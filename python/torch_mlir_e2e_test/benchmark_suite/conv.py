@@ -0,0 +1,77 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+import torch
+
+from torch_mlir_e2e_test.framework import TestUtils
+from torch_mlir_e2e_test.registry import register_benchmark_case
+from torch_mlir_e2e_test.annotations import annotate_args, export
+
+# ==============================================================================
+
+# Convolution layers of ResNet-50 at batch size 1, covering the stem, the
+# 1x1 and 3x3 convolutions of the bottleneck blocks in each stage, and a
+# strided 3x3 convolution.
+
+
+def _make_resnet50_conv_module(in_channels: int, out_channels: int,
+                               kernel_size: int, stride: int, size: int):
+    class ResNet50ConvModule(torch.nn.Module):
+        def __init__(self):
+            super().__init__()
+            torch.manual_seed(0)
+            self.conv = torch.nn.Conv2d(in_channels,
+                                        out_channels,
+                                        kernel_size,
+                                        stride=stride,
+                                        padding=kernel_size // 2,
+                                        bias=False)
+            self.train(False)
+
+        @export
+        @annotate_args([
+            None,
+            ([1, in_channels, size, size], torch.float32, True),
+        ])
+        def forward(self, x):
+            return self.conv(x)
+
+    return ResNet50ConvModule()
+
+
+@register_benchmark_case(
+    module_factory=lambda: _make_resnet50_conv_module(3, 64, 7, 2, 224))
+def ResNet50Conv_stem_7x7s2(module, tu: TestUtils):
+    module.forward(tu.rand(1, 3, 224, 224))
+
+
+@register_benchmark_case(
+    module_factory=lambda: _make_resnet50_conv_module(64, 64, 3, 1, 56))
+def ResNet50Conv_stage2_3x3(module, tu: TestUtils):
+    module.forward(tu.rand(1, 64, 56, 56))
+
+
+@register_benchmark_case(
+    module_factory=lambda: _make_resnet50_conv_module(64, 256, 1, 1, 56))
+def ResNet50Conv_stage2_1x1_expand(module, tu: TestUtils):
+    module.forward(tu.rand(1, 64, 56, 56))
+
+
+@register_benchmark_case(
+    module_factory=lambda: _make_resnet50_conv_module(128, 128, 3, 2, 56))
+def ResNet50Conv_stage3_3x3s2(module, tu: TestUtils):
+    module.forward(tu.rand(1, 128, 56, 56))
+
+
+@register_benchmark_case(
+    module_factory=lambda: _make_resnet50_conv_module(1024, 256, 1, 1, 14))
+def ResNet50Conv_stage4_1x1_reduce(module, tu: TestUtils):
+    module.forward(tu.rand(1, 1024, 14, 14))
+
+
+@register_benchmark_case(
+    module_factory=lambda: _make_resnet50_conv_module(512, 512, 3, 1, 7))
+def ResNet50Conv_stage5_3x3(module, tu: TestUtils):
+    module.forward(tu.rand(1, 512, 7, 7))
@@ -0,0 +1,83 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+import torch
+
+from torch_mlir_e2e_test.framework import TestUtils
+from torch_mlir_e2e_test.registry import register_benchmark_case
+from torch_mlir_e2e_test.annotations import annotate_args, export
+
+# ==============================================================================
+
+_NUM_EMBEDDINGS = 1000000
+_EMBEDDING_DIM = 32
+
+
+# The table is passed as an argument rather than held as a parameter, since a
+# parameter would be embedded in the compiled module as a 128 MB literal.
+class EmbeddingLookupModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([_NUM_EMBEDDINGS, _EMBEDDING_DIM], torch.float32, True),
+        ([64, 256], torch.int64, True),
+    ])
+    def forward(self, table, indices):
+        return torch.nn.functional.embedding(indices, table)
+
+
+# Random indices, so that nearly every lookup misses in cache, as for the
+# sparse features of a recommendation model.
+@register_benchmark_case(module_factory=lambda: EmbeddingLookupModule())
+def EmbeddingLookup_1Mx32_random(module, tu: TestUtils):
+    module.forward(tu.rand(_NUM_EMBEDDINGS, _EMBEDDING_DIM),
+                   tu.randint(64, 256, high=_NUM_EMBEDDINGS))
+
+# ==============================================================================
+
+# `index_select` and `index.Tensor` with a single 1-D index tensor gather whole
+# rows like `embedding` does. A quadratic row gather (e.g. one that copies the
+# whole result for every index) is already slow at this size.
+class IndexSelectRowsModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([_NUM_EMBEDDINGS, _EMBEDDING_DIM], torch.float32, True),
+        ([16384], torch.int64, True),
+    ])
+    def forward(self, table, indices):
+        return torch.index_select(table, 0, indices)
+
+
+@register_benchmark_case(module_factory=lambda: IndexSelectRowsModule())
+def IndexSelectRows_1Mx32_random(module, tu: TestUtils):
+    module.forward(tu.rand(_NUM_EMBEDDINGS, _EMBEDDING_DIM),
+                   tu.randint(16384, high=_NUM_EMBEDDINGS))
+
+
+class IndexTensorRowsModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([_NUM_EMBEDDINGS, _EMBEDDING_DIM], torch.float32, True),
+        ([16384], torch.int64, True),
+    ])
+    def forward(self, table, indices):
+        return torch.ops.aten.index(table, (indices,))
+
+
+@register_benchmark_case(module_factory=lambda: IndexTensorRowsModule())
+def IndexTensorRows_1Mx32_random(module, tu: TestUtils):
+    module.forward(tu.rand(_NUM_EMBEDDINGS, _EMBEDDING_DIM),
+                   tu.randint(16384, high=_NUM_EMBEDDINGS))
@@ -0,0 +1,71 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+import torch
+
+from torch_mlir_e2e_test.framework import TestUtils
+from torch_mlir_e2e_test.registry import register_benchmark_case
+from torch_mlir_e2e_test.annotations import annotate_args, export
+
+# ==============================================================================
+
+
+def _make_matmul_module(m: int, k: int, n: int):
+    class MatmulModule(torch.nn.Module):
+        def __init__(self):
+            super().__init__()
+
+        @export
+        @annotate_args([
+            None,
+            ([m, k], torch.float32, True),
+            ([k, n], torch.float32, True),
+        ])
+        def forward(self, lhs, rhs):
+            return torch.mm(lhs, rhs)
+
+    return MatmulModule()
+
+
+@register_benchmark_case(module_factory=lambda: _make_matmul_module(1024, 1024, 1024))
+def Matmul_1024x1024x1024(module, tu: TestUtils):
+    module.forward(tu.rand(1024, 1024), tu.rand(1024, 1024))
+
+
+@register_benchmark_case(module_factory=lambda: _make_matmul_module(2048, 2048, 2048))
+def Matmul_2048x2048x2048(module, tu: TestUtils):
+    module.forward(tu.rand(2048, 2048), tu.rand(2048, 2048))
+
+
+@register_benchmark_case(module_factory=lambda: _make_matmul_module(4096, 4096, 4096))
+def Matmul_4096x4096x4096(module, tu: TestUtils):
+    module.forward(tu.rand(4096, 4096), tu.rand(4096, 4096))
+
+
+# A skinny GEMM, as in the output projection of a transformer at small batch.
+@register_benchmark_case(module_factory=lambda: _make_matmul_module(128, 4096, 1024))
+def Matmul_128x4096x1024(module, tu: TestUtils):
+    module.forward(tu.rand(128, 4096), tu.rand(4096, 1024))
+
+# ==============================================================================
+
+
+class BatchMatmulModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([16, 1024, 1024], torch.float32, True),
+        ([16, 1024, 1024], torch.float32, True),
+    ])
+    def forward(self, lhs, rhs):
+        return torch.bmm(lhs, rhs)
+
+
+@register_benchmark_case(module_factory=lambda: BatchMatmulModule())
+def BatchMatmul_16x1024x1024x1024(module, tu: TestUtils):
+    module.forward(tu.rand(16, 1024, 1024), tu.rand(16, 1024, 1024))
@@ -0,0 +1,95 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+
+import math
+
+import torch
+
+from torch_mlir_e2e_test.framework import TestUtils
+from torch_mlir_e2e_test.registry import register_benchmark_case
+from torch_mlir_e2e_test.annotations import annotate_args, export
+
+# ==============================================================================
+
+# BERT-base dimensions.
+_HIDDEN = 768
+_HEADS = 12
+_INTERMEDIATE = 3072
+_SEQ_LEN = 384
+
+
+class BertEncoderBlockModule(torch.nn.Module):
+    """A single post-LayerNorm BERT encoder layer, written out with the ops
+    the importer sees for it rather than `torch.nn.TransformerEncoderLayer`.
+    """
+    def __init__(self):
+        super().__init__()
+        torch.manual_seed(0)
+        self.query = torch.nn.Linear(_HIDDEN, _HIDDEN)
+        self.key = torch.nn.Linear(_HIDDEN, _HIDDEN)
+        self.value = torch.nn.Linear(_HIDDEN, _HIDDEN)
+        self.attention_output = torch.nn.Linear(_HIDDEN, _HIDDEN)
+        self.attention_norm = torch.nn.LayerNorm(_HIDDEN)
+        self.intermediate = torch.nn.Linear(_HIDDEN, _INTERMEDIATE)
+        self.output = torch.nn.Linear(_INTERMEDIATE, _HIDDEN)
+        self.output_norm = torch.nn.LayerNorm(_HIDDEN)
+        self.train(False)
+
+    def _split_heads(self, x):
+        x = x.view(1, _SEQ_LEN, _HEADS, _HIDDEN // _HEADS)
+        return x.permute(0, 2, 1, 3)
+
+    @export
+    @annotate_args([
+        None,
+        ([1, _SEQ_LEN, _HIDDEN], torch.float32, True),
+    ])
+    def forward(self, hidden):
+        q = self._split_heads(self.query(hidden))
+        k = self._split_heads(self.key(hidden))
+        v = self._split_heads(self.value(hidden))
+        scores = torch.matmul(q, k.transpose(-1, -2))
+        scores = scores / math.sqrt(_HIDDEN // _HEADS)
+        probs = torch.softmax(scores, dim=-1)
+        context = torch.matmul(probs, v).permute(0, 2, 1, 3)
+        context = context.reshape(1, _SEQ_LEN, _HIDDEN)
+        attention = self.attention_norm(
+            self.attention_output(context) + hidden)
+        intermediate = torch.nn.functional.gelu(self.intermediate(attention))
+        return self.output_norm(self.output(intermediate) + attention)
+
+
+@register_benchmark_case(module_factory=lambda: BertEncoderBlockModule())
+def BertBaseEncoderBlock_seq384(module, tu: TestUtils):
+    module.forward(tu.rand(1, _SEQ_LEN, _HIDDEN))
+
+# ==============================================================================
+
+
+def _make_softmax_module(rows: int, seq_len: int):
+    class SoftmaxModule(torch.nn.Module):
+        def __init__(self):
+            super().__init__()
+
+        @export
+        @annotate_args([
+            None,
+            ([rows, seq_len], torch.float32, True),
+        ])
+        def forward(self, x):
+            return torch.softmax(x, dim=-1)
+
+    return SoftmaxModule()
+
+
+# Attention scores of a long-context model: one row per (head, query) pair.
+@register_benchmark_case(module_factory=lambda: _make_softmax_module(1024, 8192))
+def Softmax_1024x8192(module, tu: TestUtils):
+    module.forward(tu.rand(1024, 8192))
+
+
+@register_benchmark_case(module_factory=lambda: _make_softmax_module(64, 65536))
+def Softmax_64x65536(module, tu: TestUtils):
+    module.forward(tu.rand(64, 65536))
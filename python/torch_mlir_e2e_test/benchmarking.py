@@ -0,0 +1,285 @@
+# Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+# Also available under a BSD-style license. See LICENSE.
+"""
+Benchmarking mode for the test framework.
+
+Instead of checking the results of a `Test`, this measures how long a
+`TestConfig` takes to compile it and to run its trace:
+
+- compile time: `TestConfig.compile` on a fresh instance of the program.
+- first call: the first `TestConfig.run` of the golden trace, which includes
+  any loading or lazy initialization the backend does.
+- steady state: `TestConfig.run` of the golden trace after `warmup` further
+  runs, repeated `repetitions` times.
+
+Since the measurements only go through the `TestConfig` interface, every
+config can be benchmarked, and the numbers of two configs (or of the same
+config at two revisions) are directly comparable.
+"""
+
+from typing import Any, Dict, List, NamedTuple, Optional
+
+import json
+import multiprocessing as mp
+import statistics
+import sys
+import time
+import traceback
+
+import torch
+
+from .framework import Test, TestConfig, clone_trace, generate_golden_trace
+
+
+class BenchmarkResult(NamedTuple):
+    # Should match Test.unique_name for corresponding test.
+    unique_name: str
+    # If compiling or running failed, a string describing the failure.
+    # If this is not None, then the timing fields are None.
+    error: Optional[str]
+    # Seconds spent in `TestConfig.compile`.
+    compile_time: Optional[float]
+    # Seconds spent in the first `TestConfig.run`.
+    first_call_time: Optional[float]
+    # Seconds spent in each steady-state `TestConfig.run`.
+    steady_state_times: Optional[List[float]]
+
+
+def benchmark_test(test: Test, config: TestConfig, warmup: int,
+                   repetitions: int, verbose=False) -> BenchmarkResult:
+    try:
+        golden_trace = generate_golden_trace(test)
+        program = test.program_factory()
+        if verbose:
+            print(f"Compiling {test.unique_name}...", file=sys.stderr)
+        start = time.perf_counter()
+        compiled = config.compile(program)
+        compile_time = time.perf_counter() - start
+
+        def timed_run():
+            # Tests may mutate their inputs in place, so every run gets its
+            # own copy. The copy is made outside of the timed region.
+            trace = clone_trace(golden_trace)
+            start = time.perf_counter()
+            config.run(compiled, trace)
+            return time.perf_counter() - start
+
+        if verbose:
+            print(f"Running {test.unique_name}...", file=sys.stderr)
+        first_call_time = timed_run()
+        for _ in range(warmup):
+            timed_run()
+        steady_state_times = [timed_run() for _ in range(repetitions)]
+    except Exception as e:
+        return BenchmarkResult(unique_name=test.unique_name,
+                               error="".join(
+                                   traceback.format_exception(
+                                       type(e), e, e.__traceback__)),
+                               compile_time=None,
+                               first_call_time=None,
+                               steady_state_times=None)
+    return BenchmarkResult(unique_name=test.unique_name,
+                           error=None,
+                           compile_time=compile_time,
+                           first_call_time=first_call_time,
+                           steady_state_times=steady_state_times)
+
+
+def _benchmark_test_and_send(sender, test: Test, config: TestConfig,
+                             warmup: int, repetitions: int, verbose: bool):
+    sender.send(benchmark_test(test, config, warmup, repetitions, verbose))
+    sender.close()
+
+
+def _benchmark_test_in_subprocess(test: Test, config: TestConfig, warmup: int,
+                                  repetitions: int,
+                                  verbose: bool) -> BenchmarkResult:
+    receiver, sender = mp.Pipe(duplex=False)
+    process = mp.Process(target=_benchmark_test_and_send,
+                         args=(sender, test, config, warmup, repetitions,
+                               verbose))
+    process.start()
+    # Only the child holds the sending end now, so `recv` sees the end of the
+    # pipe if the child dies without sending a result.
+    sender.close()
+    try:
+        result = receiver.recv()
+    except EOFError:
+        result = BenchmarkResult(
+            unique_name=test.unique_name,
+            error="Benchmark process terminated. Either the compiler crashed "
+            "or the compiled code crashed at runtime.\n",
+            compile_time=None,
+            first_call_time=None,
+            steady_state_times=None)
+    process.join()
+    receiver.close()
+    return result
+
+
+def run_benchmarks(tests: List[Test], config: TestConfig, warmup=3,
+                   repetitions=10, verbose=False,
+                   isolate=True) -> List[BenchmarkResult]:
+    """Benchmark the given `Test`'s with the provided `TestConfig`.
+
+    Unlike `run_tests`, this always runs one test at a time, since tests
+    running concurrently would skew each other's timings. With `isolate`, each
+    test runs in its own process, so that a test that crashes is reported as
+    an error instead of aborting the whole run.
+    """
+    assert repetitions > 0, "at least one steady-state repetition is needed"
+    tests = list(sorted(tests, key=lambda t: t.unique_name))
+    if not isolate:
+        return [
+            benchmark_test(test, config, warmup, repetitions, verbose)
+            for test in tests
+        ]
+    # This is needed because autograd does not support crossing process
+    # boundaries.
+    torch.autograd.set_grad_enabled(False)
+    return [
+        _benchmark_test_in_subprocess(test, config, warmup, repetitions,
+                                      verbose) for test in tests
+    ]
+
+
+# The metrics compared against the baseline.
+_METRICS = ["compile_time", "first_call_time", "steady_state_median"]
+
+# The settings that the results of two runs are only comparable under.
+_SETTINGS = ["config", "warmup", "repetitions"]
+
+
+def _median_absolute_deviation(times: List[float]) -> float:
+    median = statistics.median(times)
+    return statistics.median(abs(t - median) for t in times)
+
+
+def _result_to_json(result: BenchmarkResult) -> Dict[str, Any]:
+    if result.error is not None:
+        return {"error": result.error}
+    return {
+        "compile_time": result.compile_time,
+        "first_call_time": result.first_call_time,
+        "steady_state_median": statistics.median(result.steady_state_times),
+        "steady_state_min": min(result.steady_state_times),
+        "steady_state_spread": _median_absolute_deviation(
+            result.steady_state_times),
+        "steady_state_times": result.steady_state_times,
+    }
+
+
+def _is_regression(metric: str, result: Dict[str, Any], base: Dict[str, Any],
+                   regression_threshold: float) -> bool:
+    """A metric regresses if it is slower than the baseline by more than
+    `regression_threshold`. The steady-state median must also be slower by
+    more than the spread (median absolute deviation) of both runs, so that
+    noisy tests are not reported."""
+    slowdown = result[metric] - base[metric]
+    if slowdown <= regression_threshold * base[metric]:
+        return False
+    if metric == "steady_state_median":
+        noise = (result["steady_state_spread"] +
+                 base.get("steady_state_spread", 0.0))
+        return slowdown > noise
+    return True
+
+
+def benchmark_results_to_json(results: List[BenchmarkResult], config: str,
+                              warmup: int,
+                              repetitions: int) -> Dict[str, Any]:
+    """Convert the results to the JSON format read by `report_benchmarks`."""
+    return {
+        "config": config,
+        "warmup": warmup,
+        "repetitions": repetitions,
+        "results": {
+            result.unique_name: _result_to_json(result)
+            for result in results
+        },
+    }
+
+
+def report_benchmarks(results: Dict[str, Any],
+                      baseline: Optional[Dict[str, Any]] = None,
+                      regression_threshold=0.1,
+                      verbose=False,
+                      skipped: Optional[List[str]] = None) -> bool:
+    """Print a summary of the results from `benchmark_results_to_json`.
+
+    If `baseline` is given (in the same format), every metric is also compared
+    against it, and a metric that is slower by more than
+    `regression_threshold` (as a fraction of the baseline) is reported as a
+    regression. The steady-state median must also be slower by more than the
+    spread of both runs. A baseline recorded with a different config, warmup
+    or number of repetitions is not compared against, and fails the run.
+    `skipped` names the tests that were not benchmarked because they are
+    expected to fail; they are reported but are not failures.
+
+    Returns True if any benchmark failed to run or regressed, or if the
+    baseline is not comparable.
+    """
+    if baseline is not None:
+        mismatches = [
+            f"{setting} {baseline.get(setting)!r} (now {results[setting]!r})"
+            for setting in _SETTINGS
+            if baseline.get(setting) != results[setting]
+        ]
+        if mismatches:
+            print("ERROR: the baseline was recorded with different settings: "
+                  f"{', '.join(mismatches)}")
+            return True
+    baseline_results = baseline["results"] if baseline is not None else {}
+    num_errors = 0
+    regressions = []
+    for name, result in sorted(results["results"].items()):
+        if "error" in result:
+            num_errors += 1
+            print(f"    ERROR - {name!r}")
+            if verbose:
+                print(result["error"])
+            continue
+        line = (f"{name}: compile {result['compile_time']:.4f}s, "
+                f"first call {result['first_call_time']:.6f}s, "
+                f"steady state {result['steady_state_median']:.6f}s")
+        base = baseline_results.get(name)
+        if base is None or "error" in base:
+            print(f"    {line}")
+            continue
+        ratios = []
+        for metric in _METRICS:
+            ratio = result[metric] / base[metric] if base[metric] else 1.0
+            ratios.append(f"{metric} x{ratio:.2f}")
+            if _is_regression(metric, result, base, regression_threshold):
+                regressions.append((name, metric, ratio))
+        print(f"    {line} ({', '.join(ratios)})")
+
+    skipped = sorted(skipped or [])
+    if verbose:
+        for name in skipped:
+            print(f"    SKIPPED - {name!r} (expected to fail)")
+
+    print("\nSummary:")
+    print(f"    Benchmarked {len(results['results'])} tests")
+    if skipped:
+        print(f"    Skipped {len(skipped)} tests expected to fail")
+    if num_errors:
+        print(f"    Failed to run {num_errors} tests")
+    if baseline is not None:
+        print(f"    Found {len(regressions)} regressions beyond "
+              f"{regression_threshold:.0%} of the baseline")
+        for name, metric, ratio in regressions:
+            print(f"        {name}: {metric} x{ratio:.2f}")
+    return num_errors != 0 or len(regressions) != 0
+
+
+def write_benchmark_json(results: Dict[str, Any], path: str):
+    with open(path, "w") as f:
+        json.dump(results, f, indent=2, sort_keys=True)
+
+
+def read_benchmark_json(path: str) -> Dict[str, Any]:
+    with open(path) as f:
+        return json.load(f)
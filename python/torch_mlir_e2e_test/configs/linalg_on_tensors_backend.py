@@ -3,13 +3,14 @@
 # SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 # Also available under a BSD-style license. See LICENSE.
 
-from typing import Any
+from typing import Any, Optional
 
 import torch
 import torch_mlir
 
 from torch_mlir_e2e_test.linalg_on_tensors_backends.abc import LinalgOnTensorsBackend
 from torch_mlir_e2e_test.framework import TestConfig, Trace, TraceItem
+from torch_mlir_e2e_test.artifact_cache import ArtifactCache
 from torch_mlir_e2e_test.utils import convert_annotations_to_placeholders
 
 from .utils import (
@@ -24,15 +25,19 @@ class LinalgOnTensorsBackendTestConfig(TestConfig):
     This class handles all the common lowering that torch-mlir does before
     reaching the linalg-on-tensors abstraction level.
     """
-    def __init__(self, backend: LinalgOnTensorsBackend):
+    def __init__(self, backend: LinalgOnTensorsBackend,
+                 artifact_cache: Optional[ArtifactCache] = None):
         super().__init__()
         self.backend = backend
+        self.artifact_cache = artifact_cache
 
     def compile(self, program: torch.nn.Module) -> Any:
         example_args = convert_annotations_to_placeholders(program.forward)
         module = torch_mlir.compile(
             program, example_args, output_type="linalg-on-tensors")
 
+        if self.artifact_cache is not None:
+            return self.artifact_cache.compile(self.backend, module)
         return self.backend.compile(module)
 
 
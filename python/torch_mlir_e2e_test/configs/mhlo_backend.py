@@ -3,7 +3,7 @@
 # SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 # Also available under a BSD-style license. See LICENSE.
 
-from typing import Any
+from typing import Any, Optional
 
 import torch
 import torch_mlir
@@ -14,6 +14,7 @@ from torch_mlir_e2e_test.framework import (
     Trace,
     TraceItem
 )
+from torch_mlir_e2e_test.artifact_cache import ArtifactCache
 from torch_mlir_e2e_test.utils import convert_annotations_to_placeholders
 from .utils import (
     recursively_convert_to_numpy,
@@ -27,15 +28,19 @@ class MhloBackendTestConfig(TestConfig):
     This class handles all the common lowering that torch-mlir does before
     reaching the linalg-on-tensors abstraction level.
     """
-    def __init__(self, backend: MhloBackend):
+    def __init__(self, backend: MhloBackend,
+                 artifact_cache: Optional[ArtifactCache] = None):
         super().__init__()
         self.backend = backend
+        self.artifact_cache = artifact_cache
 
     def compile(self, program: torch.nn.Module) -> Any:
         example_args = convert_annotations_to_placeholders(program.forward)
         module = torch_mlir.compile(
             program, example_args, output_type="mhlo")
 
+        if self.artifact_cache is not None:
+            return self.artifact_cache.compile(self.backend, module)
         return self.backend.compile(module)
 
     def run(self, artifact: Any, trace: Trace) -> Trace:
@@ -324,6 +324,9 @@ def run_tests(tests: List[Test], config: TestConfig, sequential=False, verbose=F
     # hack to work around this issue.
     # Also our multiprocessing implementation is not the most efficient, so
     # the benefit at core count 2 is probably not worth it anyway.
+    # The artifact cache does not help here: it caches the output of
+    # `backend.compile`, while the LLVM code generation happens when the
+    # ExecutionEngine is created in `backend.load`, on every run.
     if mp.cpu_count() == 2:
         num_processes = 1
 
@@ -4,6 +4,9 @@
 # Also available under a BSD-style license. See LICENSE.
 
 import ctypes
+import threading
+from typing import Dict, Optional
+
 import numpy as np
 
 from torch_mlir.ir import *
@@ -17,6 +20,7 @@ from .abc import LinalgOnTensorsBackend
 
 __all__ = [
     "RefBackendLinalgOnTensorsBackend",
+    "create_rng_state",
 ]
 
 
@@ -76,33 +80,99 @@ def get_ctype_func(func_name):
     return ctypes.CFUNCTYPE(*ctypes_arg), ret_types
 
 
+def create_rng_state(seed: int = 0) -> np.ndarray:
+    """Creates an RNG state to pass to an invocation of a compiled module.
+
+    Invocations starting from equal states produce the same random numbers.
+    A state is advanced by each invocation using it, so it must not be shared
+    by invocations running concurrently.
+    """
+    return np.array(seed, dtype=np.int64)
+
+
 class RefBackendInvoker:
 
     def __init__(self, module):
         self.ee = ExecutionEngine(module)
-        self.result = None
+        # Results are handed back through a callback, so they are kept per
+        # thread to allow concurrent invocations.
+        self._thread_local = threading.local()
+        with module.context:
+            self.has_rng_state = \
+                "refback.rng_state" in module.operation.attributes
+            # The names of the weights that each function takes as trailing
+            # arguments, if it was compiled with weights as arguments.
+            self.weight_argument_names = {}
+            if "torch.weight_arguments" in module.operation.attributes:
+                weight_arguments = DictAttr(
+                    module.operation.attributes["torch.weight_arguments"])
+                for i in range(len(weight_arguments)):
+                    named = weight_arguments[i]
+                    self.weight_argument_names[named.name] = [
+                        StringAttr(name).value
+                        for name in ArrayAttr(named.attr)
+                    ]
+        self._weights = {}
 
         return_funcs = get_return_funcs(module)
 
         for ret_func in return_funcs:
             ctype_wrapper, ret_types = get_ctype_func(ret_func)
 
-            def consume_return_funcs(*args):
-                self.result = tuple([
+            def consume_return_funcs(*args, ret_types=ret_types):
+                result = tuple([
                     arg if type in elemental_type_to_ctype
                     else unranked_memref_to_numpy(
                         arg, memref_type_to_np_dtype[type])
                     for arg, type in zip(args, ret_types)
                 ])
-                if len(self.result) == 1:
-                    self.result = self.result[0]
+                if len(result) == 1:
+                    result = result[0]
+                self._thread_local.result = result
 
             self.ee.register_runtime(ret_func,
                                      ctype_wrapper(consume_return_funcs))
 
+    def bind_weights(self, weights: Dict[str, np.ndarray]):
+        """Binds the values of the weights that are passed as arguments.
+
+        `weights` maps the names in `torch.weight_arguments` (the keys of the
+        original model's `state_dict()`) to their values. They are passed to
+        every later invocation, after the caller's arguments.
+        """
+        self._weights.update(weights)
+
+    def seed(self, seed: int):
+        """Reseeds the RNG state used by default from the calling thread."""
+        self._thread_local.rng_state = create_rng_state(seed)
+
+    def _default_rng_state(self):
+        if getattr(self._thread_local, "rng_state", None) is None:
+            self.seed(0)
+        return self._thread_local.rng_state
+
     def __getattr__(self, function_name: str):
 
-        def invoke(*args):
+        def invoke(*args, rng_state: Optional[np.ndarray] = None):
+            """Invokes the function.
+
+            `rng_state`, as created by `create_rng_state`, is the state used
+            by random ops. It defaults to a state owned by the calling thread.
+            """
+            weight_names = self.weight_argument_names.get(function_name, [])
+            if weight_names:
+                missing = [n for n in weight_names if n not in self._weights]
+                if missing:
+                    raise Exception(
+                        f"Weights {missing} of '{function_name}' were not "
+                        f"bound with `bind_weights`")
+                args = (*args, *(self._weights[n] for n in weight_names))
+            if self.has_rng_state:
+                if rng_state is None:
+                    rng_state = self._default_rng_state()
+                assert rng_state.dtype == np.int64 and rng_state.shape == (), \
+                    "The RNG state must be created with `create_rng_state`"
+                args = (*args, rng_state)
             ffi_args = []
             for arg in args:
                 assert_arg_type_is_supported(arg.dtype)
@@ -110,16 +180,20 @@ class RefBackendInvoker:
                     ctypes.pointer(
                         ctypes.pointer(get_unranked_memref_descriptor(arg))))
 
+            self._thread_local.result = None
             self.ee.invoke(function_name, *ffi_args)
-            result = self.result
+            result = self._thread_local.result
             assert result is not None, "Invocation didn't produce a result"
-            self.result = None
+            self._thread_local.result = None
             return result
 
         return invoke
 
 
 LOWERING_PIPELINE = "builtin.module(" + ",".join([
+    # Convolutions read their unpadded input directly instead of a padded
+    # copy of it.
+    "func.func(refback-fold-conv-padding)",
     "func.func(refback-generalize-tensor-pad)",
     # Apply some optimizations. It would be great if MLIR had more useful
     # optimizations that worked out of the box here.
@@ -137,8 +211,14 @@ LOWERING_PIPELINE = "builtin.module(" + ",".join([
     "func-bufferize",
     "arith-bufferize",
     "refback-mlprogram-bufferize",
+    # Pass the RNG state in from the caller instead of keeping it in a
+    # global, so that the module can be invoked from several threads.
+    "refback-insert-rng-state-argument",
     "func.func(tensor-bufferize)",
     "func.func(finalizing-bufferize)",
+    # Let the producers of concatenated tensors write straight into the
+    # result buffer instead of copying them into it.
+    "func.func(refback-elide-insert-slice-copies)",
     "func.func(buffer-deallocation)",
     # Munge to make it ExecutionEngine compatible.
     # Specifically, we rewrite calling convention boundaries to be in terms
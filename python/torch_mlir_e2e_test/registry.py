@@ -11,30 +11,47 @@ from .framework import Test
 
 # The global registry of tests.
 GLOBAL_TEST_REGISTRY = []
-# Ensure that there are no duplicate names in the global test registry.
+# The global registry of performance workloads. These are `framework.Test`'s
+# too, but use production-scale shapes, so they are kept separate from the
+# correctness tests and are only run when benchmarking.
+GLOBAL_BENCHMARK_REGISTRY = []
+# Ensure that there are no duplicate names in the global registries.
 _SEEN_UNIQUE_NAMES = set()
 
 
-def register_test_case(module_factory: Callable[[], torch.nn.Module]):
-    """Convenient decorator-based test registration.
-
-    Adds a `framework.Test` to the global test registry based on the decorated
-    function. The test's `unique_name` is taken from the function name, the
-    test's `program_factory` is taken from `module_factory`, and the
-    `program_invoker` is the decorated function.
-    """
+def _make_registration_decorator(registry, decorator_name: str,
+                                 module_factory: Callable[[], torch.nn.Module]):
     def decorator(f):
-        # Ensure that there are no duplicate names in the global test registry.
+        # Ensure that there are no duplicate names in the global registries.
         if f.__name__ in _SEEN_UNIQUE_NAMES:
             raise Exception(
-                f"Duplicate test name: '{f.__name__}'. Please make sure that the function wrapped by `register_test_case` has a unique name.")
+                f"Duplicate test name: '{f.__name__}'. Please make sure that the function wrapped by `{decorator_name}` has a unique name.")
         _SEEN_UNIQUE_NAMES.add(f.__name__)
 
         # Store the test in the registry.
-        GLOBAL_TEST_REGISTRY.append(
+        registry.append(
             Test(unique_name=f.__name__,
                  program_factory=module_factory,
                  program_invoker=f))
         return f
 
     return decorator
+
+
+def register_test_case(module_factory: Callable[[], torch.nn.Module]):
+    """Convenient decorator-based test registration.
+
+    Adds a `framework.Test` to the global test registry based on the decorated
+    function. The test's `unique_name` is taken from the function name, the
+    test's `program_factory` is taken from `module_factory`, and the
+    `program_invoker` is the decorated function.
+    """
+    return _make_registration_decorator(GLOBAL_TEST_REGISTRY,
+                                        "register_test_case", module_factory)
+
+
+def register_benchmark_case(module_factory: Callable[[], torch.nn.Module]):
+    """Like `register_test_case`, but for the benchmark registry."""
+    return _make_registration_decorator(GLOBAL_BENCHMARK_REGISTRY,
+                                        "register_benchmark_case",
+                                        module_factory)
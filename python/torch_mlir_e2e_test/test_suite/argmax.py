@@ -63,3 +63,25 @@ class ArgmaxKeepDimsModule(torch.nn.Module):
 @register_test_case(module_factory=lambda: ArgmaxKeepDimsModule())
 def ArgmaxModule_keepDim(module, tu: TestUtils):
     module.forward(tu.rand(4, 6))
+
+# ==============================================================================
+
+class ArgmaxLargeDimModule(torch.nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([2, 5000], torch.float32, True),
+    ])
+    def forward(self, a):
+        return torch.argmax(a, dim=1)
+
+@register_test_case(module_factory=lambda: ArgmaxLargeDimModule())
+def ArgmaxModule_largeDim(module, tu: TestUtils):
+    a = tu.rand(2, 5000)
+    # Ties across tiles resolve to the first index.
+    a[0, 3000] = 2.0
+    a[0, 4000] = 2.0
+    module.forward(a)
@@ -2956,6 +2956,96 @@ def AtenEmbeddingBagSumExample_basic(module, tu: TestUtils):
     offsets = torch.LongTensor([0, 3, 5, 7, 9, 10, 15])
     module.forward(weight, indices, offsets)
 
+class AtenEmbeddingBagMeanExample(torch.nn.Module):
+
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1], torch.float32, True),
+        ([-1], torch.int64, True),
+        ([-1], torch.int64, True),
+    ])
+    def forward(self, weight, indices, offsets):
+        return torch.ops.aten.embedding_bag(weight, indices, offsets, scale_grad_by_freq=False, mode=1, sparse=False, per_sample_weights=None, include_last_offset=False, padding_idx=2)[0]
+
+@register_test_case(module_factory=lambda: AtenEmbeddingBagMeanExample())
+def AtenEmbeddingBagMeanExample_basic(module, tu: TestUtils):
+    weight  = torch.rand(100, 10)
+    indices = torch.LongTensor([0, 1, 2, 2, 0, 2, 1, 3, 20, 50, 99, 2, 4, 5, 6, 7, 34, 54])
+    offsets = torch.LongTensor([0, 3, 5, 7, 9, 10, 15])
+    module.forward(weight, indices, offsets)
+
+class AtenEmbeddingBagMaxExample(torch.nn.Module):
+
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1], torch.float32, True),
+        ([-1], torch.int64, True),
+        ([-1], torch.int64, True),
+    ])
+    def forward(self, weight, indices, offsets):
+        return torch.ops.aten.embedding_bag(weight, indices, offsets, scale_grad_by_freq=False, mode=2, sparse=False, per_sample_weights=None, include_last_offset=True, padding_idx=None)[0]
+
+@register_test_case(module_factory=lambda: AtenEmbeddingBagMaxExample())
+def AtenEmbeddingBagMaxExample_basic(module, tu: TestUtils):
+    weight  = torch.rand(100, 10)
+    indices = torch.LongTensor([0, 1, 2, 2, 0, 2, 1, 3, 20, 50, 99, 2, 4, 5, 6, 7, 34, 54])
+    offsets = torch.LongTensor([0, 3, 5, 7, 9, 10, 15, 18])
+    module.forward(weight, indices, offsets)
+
+class AtenEmbeddingBagMaxEmptyBagExample(torch.nn.Module):
+
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1], torch.float32, True),
+        ([-1], torch.int64, True),
+        ([-1], torch.int64, True),
+    ])
+    def forward(self, weight, indices, offsets):
+        return torch.ops.aten.embedding_bag(weight, indices, offsets, scale_grad_by_freq=False, mode=2, sparse=False, per_sample_weights=None, include_last_offset=True, padding_idx=None)[0]
+
+@register_test_case(module_factory=lambda: AtenEmbeddingBagMaxEmptyBagExample())
+def AtenEmbeddingBagMaxEmptyBagExample_basic(module, tu: TestUtils):
+    weight  = torch.rand(100, 10)
+    weight[20, 3] = float("nan")
+    indices = torch.LongTensor([0, 1, 2, 2, 0, 2, 1, 3, 20, 50, 99, 2, 4, 5, 6, 7, 34, 54])
+    offsets = torch.LongTensor([0, 3, 3, 7, 9, 9, 15, 18])
+    module.forward(weight, indices, offsets)
+
+class AtenEmbeddingBagPerSampleWeightsExample(torch.nn.Module):
+
+    def __init__(self):
+        super().__init__()
+
+    @export
+    @annotate_args([
+        None,
+        ([-1, -1], torch.float32, True),
+        ([-1], torch.int64, True),
+        ([-1], torch.int64, True),
+        ([-1], torch.float32, True),
+    ])
+    def forward(self, weight, indices, offsets, per_sample_weights):
+        return torch.ops.aten.embedding_bag(weight, indices, offsets, scale_grad_by_freq=False, mode=0, sparse=False, per_sample_weights=per_sample_weights, include_last_offset=False, padding_idx=None)[0]
+
+@register_test_case(module_factory=lambda: AtenEmbeddingBagPerSampleWeightsExample())
+def AtenEmbeddingBagPerSampleWeightsExample_basic(module, tu: TestUtils):
+    weight  = torch.rand(100, 10)
+    indices = torch.LongTensor([0, 1, 2, 2, 0, 2, 1, 3, 20, 50, 99, 2, 4, 5, 6, 7, 34, 54])
+    offsets = torch.LongTensor([0, 3, 5, 7, 9, 10, 15])
+    module.forward(weight, indices, offsets, tu.rand(18))
+
 class Aten_EmbeddingBagExample(torch.nn.Module):
 
     def __init__(self):
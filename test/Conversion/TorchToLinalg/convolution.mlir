@@ -0,0 +1,48 @@
+// RUN: torch-mlir-opt <%s -convert-torch-to-linalg -split-input-file -verify-diagnostics | FileCheck %s
+
+// Strided transposed convolutions are lowered to a GEMM over the input
+// channels followed by a col2im gather, without a zero-inserted input.
+// CHECK-LABEL: func @conv_transpose2d_strided
+// CHECK-NOT:     tensor.insert_slice
+// CHECK:         %[[COLS:.*]] = linalg.generic {{.*}} iterator_types = ["parallel", "parallel", "parallel", "parallel", "parallel", "parallel", "reduction"]} ins(%{{.*}}, %{{.*}} : tensor<1x8x4x4xf32>, tensor<8x3x4x4xf32>) outs(%{{.*}} : tensor<1x3x4x4x4x4xf32>)
+// CHECK:           arith.mulf
+// CHECK:           arith.addf
+// CHECK:         %[[KERNEL:.*]] = tensor.empty() : tensor<4x4xf32>
+// CHECK:         %[[RESULT:.*]] = linalg.generic {{.*}} iterator_types = ["parallel", "parallel", "parallel", "parallel", "reduction", "reduction"]} ins(%[[KERNEL]] : tensor<4x4xf32>)
+// CHECK:           arith.remsi
+// CHECK:           %[[TAP:.*]] = tensor.extract %[[COLS]]
+// CHECK:           arith.select %{{.*}}, %[[TAP]], %{{.*}} : f32
+// CHECK:           arith.addf
+// CHECK-NOT:     linalg.conv_2d_nchw_fchw
+func.func @conv_transpose2d_strided(%arg0: !torch.vtensor<[1,8,4,4],f32>, %arg1: !torch.vtensor<[8,3,4,4],f32>) -> !torch.vtensor<[1,3,8,8],f32> {
+  %none = torch.constant.none
+  %true = torch.constant.bool true
+  %int0 = torch.constant.int 0
+  %int1 = torch.constant.int 1
+  %int2 = torch.constant.int 2
+  %stride = torch.prim.ListConstruct %int2, %int2 : (!torch.int, !torch.int) -> !torch.list<int>
+  %padding = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %dilation = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %output_padding = torch.prim.ListConstruct %int0, %int0 : (!torch.int, !torch.int) -> !torch.list<int>
+  %0 = torch.aten.convolution %arg0, %arg1, %none, %stride, %padding, %dilation, %true, %output_padding, %int1 : !torch.vtensor<[1,8,4,4],f32>, !torch.vtensor<[8,3,4,4],f32>, !torch.none, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.bool, !torch.list<int>, !torch.int -> !torch.vtensor<[1,3,8,8],f32>
+  return %0 : !torch.vtensor<[1,3,8,8],f32>
+}
+
+// -----
+
+// Unit-stride transposed convolutions need no zero insertion and keep using
+// the padded convolution.
+// CHECK-LABEL: func @conv_transpose2d_unit_stride
+// CHECK:         linalg.conv_2d_nchw_fchw
+func.func @conv_transpose2d_unit_stride(%arg0: !torch.vtensor<[1,8,4,4],f32>, %arg1: !torch.vtensor<[8,3,3,3],f32>) -> !torch.vtensor<[1,3,6,6],f32> {
+  %none = torch.constant.none
+  %true = torch.constant.bool true
+  %int0 = torch.constant.int 0
+  %int1 = torch.constant.int 1
+  %stride = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %padding = torch.prim.ListConstruct %int0, %int0 : (!torch.int, !torch.int) -> !torch.list<int>
+  %dilation = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %output_padding = torch.prim.ListConstruct %int0, %int0 : (!torch.int, !torch.int) -> !torch.list<int>
+  %0 = torch.aten.convolution %arg0, %arg1, %none, %stride, %padding, %dilation, %true, %output_padding, %int1 : !torch.vtensor<[1,8,4,4],f32>, !torch.vtensor<[8,3,3,3],f32>, !torch.none, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.bool, !torch.list<int>, !torch.int -> !torch.vtensor<[1,3,6,6],f32>
+  return %0 : !torch.vtensor<[1,3,6,6],f32>
+}
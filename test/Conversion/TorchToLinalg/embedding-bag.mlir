@@ -0,0 +1,81 @@
+// RUN: torch-mlir-opt <%s -convert-torch-to-linalg -split-input-file -verify-diagnostics | FileCheck %s
+
+// Each bag is reduced by a loop over its own indices, inside a generic that is
+// parallel over the bags and the embedding dimension.
+// CHECK-LABEL: func @embedding_bag_mean
+// CHECK:         %[[RESULT:.*]] = linalg.generic {{.*}} iterator_types = ["parallel", "parallel"]} outs(%{{.*}} : tensor<7x10xf32>)
+// CHECK:           %[[BAG:.*]] = linalg.index 0 : index
+// CHECK:           %[[COL:.*]] = linalg.index 1 : index
+// CHECK:           %[[SUM:.*]]:2 = scf.for %[[POS:.*]] = %{{.*}} to %{{.*}} step %{{.*}} iter_args(%[[ACC:.*]] = %{{.*}}, %[[COUNT:.*]] = %{{.*}}) -> (f32, index) {
+// CHECK:             %[[ROW:.*]] = tensor.extract %{{.*}}[%[[POS]]] : tensor<18xi64>
+// CHECK:             %[[ELEM:.*]] = tensor.extract %{{.*}}[%{{.*}}, %[[COL]]] : tensor<100x10xf32>
+// CHECK:             %[[NEW_COUNT:.*]] = arith.addi %[[COUNT]], %{{.*}} : index
+// CHECK:             %[[NEW_ACC:.*]] = arith.addf %[[ACC]], %[[ELEM]] : f32
+// CHECK:             %[[IS_PADDING:.*]] = arith.cmpi eq, %[[ROW]], %{{.*}} : i64
+// CHECK:             arith.select %[[IS_PADDING]], %[[ACC]], %[[NEW_ACC]] : f32
+// CHECK:             arith.select %[[IS_PADDING]], %[[COUNT]], %[[NEW_COUNT]] : index
+// CHECK:             scf.yield
+// CHECK:           arith.maxui %[[SUM]]#1, %{{.*}} : index
+// CHECK:           arith.divf
+func.func @embedding_bag_mean(%weight: !torch.vtensor<[100,10],f32>, %indices: !torch.vtensor<[18],si64>, %offsets: !torch.vtensor<[7],si64>) -> !torch.vtensor<[7,10],f32> {
+  %false = torch.constant.bool false
+  %none = torch.constant.none
+  %int1 = torch.constant.int 1
+  %int2 = torch.constant.int 2
+  %0:4 = torch.aten.embedding_bag.padding_idx %weight, %indices, %offsets, %false, %int1, %false, %none, %false, %int2 : !torch.vtensor<[100,10],f32>, !torch.vtensor<[18],si64>, !torch.vtensor<[7],si64>, !torch.bool, !torch.int, !torch.bool, !torch.none, !torch.bool, !torch.int -> !torch.vtensor<[7,10],f32>, !torch.vtensor<[0],si64>, !torch.vtensor<[7],si64>, !torch.vtensor<[7],si64>
+  return %0#0 : !torch.vtensor<[7,10],f32>
+}
+
+// -----
+
+// CHECK-LABEL: func @embedding_bag_max
+// CHECK:         %[[RESULT:.*]]:2 = linalg.generic {{.*}} iterator_types = ["parallel", "parallel"]} outs(%{{.*}}, %{{.*}} : tensor<?x10xf32>, tensor<?x10xi64>)
+// CHECK:           scf.for {{.*}} -> (f32, index, i64) {
+// CHECK:             arith.cmpf ord
+// CHECK:             arith.cmpf ugt
+// CHECK:             arith.andi
+// CHECK:             arith.ori
+// CHECK:         tensor.cast %[[RESULT]]#1 : tensor<?x10xi64> to tensor<6x10xi64>
+func.func @embedding_bag_max(%weight: !torch.vtensor<[100,10],f32>, %indices: !torch.vtensor<[18],si64>, %offsets: !torch.vtensor<[7],si64>) -> (!torch.vtensor<[6,10],f32>, !torch.vtensor<[6,10],si64>) {
+  %false = torch.constant.bool false
+  %true = torch.constant.bool true
+  %none = torch.constant.none
+  %int2 = torch.constant.int 2
+  %0:4 = torch.aten.embedding_bag.padding_idx %weight, %indices, %offsets, %false, %int2, %false, %none, %true, %none : !torch.vtensor<[100,10],f32>, !torch.vtensor<[18],si64>, !torch.vtensor<[7],si64>, !torch.bool, !torch.int, !torch.bool, !torch.none, !torch.bool, !torch.none -> !torch.vtensor<[6,10],f32>, !torch.vtensor<[18],si64>, !torch.vtensor<[7],si64>, !torch.vtensor<[6,10],si64>
+  return %0#0, %0#3 : !torch.vtensor<[6,10],f32>, !torch.vtensor<[6,10],si64>
+}
+
+// -----
+
+// CHECK-LABEL: func @embedding_bag_per_sample_weights
+// CHECK:         scf.for %[[POS:.*]] = {{.*}} -> (f32, index) {
+// CHECK:           %[[ELEM:.*]] = tensor.extract %{{.*}}[%{{.*}}, %{{.*}}] : tensor<100x10xf32>
+// CHECK:           %[[SCALE:.*]] = tensor.extract %{{.*}}[%[[POS]]] : tensor<18xf32>
+// CHECK:           arith.mulf %[[ELEM]], %[[SCALE]] : f32
+func.func @embedding_bag_per_sample_weights(%weight: !torch.vtensor<[100,10],f32>, %indices: !torch.vtensor<[18],si64>, %offsets: !torch.vtensor<[7],si64>, %per_sample_weights: !torch.vtensor<[18],f32>) -> !torch.vtensor<[7,10],f32> {
+  %false = torch.constant.bool false
+  %none = torch.constant.none
+  %int0 = torch.constant.int 0
+  %0:4 = torch.aten.embedding_bag.padding_idx %weight, %indices, %offsets, %false, %int0, %false, %per_sample_weights, %false, %none : !torch.vtensor<[100,10],f32>, !torch.vtensor<[18],si64>, !torch.vtensor<[7],si64>, !torch.bool, !torch.int, !torch.bool, !torch.vtensor<[18],f32>, !torch.bool, !torch.none -> !torch.vtensor<[7,10],f32>, !torch.vtensor<[18],si64>, !torch.vtensor<[7],si64>, !torch.vtensor<[7],si64>
+  return %0#0 : !torch.vtensor<[7,10],f32>
+}
+
+// -----
+
+// offset2bag is computed with a binary search over the offsets for each index.
+// CHECK-LABEL: func @embedding_bag_offset2bag
+// CHECK:         %[[CTLZ:.*]] = math.ctlz %{{.*}} : i64
+// CHECK:         %[[OFFSET2BAG:.*]] = linalg.generic {{.*}} iterator_types = ["parallel"]} outs(%{{.*}} : tensor<18xi64>)
+// CHECK:           %[[SEARCH:.*]]:2 = scf.for {{.*}} iter_args(%[[LO:.*]] = %{{.*}}, %[[HI:.*]] = %{{.*}}) -> (index, index) {
+// CHECK:             tensor.extract %{{.*}}[%{{.*}}] : tensor<7xi64>
+// CHECK:             arith.cmpi sle
+// CHECK:             scf.yield
+// CHECK:           arith.subi %[[SEARCH]]#0, %{{.*}} : index
+// CHECK:         tensor.cast %[[OFFSET2BAG]] : tensor<18xi64> to tensor<18xi64>
+func.func @embedding_bag_offset2bag(%weight: !torch.vtensor<[100,10],f32>, %indices: !torch.vtensor<[18],si64>, %offsets: !torch.vtensor<[7],si64>) -> !torch.vtensor<[18],si64> {
+  %false = torch.constant.bool false
+  %none = torch.constant.none
+  %int0 = torch.constant.int 0
+  %0:4 = torch.aten.embedding_bag.padding_idx %weight, %indices, %offsets, %false, %int0, %false, %none, %false, %none : !torch.vtensor<[100,10],f32>, !torch.vtensor<[18],si64>, !torch.vtensor<[7],si64>, !torch.bool, !torch.int, !torch.bool, !torch.none, !torch.bool, !torch.none -> !torch.vtensor<[7,10],f32>, !torch.vtensor<[18],si64>, !torch.vtensor<[7],si64>, !torch.vtensor<[7],si64>
+  return %0#1 : !torch.vtensor<[18],si64>
+}
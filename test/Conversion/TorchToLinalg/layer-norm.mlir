@@ -0,0 +1,45 @@
+// RUN: torch-mlir-opt <%s -convert-torch-to-linalg -split-input-file -verify-diagnostics | FileCheck %s
+
+// CHECK-LABEL:   func.func @native_layer_norm(
+// CHECK-SAME:                                 %[[ARG:.*]]: !torch.vtensor<[4,128],f32>, %[[WEIGHT:.*]]: !torch.vtensor<[128],f32>, %[[BIAS:.*]]: !torch.vtensor<[128],f32>)
+// CHECK:           %[[INPUT:.*]] = torch_c.to_builtin_tensor %[[ARG]] : !torch.vtensor<[4,128],f32> -> tensor<4x128xf32>
+// CHECK:           %[[WELFORD:.*]]:3 = linalg.generic {{.*}} iterator_types = ["parallel", "reduction"]} ins(%[[INPUT]] : tensor<4x128xf32>) outs(%{{.*}}, %{{.*}}, %{{.*}} : tensor<4xf32>, tensor<4xf32>, tensor<4xi64>)
+// CHECK-NEXT:      ^bb0(%[[X:.*]]: f32, %[[MEAN:.*]]: f32, %[[M2:.*]]: f32, %[[COUNT:.*]]: i64):
+// CHECK-NOT:         linalg.index
+// CHECK:             %[[NEW_COUNT:.*]] = arith.addi %[[COUNT]], %{{.*}} : i64
+// CHECK:             %[[NEW_COUNT_F:.*]] = arith.sitofp %[[NEW_COUNT]] : i64 to f32
+// CHECK:             %[[DELTA:.*]] = arith.subf %[[X]], %[[MEAN]] : f32
+// CHECK:             arith.divf %[[DELTA]], %[[NEW_COUNT_F]] : f32
+// CHECK:             linalg.yield %{{.*}}, %{{.*}}, %[[NEW_COUNT]] : f32, f32, i64
+// CHECK:           %[[RSTD:.*]] = linalg.generic {{.*}} iterator_types = ["parallel"]} ins(%[[WELFORD]]#1 : tensor<4xf32>) outs(%{{.*}} : tensor<4xf32>)
+// CHECK:             math.rsqrt
+// CHECK:           %[[OUT:.*]] = linalg.generic {{.*}} iterator_types = ["parallel", "parallel"]} ins(%[[INPUT]], %[[WELFORD]]#0, %[[RSTD]], %{{.*}}, %{{.*}} : tensor<4x128xf32>, tensor<4xf32>, tensor<4xf32>, tensor<128xf32>, tensor<128xf32>) outs(%{{.*}} : tensor<4x128xf32>)
+// CHECK-NOT:       linalg.generic
+// CHECK:           tensor.cast %[[OUT]] : tensor<4x128xf32> to tensor<4x128xf32>
+// CHECK:           tensor.expand_shape %[[WELFORD]]#0 {{\[\[}}0, 1]] : tensor<4xf32> into tensor<4x1xf32>
+// CHECK:           tensor.expand_shape %[[RSTD]] {{\[\[}}0, 1]] : tensor<4xf32> into tensor<4x1xf32>
+func.func @native_layer_norm(%arg0: !torch.vtensor<[4,128],f32>, %weight: !torch.vtensor<[128],f32>, %bias: !torch.vtensor<[128],f32>) -> (!torch.vtensor<[4,128],f32>, !torch.vtensor<[4,1],f32>, !torch.vtensor<[4,1],f32>) {
+  %int128 = torch.constant.int 128
+  %eps = torch.constant.float 1.000000e-05
+  %normalized_shape = torch.prim.ListConstruct %int128 : (!torch.int) -> !torch.list<int>
+  %0:3 = torch.aten.native_layer_norm %arg0, %normalized_shape, %weight, %bias, %eps : !torch.vtensor<[4,128],f32>, !torch.list<int>, !torch.vtensor<[128],f32>, !torch.vtensor<[128],f32>, !torch.float -> !torch.vtensor<[4,128],f32>, !torch.vtensor<[4,1],f32>, !torch.vtensor<[4,1],f32>
+  return %0#0, %0#1, %0#2 : !torch.vtensor<[4,128],f32>, !torch.vtensor<[4,1],f32>, !torch.vtensor<[4,1],f32>
+}
+
+// -----
+
+// Normalizing over all dimensions without weight and bias.
+// CHECK-LABEL:   func.func @native_layer_norm_all_dims(
+// CHECK:           %[[WELFORD:.*]]:3 = linalg.generic {{.*}} iterator_types = ["reduction", "reduction"]} ins(%{{.*}} : tensor<2x3xf32>) outs(%{{.*}}, %{{.*}}, %{{.*}} : tensor<f32>, tensor<f32>, tensor<i64>)
+// CHECK:           %[[RSTD:.*]] = linalg.generic {{.*}} iterator_types = []} ins(%[[WELFORD]]#1 : tensor<f32>) outs(%{{.*}} : tensor<f32>)
+// CHECK:           linalg.generic {{.*}} ins(%{{.*}}, %[[WELFORD]]#0, %[[RSTD]] : tensor<2x3xf32>, tensor<f32>, tensor<f32>) outs(%{{.*}} : tensor<2x3xf32>)
+// CHECK:           tensor.expand_shape %[[WELFORD]]#0 [] : tensor<f32> into tensor<1x1xf32>
+func.func @native_layer_norm_all_dims(%arg0: !torch.vtensor<[2,3],f32>) -> (!torch.vtensor<[2,3],f32>, !torch.vtensor<[1,1],f32>, !torch.vtensor<[1,1],f32>) {
+  %int2 = torch.constant.int 2
+  %int3 = torch.constant.int 3
+  %none = torch.constant.none
+  %eps = torch.constant.float 1.000000e-05
+  %normalized_shape = torch.prim.ListConstruct %int2, %int3 : (!torch.int, !torch.int) -> !torch.list<int>
+  %0:3 = torch.aten.native_layer_norm %arg0, %normalized_shape, %none, %none, %eps : !torch.vtensor<[2,3],f32>, !torch.list<int>, !torch.none, !torch.none, !torch.float -> !torch.vtensor<[2,3],f32>, !torch.vtensor<[1,1],f32>, !torch.vtensor<[1,1],f32>
+  return %0#0, %0#1, %0#2 : !torch.vtensor<[2,3],f32>, !torch.vtensor<[1,1],f32>, !torch.vtensor<[1,1],f32>
+}
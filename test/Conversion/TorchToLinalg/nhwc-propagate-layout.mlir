@@ -0,0 +1,36 @@
+// RUN: torch-mlir-opt <%s -convert-torch-to-linalg="use-nhwc-layout=true" -canonicalize -propagate-linalg-layout -canonicalize | FileCheck %s
+
+// The layout transposes emitted around each convolution are separated from
+// the relu by the `tensor.cast` ending every conversion. Check that the
+// output transpose of the first convolution is sunk through the relu and
+// cancelled against the input transpose of the second one, so the only
+// generics left between the convolutions are the relu and the weight
+// transpose.
+
+// CHECK-LABEL: func.func @conv_relu_conv(
+// CHECK:         linalg.conv_2d_nhwc_hwcf
+// CHECK-NOT:     linalg.generic
+// CHECK:         linalg.generic
+// CHECK:           arith.cmpf ugt
+// CHECK:           arith.select
+// CHECK-NOT:     linalg.generic
+// CHECK:         linalg.generic {{.*}} ins(%{{.*}} : tensor<4x4x3x3xf32>)
+// CHECK-NOT:     linalg.generic
+// CHECK:         %[[CONV:.*]] = linalg.conv_2d_nhwc_hwcf
+// CHECK:         linalg.generic {{.*}} ins(%[[CONV]] :
+// CHECK-NOT:     linalg.generic
+// CHECK:         return
+func.func @conv_relu_conv(%arg0: !torch.vtensor<[1,3,8,8],f32>, %arg1: !torch.vtensor<[4,3,3,3],f32>, %arg2: !torch.vtensor<[4,4,3,3],f32>) -> !torch.vtensor<[1,4,4,4],f32> {
+  %none = torch.constant.none
+  %false = torch.constant.bool false
+  %int0 = torch.constant.int 0
+  %int1 = torch.constant.int 1
+  %stride = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %padding = torch.prim.ListConstruct %int0, %int0 : (!torch.int, !torch.int) -> !torch.list<int>
+  %dilation = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %output_padding = torch.prim.ListConstruct %int0, %int0 : (!torch.int, !torch.int) -> !torch.list<int>
+  %0 = torch.aten.convolution %arg0, %arg1, %none, %stride, %padding, %dilation, %false, %output_padding, %int1 : !torch.vtensor<[1,3,8,8],f32>, !torch.vtensor<[4,3,3,3],f32>, !torch.none, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.bool, !torch.list<int>, !torch.int -> !torch.vtensor<[1,4,6,6],f32>
+  %1 = torch.aten.relu %0 : !torch.vtensor<[1,4,6,6],f32> -> !torch.vtensor<[1,4,6,6],f32>
+  %2 = torch.aten.convolution %1, %arg2, %none, %stride, %padding, %dilation, %false, %output_padding, %int1 : !torch.vtensor<[1,4,6,6],f32>, !torch.vtensor<[4,4,3,3],f32>, !torch.none, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.bool, !torch.list<int>, !torch.int -> !torch.vtensor<[1,4,4,4],f32>
+  return %2 : !torch.vtensor<[1,4,4,4],f32>
+}
@@ -0,0 +1,40 @@
+// RUN: torch-mlir-opt <%s -convert-torch-to-linalg="use-nhwc-layout=true" -split-input-file -verify-diagnostics | FileCheck %s
+
+// CHECK-LABEL: func @conv2d
+// CHECK:         %[[INPUT:.*]] = linalg.generic {{.*}} ins(%{{.*}} : tensor<1x3x8x8xf32>) outs(%{{.*}} : tensor<1x8x8x3xf32>)
+// CHECK:         %[[WEIGHT:.*]] = linalg.generic {{.*}} ins(%{{.*}} : tensor<4x3x3x3xf32>) outs(%{{.*}} : tensor<3x3x3x4xf32>)
+// CHECK:         %[[CONV:.*]] = linalg.conv_2d_nhwc_hwcf {{.*}} ins(%{{.*}}, %[[WEIGHT]] :
+// CHECK:         %[[RESULT:.*]] = linalg.generic {{.*}} ins(%[[CONV]] : tensor<?x?x?x?xf32>)
+// CHECK:         tensor.cast %[[RESULT]] : tensor<?x?x?x?xf32> to tensor<1x4x6x6xf32>
+func.func @conv2d(%arg0: !torch.vtensor<[1,3,8,8],f32>, %arg1: !torch.vtensor<[4,3,3,3],f32>) -> !torch.vtensor<[1,4,6,6],f32> {
+  %none = torch.constant.none
+  %false = torch.constant.bool false
+  %int0 = torch.constant.int 0
+  %int1 = torch.constant.int 1
+  %stride = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %padding = torch.prim.ListConstruct %int0, %int0 : (!torch.int, !torch.int) -> !torch.list<int>
+  %dilation = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %output_padding = torch.prim.ListConstruct %int0, %int0 : (!torch.int, !torch.int) -> !torch.list<int>
+  %0 = torch.aten.convolution %arg0, %arg1, %none, %stride, %padding, %dilation, %false, %output_padding, %int1 : !torch.vtensor<[1,3,8,8],f32>, !torch.vtensor<[4,3,3,3],f32>, !torch.none, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.bool, !torch.list<int>, !torch.int -> !torch.vtensor<[1,4,6,6],f32>
+  return %0 : !torch.vtensor<[1,4,6,6],f32>
+}
+
+// -----
+
+// CHECK-LABEL: func @max_pool2d
+// CHECK:         %[[INPUT:.*]] = linalg.generic {{.*}} ins(%{{.*}} : tensor<1x3x8x8xf32>) outs(%{{.*}} : tensor<1x8x8x3xf32>)
+// CHECK:         %[[PADDED:.*]] = tensor.pad %[[INPUT]] low[0, 1, 1, 0] high[0, 1, 1, 0]
+// CHECK:         %[[POOL:.*]] = linalg.pooling_nhwc_max {{.*}} ins(%[[PADDED]], %{{.*}} : tensor<1x10x10x3xf32>, tensor<?x?xf32>) outs(%{{.*}} : tensor<?x?x?x?xf32>)
+// CHECK:         linalg.generic {{.*}} ins(%[[POOL]] : tensor<?x?x?x?xf32>) outs(%{{.*}} : tensor<?x?x?x?xf32>)
+func.func @max_pool2d(%arg0: !torch.vtensor<[1,3,8,8],f32>) -> !torch.vtensor<[1,3,4,4],f32> {
+  %false = torch.constant.bool false
+  %int1 = torch.constant.int 1
+  %int2 = torch.constant.int 2
+  %int3 = torch.constant.int 3
+  %kernel_size = torch.prim.ListConstruct %int3, %int3 : (!torch.int, !torch.int) -> !torch.list<int>
+  %stride = torch.prim.ListConstruct %int2, %int2 : (!torch.int, !torch.int) -> !torch.list<int>
+  %padding = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %dilation = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %0 = torch.aten.max_pool2d %arg0, %kernel_size, %stride, %padding, %dilation, %false : !torch.vtensor<[1,3,8,8],f32>, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.bool -> !torch.vtensor<[1,3,4,4],f32>
+  return %0 : !torch.vtensor<[1,3,4,4],f32>
+}
@@ -27,3 +27,28 @@ func.func @forward(%arg0: !torch.vtensor<[?,?,?,?],f32>) -> !torch.vtensor<[?,?,
   %4 = torch.aten.max_pool2d %arg0, %kernel_size, %stride, %padding, %dilation, %false : !torch.vtensor<[?,?,?,?],f32>, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.bool -> !torch.vtensor<[?,?,?,?],f32>
   return %4 : !torch.vtensor<[?,?,?,?],f32>
 }
+
+// -----
+
+// Large windows are pooled along W and then along H.
+// CHECK-LABEL: func @separable_max_pool2d
+// CHECK:         %[[NEUTRAL:.*]] = arith.constant -3.40282347E+38 : f32
+// CHECK:         %[[PADDED:.*]] = tensor.pad %{{.*}} low[0, 0, 3, 3] high[0, 0, 3, 3]
+// CHECK:         %[[OUT:.*]] = linalg.fill ins(%[[NEUTRAL]] : f32)
+// CHECK:         %[[ROW_INIT:.*]] = linalg.fill ins(%[[NEUTRAL]] : f32)
+// CHECK:         %[[ROW_WINDOW:.*]] = tensor.empty() : tensor<1x7xf32>
+// CHECK:         %[[ROW_POOL:.*]] = linalg.pooling_nchw_max {dilations = dense<1> : vector<2xi64>, strides = dense<1> : vector<2xi64>} ins(%[[PADDED]], %[[ROW_WINDOW]] : tensor<1x3x20x20xf32>, tensor<1x7xf32>) outs(%[[ROW_INIT]] :
+// CHECK:         %[[COLUMN_WINDOW:.*]] = tensor.empty() : tensor<7x1xf32>
+// CHECK:         linalg.pooling_nchw_max {dilations = dense<1> : vector<2xi64>, strides = dense<1> : vector<2xi64>} ins(%[[ROW_POOL]], %[[COLUMN_WINDOW]] : tensor<{{.*}}>, tensor<7x1xf32>) outs(%[[OUT]] :
+func.func @separable_max_pool2d(%arg0: !torch.vtensor<[1,3,14,14],f32>) -> !torch.vtensor<[1,3,14,14],f32> {
+  %int1 = torch.constant.int 1
+  %int3 = torch.constant.int 3
+  %int7 = torch.constant.int 7
+  %false = torch.constant.bool false
+  %kernel_size = torch.prim.ListConstruct %int7, %int7 : (!torch.int, !torch.int) -> !torch.list<int>
+  %stride = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %padding = torch.prim.ListConstruct %int3, %int3 : (!torch.int, !torch.int) -> !torch.list<int>
+  %dilation = torch.prim.ListConstruct %int1, %int1 : (!torch.int, !torch.int) -> !torch.list<int>
+  %0 = torch.aten.max_pool2d %arg0, %kernel_size, %stride, %padding, %dilation, %false : !torch.vtensor<[1,3,14,14],f32>, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.list<int>, !torch.bool -> !torch.vtensor<[1,3,14,14],f32>
+  return %0 : !torch.vtensor<[1,3,14,14],f32>
+}
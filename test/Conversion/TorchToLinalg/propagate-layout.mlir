@@ -0,0 +1,85 @@
+// RUN: torch-mlir-opt <%s -propagate-linalg-layout -split-input-file | FileCheck %s
+
+#nhwc_to_nchw = affine_map<(d0, d1, d2, d3) -> (d0, d2, d3, d1)>
+#nchw_to_nhwc = affine_map<(d0, d1, d2, d3) -> (d0, d3, d1, d2)>
+#id = affine_map<(d0, d1, d2, d3) -> (d0, d1, d2, d3)>
+#channel = affine_map<(d0, d1, d2, d3) -> (d1)>
+
+// CHECK-DAG:     #[[ID:.*]] = affine_map<(d0, d1, d2, d3) -> (d0, d1, d2, d3)>
+// CHECK-DAG:     #[[LAST:.*]] = affine_map<(d0, d1, d2, d3) -> (d3)>
+// CHECK-LABEL:   func.func @cancel_through_bias_relu(
+// CHECK-SAME:                                        %[[ARG:.*]]: tensor<1x4x4x8xf32>, %[[BIAS:.*]]: tensor<8xf32>) -> tensor<1x4x4x8xf32> {
+// CHECK:           %[[EMPTY:.*]] = tensor.empty() : tensor<1x4x4x8xf32>
+// CHECK:           %[[RESULT:.*]] = linalg.generic {indexing_maps = [#[[ID]], #[[LAST]], #[[ID]]], iterator_types = ["parallel", "parallel", "parallel", "parallel"]} ins(%[[ARG]], %[[BIAS]] : tensor<1x4x4x8xf32>, tensor<8xf32>) outs(%[[EMPTY]] : tensor<1x4x4x8xf32>)
+// CHECK:             arith.addf
+// CHECK:             arith.maxf
+// CHECK-NOT:       linalg.generic
+// CHECK:           return %[[RESULT]] : tensor<1x4x4x8xf32>
+func.func @cancel_through_bias_relu(%arg0: tensor<1x4x4x8xf32>, %bias: tensor<8xf32>) -> tensor<1x4x4x8xf32> {
+  %cst = arith.constant 0.000000e+00 : f32
+  %empty_nchw = tensor.empty() : tensor<1x8x4x4xf32>
+  %0 = linalg.generic {indexing_maps = [#nhwc_to_nchw, #id], iterator_types = ["parallel", "parallel", "parallel", "parallel"]} ins(%arg0 : tensor<1x4x4x8xf32>) outs(%empty_nchw : tensor<1x8x4x4xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    linalg.yield %in : f32
+  } -> tensor<1x8x4x4xf32>
+  %1 = linalg.generic {indexing_maps = [#id, #channel, #id], iterator_types = ["parallel", "parallel", "parallel", "parallel"]} ins(%0, %bias : tensor<1x8x4x4xf32>, tensor<8xf32>) outs(%empty_nchw : tensor<1x8x4x4xf32>) {
+  ^bb0(%in: f32, %b: f32, %out: f32):
+    %add = arith.addf %in, %b : f32
+    %relu = arith.maxf %add, %cst : f32
+    linalg.yield %relu : f32
+  } -> tensor<1x8x4x4xf32>
+  %empty_nhwc = tensor.empty() : tensor<1x4x4x8xf32>
+  %2 = linalg.generic {indexing_maps = [#nchw_to_nhwc, #id], iterator_types = ["parallel", "parallel", "parallel", "parallel"]} ins(%1 : tensor<1x8x4x4xf32>) outs(%empty_nhwc : tensor<1x4x4x8xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    linalg.yield %in : f32
+  } -> tensor<1x4x4x8xf32>
+  return %2 : tensor<1x4x4x8xf32>
+}
+
+// -----
+
+#nhwc_to_nchw = affine_map<(d0, d1, d2, d3) -> (d0, d2, d3, d1)>
+#id = affine_map<(d0, d1, d2, d3) -> (d0, d1, d2, d3)>
+
+// The result transpose is kept since nothing cancels it.
+// CHECK-LABEL:   func.func @sink_to_return(
+// CHECK-SAME:                              %[[ARG:.*]]: tensor<1x4x4x8xf32>) -> tensor<1x8x4x4xf32> {
+// CHECK:           %[[NEG:.*]] = linalg.generic {{.*}} ins(%[[ARG]] : tensor<1x4x4x8xf32>) outs(%{{.*}} : tensor<1x4x4x8xf32>)
+// CHECK:             arith.negf
+// CHECK:           %[[TRANSPOSED:.*]] = linalg.generic {{.*}} ins(%[[NEG]] : tensor<1x4x4x8xf32>) outs(%{{.*}} : tensor<1x8x4x4xf32>)
+// CHECK-NEXT:      ^bb0(%[[IN:.*]]: f32, %{{.*}}: f32):
+// CHECK-NEXT:        linalg.yield %[[IN]] : f32
+// CHECK:           return %[[TRANSPOSED]] : tensor<1x8x4x4xf32>
+func.func @sink_to_return(%arg0: tensor<1x4x4x8xf32>) -> tensor<1x8x4x4xf32> {
+  %empty = tensor.empty() : tensor<1x8x4x4xf32>
+  %0 = linalg.generic {indexing_maps = [#nhwc_to_nchw, #id], iterator_types = ["parallel", "parallel", "parallel", "parallel"]} ins(%arg0 : tensor<1x4x4x8xf32>) outs(%empty : tensor<1x8x4x4xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    linalg.yield %in : f32
+  } -> tensor<1x8x4x4xf32>
+  %1 = linalg.generic {indexing_maps = [#id, #id], iterator_types = ["parallel", "parallel", "parallel", "parallel"]} ins(%0 : tensor<1x8x4x4xf32>) outs(%empty : tensor<1x8x4x4xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    %neg = arith.negf %in : f32
+    linalg.yield %neg : f32
+  } -> tensor<1x8x4x4xf32>
+  return %1 : tensor<1x8x4x4xf32>
+}
+
+// -----
+
+#oihw_to_hwio = affine_map<(d0, d1, d2, d3) -> (d3, d2, d0, d1)>
+#id = affine_map<(d0, d1, d2, d3) -> (d0, d1, d2, d3)>
+
+// Weight transposes of constants are folded away.
+// CHECK-LABEL:   func.func @fold_constant_weight_transpose(
+// CHECK:           %[[CST:.*]] = arith.constant dense<{{.*}}> : tensor<3x3x2x1xf32>
+// CHECK-NOT:       linalg.generic
+// CHECK:           return %[[CST]] : tensor<3x3x2x1xf32>
+func.func @fold_constant_weight_transpose() -> tensor<3x3x2x1xf32> {
+  %weight = arith.constant dense<[[[[1.0, 2.0, 3.0], [4.0, 5.0, 6.0], [7.0, 8.0, 9.0]], [[1.0, 2.0, 3.0], [4.0, 5.0, 6.0], [7.0, 8.0, 9.0]]]]> : tensor<1x2x3x3xf32>
+  %empty = tensor.empty() : tensor<3x3x2x1xf32>
+  %0 = linalg.generic {indexing_maps = [#oihw_to_hwio, #id], iterator_types = ["parallel", "parallel", "parallel", "parallel"]} ins(%weight : tensor<1x2x3x3xf32>) outs(%empty : tensor<3x3x2x1xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    linalg.yield %in : f32
+  } -> tensor<3x3x2x1xf32>
+  return %0 : tensor<3x3x2x1xf32>
+}
@@ -0,0 +1,159 @@
+// RUN: torch-mlir-opt <%s -convert-torch-to-linalg -split-input-file -verify-diagnostics | FileCheck %s
+
+// CHECK-LABEL: func.func @quantized_linear(
+// CHECK-SAME:      %[[X:.*]]: !torch.vtensor<[4,16],ui8>, %[[W:.*]]: !torch.vtensor<[8,16],si8>, %[[B:.*]]: !torch.vtensor<[8],f32>) -> !torch.vtensor<[4,8],f32> {
+// CHECK:         %[[X_SIGNED:.*]] = linalg.generic {{.*}} ins(%{{.*}} : tensor<4x16xi8>)
+// CHECK:           arith.xori
+// CHECK:         %[[W_T:.*]] = linalg.generic {{.*}} ins(%{{.*}} : tensor<8x16xi8>) outs(%{{.*}} : tensor<16x8xi8>)
+// CHECK:         %[[ACC:.*]] = linalg.quantized_matmul ins(%[[X_SIGNED]], %[[W_T]], %{{.*}}, %{{.*}} : tensor<4x16xi8>, tensor<16x8xi8>, i32, i32) outs(%{{.*}} : tensor<4x8xi32>) -> tensor<4x8xi32>
+// CHECK:         %[[BIAS:.*]] = linalg.generic {{.*}} ins(%{{.*}} : tensor<8xf32>) outs(%{{.*}} : tensor<8xf32>)
+// CHECK:           %[[BIAS_ACC:.*]] = arith.divf %{{.*}}, %{{.*}} : f32
+// CHECK-NOT:       arith.fptosi
+// CHECK:           linalg.yield %[[BIAS_ACC]] : f32
+// CHECK:         %[[OUT:.*]] = linalg.generic {{.*}} ins(%[[ACC]], %[[BIAS]] : tensor<4x8xi32>, tensor<8xf32>) outs(%{{.*}} : tensor<4x8xi8>)
+// CHECK:           %[[ACC_F:.*]] = arith.sitofp %{{.*}} : i32 to f32
+// CHECK:           %[[SUM:.*]] = arith.addf %[[ACC_F]], %{{.*}} : f32
+// CHECK:           arith.mulf %[[SUM]], %{{.*}} : f32
+// CHECK:           math.floor
+// CHECK:           arith.maxf
+// CHECK:           arith.minf
+// CHECK:           arith.fptosi %{{.*}} : f32 to i32
+// CHECK:           arith.trunci %{{.*}} : i32 to i8
+// CHECK:         %[[Q:.*]] = tensor.cast %[[OUT]] : tensor<4x8xi8> to tensor<4x8xi8>
+// CHECK:         %[[DEQ:.*]] = linalg.generic {{.*}} ins(%[[Q]] : tensor<4x8xi8>) outs(%{{.*}} : tensor<4x8xf32>)
+// CHECK:           arith.extsi
+// CHECK:           arith.subi
+// CHECK:           arith.sitofp
+// CHECK:           arith.mulf
+// CHECK:         tensor.cast %[[DEQ]] : tensor<4x8xf32> to tensor<4x8xf32>
+// CHECK-NOT:     torch.linear_params.create
+// CHECK-NOT:     torch.quantized.linear
+func.func @quantized_linear(%x: !torch.vtensor<[4,16],ui8>, %w: !torch.vtensor<[8,16],si8>, %b: !torch.vtensor<[8],f32>) -> !torch.vtensor<[4,8],f32> {
+  %x_scale = torch.constant.float 5.000000e-02
+  %x_zp = torch.constant.int 128
+  %w_scale = torch.constant.float 1.000000e-02
+  %w_zp = torch.constant.int 3
+  %y_scale = torch.constant.float 1.000000e-01
+  %y_zp = torch.constant.int 0
+  %xq = torch.per_tensor_affine.create %x, %x_scale, %x_zp : !torch.vtensor<[4,16],ui8>, !torch.float, !torch.int -> !torch.vtensor<[4,16],!torch.quint8>
+  %wq = torch.per_tensor_affine.create %w, %w_scale, %w_zp : !torch.vtensor<[8,16],si8>, !torch.float, !torch.int -> !torch.vtensor<[8,16],!torch.qint8>
+  %params = torch.linear_params.create %wq, %b : !torch.vtensor<[8,16],!torch.qint8>, !torch.vtensor<[8],f32>
+  %0 = torch.quantized.linear %xq, %params, %y_scale, %y_zp : !torch.vtensor<[4,16],!torch.quint8>, !torch.LinearParams, !torch.float, !torch.int -> !torch.vtensor<[4,8],!torch.qint8>
+  %1 = torch.aten.dequantize.self %0 : !torch.vtensor<[4,8],!torch.qint8> -> !torch.vtensor<[4,8],f32>
+  return %1 : !torch.vtensor<[4,8],f32>
+}
+
+// -----
+
+// The second layer reads the quantization parameters of its input from the
+// first `quantized::linear`.
+// CHECK-LABEL: func.func @chained_quantized_linear(
+// CHECK:         %[[ACC0:.*]] = linalg.quantized_matmul
+// CHECK:         %[[OUT0:.*]] = linalg.generic {{.*}} ins(%[[ACC0]] : tensor<4x8xi32>) outs(%{{.*}} : tensor<4x8xi8>)
+// CHECK:         %[[Q0:.*]] = tensor.cast %[[OUT0]] : tensor<4x8xi8> to tensor<4x8xi8>
+// CHECK:         %[[Q0_SIGNED:.*]] = linalg.generic {{.*}} ins(%[[Q0]] : tensor<4x8xi8>)
+// CHECK:           arith.xori
+// CHECK:         %[[ZP:.*]] = arith.constant -118 : i32
+// CHECK:         linalg.quantized_matmul ins(%[[Q0_SIGNED]], %{{.*}}, %[[ZP]], %{{.*}} : tensor<4x8xi8>, tensor<8x2xi8>, i32, i32)
+func.func @chained_quantized_linear(%x: !torch.vtensor<[4,16],si8>, %w0: !torch.vtensor<[8,16],si8>, %w1: !torch.vtensor<[2,8],si8>) -> !torch.vtensor<[4,2],f32> {
+  %scale = torch.constant.float 1.000000e-01
+  %int0 = torch.constant.int 0
+  %int10 = torch.constant.int 10
+  %xq = torch.per_tensor_affine.create %x, %scale, %int0 : !torch.vtensor<[4,16],si8>, !torch.float, !torch.int -> !torch.vtensor<[4,16],!torch.qint8>
+  %w0q = torch.per_tensor_affine.create %w0, %scale, %int0 : !torch.vtensor<[8,16],si8>, !torch.float, !torch.int -> !torch.vtensor<[8,16],!torch.qint8>
+  %w1q = torch.per_tensor_affine.create %w1, %scale, %int0 : !torch.vtensor<[2,8],si8>, !torch.float, !torch.int -> !torch.vtensor<[2,8],!torch.qint8>
+  %params0 = torch.linear_params.create %w0q : !torch.vtensor<[8,16],!torch.qint8>
+  %params1 = torch.linear_params.create %w1q : !torch.vtensor<[2,8],!torch.qint8>
+  %0 = torch.quantized.linear %xq, %params0, %scale, %int10 : !torch.vtensor<[4,16],!torch.qint8>, !torch.LinearParams, !torch.float, !torch.int -> !torch.vtensor<[4,8],!torch.quint8>
+  %1 = torch.quantized.linear %0, %params1, %scale, %int0 : !torch.vtensor<[4,8],!torch.quint8>, !torch.LinearParams, !torch.float, !torch.int -> !torch.vtensor<[4,2],!torch.qint8>
+  %2 = torch.aten.dequantize.self %1 : !torch.vtensor<[4,2],!torch.qint8> -> !torch.vtensor<[4,2],f32>
+  return %2 : !torch.vtensor<[4,2],f32>
+}
+
+// -----
+
+// A quantized tensor escaping to an op that does not read its scale and zero
+// point is not converted to a bare integer tensor.
+func.func @quantized_tensor_escapes(%x: !torch.vtensor<[4,16],si8>) -> !torch.vtensor<[4,16],!torch.qint8> {
+  %scale = torch.constant.float 1.000000e-01
+  %int0 = torch.constant.int 0
+  // expected-error@+1 {{failed to legalize}}
+  %0 = torch.per_tensor_affine.create %x, %scale, %int0 : !torch.vtensor<[4,16],si8>, !torch.float, !torch.int -> !torch.vtensor<[4,16],!torch.qint8>
+  return %0 : !torch.vtensor<[4,16],!torch.qint8>
+}
+
+// -----
+
+// Packed params shared by several layers are erased once all of them are
+// converted.
+// CHECK-LABEL: func.func @shared_linear_params(
+// CHECK-COUNT-2: linalg.quantized_matmul
+// CHECK-NOT:     torch.linear_params.create
+// CHECK-NOT:     torch.quantized.linear
+func.func @shared_linear_params(%x: !torch.vtensor<[4,8],si8>, %w: !torch.vtensor<[8,8],si8>) -> !torch.vtensor<[4,8],f32> {
+  %scale = torch.constant.float 1.000000e-01
+  %int0 = torch.constant.int 0
+  %xq = torch.per_tensor_affine.create %x, %scale, %int0 : !torch.vtensor<[4,8],si8>, !torch.float, !torch.int -> !torch.vtensor<[4,8],!torch.qint8>
+  %wq = torch.per_tensor_affine.create %w, %scale, %int0 : !torch.vtensor<[8,8],si8>, !torch.float, !torch.int -> !torch.vtensor<[8,8],!torch.qint8>
+  %params = torch.linear_params.create %wq : !torch.vtensor<[8,8],!torch.qint8>
+  %0 = torch.quantized.linear %xq, %params, %scale, %int0 : !torch.vtensor<[4,8],!torch.qint8>, !torch.LinearParams, !torch.float, !torch.int -> !torch.vtensor<[4,8],!torch.qint8>
+  %1 = torch.quantized.linear %0, %params, %scale, %int0 : !torch.vtensor<[4,8],!torch.qint8>, !torch.LinearParams, !torch.float, !torch.int -> !torch.vtensor<[4,8],!torch.qint8>
+  %2 = torch.aten.dequantize.self %1 : !torch.vtensor<[4,8],!torch.qint8> -> !torch.vtensor<[4,8],f32>
+  return %2 : !torch.vtensor<[4,8],f32>
+}
+
+// -----
+
+// Patterns that do not read the quantization parameters cannot convert
+// quantized tensors, so neither the producer nor the consumer is lowered.
+func.func @quantized_tensor_to_unsupported_op(%x: !torch.vtensor<[4,16],si8>) -> !torch.vtensor<[4,16],!torch.qint8> {
+  %scale = torch.constant.float 1.000000e-01
+  %int0 = torch.constant.int 0
+  // expected-error@+1 {{failed to legalize}}
+  %0 = torch.per_tensor_affine.create %x, %scale, %int0 : !torch.vtensor<[4,16],si8>, !torch.float, !torch.int -> !torch.vtensor<[4,16],!torch.qint8>
+  %1 = torch.aten.relu %0 : !torch.vtensor<[4,16],!torch.qint8> -> !torch.vtensor<[4,16],!torch.qint8>
+  return %1 : !torch.vtensor<[4,16],!torch.qint8>
+}
+
+// -----
+
+// The layers of a quantized MLP: the input is quantized, and quint8 tanh
+// requantizes to its fixed output parameters, whose zero point of 128 is
+// shifted to 0 in the signed representation read by the next layer.
+// CHECK-LABEL: func.func @quantized_mlp(
+// CHECK:         %[[XQ:.*]] = linalg.generic {{.*}} ins(%{{.*}} : tensor<4x16xf32>) outs(%{{.*}} : tensor<4x16xi8>)
+// CHECK:           arith.mulf
+// CHECK:           math.floor
+// CHECK:           arith.maxf
+// CHECK:           arith.minf
+// CHECK:           arith.fptosi %{{.*}} : f32 to i32
+// CHECK:           arith.trunci %{{.*}} : i32 to i8
+// CHECK:         linalg.quantized_matmul
+// CHECK:         %[[TANH:.*]] = linalg.generic {{.*}} ins(%{{.*}} : tensor<4x8xi8>) outs(%{{.*}} : tensor<4x8xi8>)
+// CHECK:           arith.extui
+// CHECK:           math.tanh
+// CHECK:           math.floor
+// CHECK:           arith.trunci %{{.*}} : i32 to i8
+// CHECK:         %[[Q1:.*]] = tensor.cast %[[TANH]] : tensor<4x8xi8> to tensor<4x8xi8>
+// CHECK:         %[[Q1_SIGNED:.*]] = linalg.generic {{.*}} ins(%[[Q1]] : tensor<4x8xi8>)
+// CHECK:           arith.xori
+// CHECK:         %[[ZP:.*]] = arith.constant 0 : i32
+// CHECK:         linalg.quantized_matmul ins(%[[Q1_SIGNED]], %{{.*}}, %[[ZP]], %{{.*}} : tensor<4x8xi8>, tensor<8x2xi8>, i32, i32)
+// CHECK-NOT:     torch.aten.tanh
+// CHECK-NOT:     torch.aten.quantize_per_tensor
+func.func @quantized_mlp(%x: !torch.vtensor<[4,16],f32>, %w0: !torch.vtensor<[8,16],si8>, %w1: !torch.vtensor<[2,8],si8>) -> !torch.vtensor<[4,2],f32> {
+  %scale = torch.constant.float 1.000000e-01
+  %int0 = torch.constant.int 0
+  %int10 = torch.constant.int 10
+  %int13 = torch.constant.int 13
+  %xq = torch.aten.quantize_per_tensor %x, %scale, %int10, %int13 : !torch.vtensor<[4,16],f32>, !torch.float, !torch.int, !torch.int -> !torch.vtensor<[4,16],!torch.quint8>
+  %w0q = torch.per_tensor_affine.create %w0, %scale, %int0 : !torch.vtensor<[8,16],si8>, !torch.float, !torch.int -> !torch.vtensor<[8,16],!torch.qint8>
+  %w1q = torch.per_tensor_affine.create %w1, %scale, %int0 : !torch.vtensor<[2,8],si8>, !torch.float, !torch.int -> !torch.vtensor<[2,8],!torch.qint8>
+  %params0 = torch.linear_params.create %w0q : !torch.vtensor<[8,16],!torch.qint8>
+  %params1 = torch.linear_params.create %w1q : !torch.vtensor<[2,8],!torch.qint8>
+  %0 = torch.quantized.linear %xq, %params0, %scale, %int10 : !torch.vtensor<[4,16],!torch.quint8>, !torch.LinearParams, !torch.float, !torch.int -> !torch.vtensor<[4,8],!torch.quint8>
+  %1 = torch.aten.tanh %0 : !torch.vtensor<[4,8],!torch.quint8> -> !torch.vtensor<[4,8],!torch.quint8>
+  %2 = torch.quantized.linear %1, %params1, %scale, %int0 : !torch.vtensor<[4,8],!torch.quint8>, !torch.LinearParams, !torch.float, !torch.int -> !torch.vtensor<[4,2],!torch.qint8>
+  %3 = torch.aten.dequantize.self %2 : !torch.vtensor<[4,2],!torch.qint8> -> !torch.vtensor<[4,2],f32>
+  return %3 : !torch.vtensor<[4,2],f32>
+}
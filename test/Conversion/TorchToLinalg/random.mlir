@@ -0,0 +1,70 @@
+// RUN: torch-mlir-opt <%s -convert-torch-to-linalg -split-input-file -verify-diagnostics | FileCheck %s
+
+// The transform runs in f32 and both of its samples are used: the generic
+// covers half of the innermost dimension, and its results are interleaved.
+// CHECK-LABEL:   func.func @randn(
+// CHECK:           %[[KEY:.*]] = torch_c.get_next_seed : () -> i64
+// CHECK:           %[[SAMPLES:.*]]:2 = linalg.generic {{.*}} outs(%{{.*}}, %{{.*}} : tensor<?x?xf32>, tensor<?x?xf32>)
+// CHECK:             arith.shrui
+// CHECK:             arith.trunci
+// CHECK-NOT:         f64
+// CHECK:             math.log %{{.*}} : f32
+// CHECK:             math.sqrt %{{.*}} : f32
+// CHECK:             %[[COS:.*]] = math.cos %{{.*}} : f32
+// CHECK:             %[[COS_SAMPLE:.*]] = arith.mulf %{{.*}}, %[[COS]] : f32
+// CHECK:             %[[SIN:.*]] = math.sin %{{.*}} : f32
+// CHECK:             %[[SIN_SAMPLE:.*]] = arith.mulf %{{.*}}, %[[SIN]] : f32
+// CHECK:             linalg.yield %[[COS_SAMPLE]], %[[SIN_SAMPLE]] : f32, f32
+// CHECK-NOT:       linalg.generic
+// CHECK:           %[[EVEN:.*]] = tensor.insert_slice %[[SAMPLES]]#0 into %{{.*}}[0, 0] [%{{.*}}, %{{.*}}] [1, 2]
+// CHECK:           %[[ODD:.*]] = tensor.insert_slice %[[SAMPLES]]#1 into %[[EVEN]][0, 1] [%{{.*}}, %{{.*}}] [1, 2]
+// CHECK:           %[[RANDN:.*]] = tensor.extract_slice %[[ODD]][0, 0] [%{{.*}}, %{{.*}}] [1, 1]
+// CHECK:           tensor.cast %[[RANDN]] : tensor<?x?xf32> to tensor<4x1024xf32>
+func.func @randn() -> !torch.vtensor<[4,1024],f32> {
+  %int4 = torch.constant.int 4
+  %int1024 = torch.constant.int 1024
+  %none = torch.constant.none
+  %size = torch.prim.ListConstruct %int4, %int1024 : (!torch.int, !torch.int) -> !torch.list<int>
+  %0 = torch.aten.randn.generator %size, %none, %none, %none, %none, %none : !torch.list<int>, !torch.none, !torch.none, !torch.none, !torch.none, !torch.none -> !torch.vtensor<[4,1024],f32>
+  return %0 : !torch.vtensor<[4,1024],f32>
+}
+
+// -----
+
+// The transform runs in f64 for f16 results; only the samples are rounded.
+// CHECK-LABEL:   func.func @randn_f16(
+// CHECK:           linalg.generic {{.*}} outs(%{{.*}}, %{{.*}} : tensor<?xf16>, tensor<?xf16>)
+// CHECK-NOT:         arith.truncf
+// CHECK:             math.log %{{.*}} : f64
+// CHECK:             math.cos %{{.*}} : f64
+// CHECK:             math.sin %{{.*}} : f64
+// CHECK:             %[[COS_SAMPLE:.*]] = arith.truncf %{{.*}} : f64 to f16
+// CHECK:             %[[SIN_SAMPLE:.*]] = arith.truncf %{{.*}} : f64 to f16
+// CHECK:             linalg.yield %[[COS_SAMPLE]], %[[SIN_SAMPLE]] : f16, f16
+func.func @randn_f16() -> !torch.vtensor<[1024],f16> {
+  %int1024 = torch.constant.int 1024
+  %int5 = torch.constant.int 5
+  %none = torch.constant.none
+  %size = torch.prim.ListConstruct %int1024 : (!torch.int) -> !torch.list<int>
+  %0 = torch.aten.randn.generator %size, %none, %int5, %none, %none, %none : !torch.list<int>, !torch.none, !torch.int, !torch.none, !torch.none, !torch.none -> !torch.vtensor<[1024],f16>
+  return %0 : !torch.vtensor<[1024],f16>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @bernoulli_float(
+// CHECK-SAME:                               %[[ARG:.*]]: !torch.vtensor<[?,?],f32>
+// CHECK:           %[[P:.*]] = torch_c.to_f64 %{{.*}}
+// CHECK:           %[[KEY:.*]] = torch_c.get_next_seed : () -> i64
+// CHECK:           %[[MASK:.*]] = linalg.generic {{.*}} outs(%{{.*}} : tensor<?x?xf32>)
+// CHECK:             %[[UNIFORM:.*]] = arith.mulf %{{.*}}, %{{.*}} : f64
+// CHECK:             %[[LT:.*]] = arith.cmpf olt, %[[UNIFORM]], %[[P]] : f64
+// CHECK:             %[[RES:.*]] = arith.uitofp %[[LT]] : i1 to f32
+// CHECK:             linalg.yield %[[RES]] : f32
+// CHECK-NOT:       linalg.generic
+func.func @bernoulli_float(%arg0: !torch.vtensor<[?,?],f32>) -> !torch.vtensor<[?,?],f32> {
+  %p = torch.constant.float 4.000000e-01
+  %none = torch.constant.none
+  %0 = torch.valsem.aten.bernoulli.float %arg0, %p, %none : !torch.vtensor<[?,?],f32>, !torch.float, !torch.none -> !torch.vtensor<[?,?],f32>
+  return %0 : !torch.vtensor<[?,?],f32>
+}
@@ -0,0 +1,37 @@
+// RUN: torch-mlir-opt <%s -convert-torch-to-linalg -split-input-file -verify-diagnostics | FileCheck %s
+
+// CHECK-LABEL: func @max_dim
+// CHECK:         %[[NEG_INF:.*]] = arith.constant 0xFF800000 : f32
+// CHECK:         %[[INIT:.*]] = linalg.fill ins(%[[NEG_INF]] : f32)
+// CHECK:         linalg.generic {{.*}} iterator_types = ["parallel", "reduction"]} ins(%{{.*}} : tensor<4x16xf32>) outs(%[[INIT]], %{{.*}} : tensor<4xf32>, tensor<4xi64>)
+// CHECK:           %[[IS_GREATER:.*]] = arith.cmpf ogt
+// CHECK:           %[[NEW_IS_NAN:.*]] = arith.cmpf uno
+// CHECK:           %[[OLD_IS_NOT_NAN:.*]] = arith.cmpf ord
+// CHECK:           %[[IS_FIRST_NAN:.*]] = arith.andi %[[NEW_IS_NAN]], %[[OLD_IS_NOT_NAN]] : i1
+// CHECK:           %[[TAKE_NEW:.*]] = arith.ori %[[IS_GREATER]], %[[IS_FIRST_NAN]] : i1
+// CHECK:           arith.select %[[TAKE_NEW]]
+// CHECK:           arith.select %[[TAKE_NEW]]
+func.func @max_dim(%arg0: !torch.vtensor<[4,16],f32>) -> (!torch.vtensor<[4],f32>, !torch.vtensor<[4],si64>) {
+  %int1 = torch.constant.int 1
+  %false = torch.constant.bool false
+  %values, %indices = torch.aten.max.dim %arg0, %int1, %false : !torch.vtensor<[4,16],f32>, !torch.int, !torch.bool -> !torch.vtensor<[4],f32>, !torch.vtensor<[4],si64>
+  return %values, %indices : !torch.vtensor<[4],f32>, !torch.vtensor<[4],si64>
+}
+
+// -----
+
+// Long reductions are padded with -inf, split into tiles that are reduced in
+// parallel, and the partial results are combined.
+// CHECK-LABEL: func @max_dim_tiled
+// CHECK:         %[[PADDED:.*]] = tensor.pad %{{.*}} low[0, 0] high[0, 120]
+// CHECK:         %[[TILED:.*]] = tensor.expand_shape %[[PADDED]] {{\[\[}}0], [1, 2]] : tensor<2x5120xf32> into tensor<2x20x256xf32>
+// CHECK:         %[[PARTIAL:.*]]:2 = linalg.generic {{.*}} iterator_types = ["parallel", "parallel", "reduction"]} ins(%[[TILED]] : tensor<2x20x256xf32>) outs(%{{.*}}, %{{.*}} : tensor<2x20xf32>, tensor<2x20xi64>)
+// CHECK:           arith.muli
+// CHECK:           arith.addi
+// CHECK:         %[[RESULT:.*]]:2 = linalg.generic {{.*}} iterator_types = ["parallel", "reduction"]} ins(%[[PARTIAL]]#0, %[[PARTIAL]]#1 : tensor<2x20xf32>, tensor<2x20xi64>) outs(%{{.*}}, %{{.*}} : tensor<2x1xf32>, tensor<2x1xi64>)
+func.func @max_dim_tiled(%arg0: !torch.vtensor<[2,5000],f32>) -> (!torch.vtensor<[2,1],f32>, !torch.vtensor<[2,1],si64>) {
+  %int1 = torch.constant.int 1
+  %true = torch.constant.bool true
+  %values, %indices = torch.aten.max.dim %arg0, %int1, %true : !torch.vtensor<[2,5000],f32>, !torch.int, !torch.bool -> !torch.vtensor<[2,1],f32>, !torch.vtensor<[2,1],si64>
+  return %values, %indices : !torch.vtensor<[2,1],f32>, !torch.vtensor<[2,1],si64>
+}
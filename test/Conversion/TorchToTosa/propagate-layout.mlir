@@ -0,0 +1,121 @@
+// RUN: torch-mlir-opt <%s -propagate-tosa-layout -split-input-file | FileCheck %s
+
+// CHECK-LABEL:   func.func @cancel_through_clamp(
+// CHECK-SAME:                                    %[[ARG:.*]]: tensor<1x4x4x8xf32>) -> tensor<1x4x4x8xf32> {
+// CHECK-NOT:       tosa.transpose
+// CHECK:           %[[CLAMP:.*]] = "tosa.clamp"(%[[ARG]]) {{.*}} : (tensor<1x4x4x8xf32>) -> tensor<1x4x4x8xf32>
+// CHECK-NOT:       tosa.transpose
+// CHECK:           return %[[CLAMP]] : tensor<1x4x4x8xf32>
+func.func @cancel_through_clamp(%arg0: tensor<1x4x4x8xf32>) -> tensor<1x4x4x8xf32> {
+  %nhwcToNchw = "tosa.const"() {value = dense<[0, 3, 1, 2]> : tensor<4xi32>} : () -> tensor<4xi32>
+  %nchwToNhwc = "tosa.const"() {value = dense<[0, 2, 3, 1]> : tensor<4xi32>} : () -> tensor<4xi32>
+  %0 = "tosa.transpose"(%arg0, %nhwcToNchw) : (tensor<1x4x4x8xf32>, tensor<4xi32>) -> tensor<1x8x4x4xf32>
+  %1 = "tosa.clamp"(%0) {max_fp = 3.40282347E+38 : f32, max_int = 2147483647 : i64, min_fp = 0.000000e+00 : f32, min_int = 0 : i64} : (tensor<1x8x4x4xf32>) -> tensor<1x8x4x4xf32>
+  %2 = "tosa.transpose"(%1, %nchwToNhwc) : (tensor<1x8x4x4xf32>, tensor<4xi32>) -> tensor<1x4x4x8xf32>
+  return %2 : tensor<1x4x4x8xf32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @cancel_through_bias_add(
+// CHECK-SAME:                                       %[[ARG:.*]]: tensor<1x4x4x2xf32>) -> tensor<1x4x4x2xf32> {
+// CHECK:           %[[BIAS:.*]] = "tosa.const"() {value = dense<{{\[\[\[}}[1.000000e+00, 2.000000e+00]]]]> : tensor<1x1x1x2xf32>} : () -> tensor<1x1x1x2xf32>
+// CHECK:           %[[ADD:.*]] = "tosa.add"(%[[ARG]], %[[BIAS]]) : (tensor<1x4x4x2xf32>, tensor<1x1x1x2xf32>) -> tensor<1x4x4x2xf32>
+// CHECK-NOT:       tosa.transpose
+// CHECK:           return %[[ADD]] : tensor<1x4x4x2xf32>
+func.func @cancel_through_bias_add(%arg0: tensor<1x4x4x2xf32>) -> tensor<1x4x4x2xf32> {
+  %nhwcToNchw = "tosa.const"() {value = dense<[0, 3, 1, 2]> : tensor<4xi32>} : () -> tensor<4xi32>
+  %nchwToNhwc = "tosa.const"() {value = dense<[0, 2, 3, 1]> : tensor<4xi32>} : () -> tensor<4xi32>
+  %bias = "tosa.const"() {value = dense<[[[[1.0]], [[2.0]]]]> : tensor<1x2x1x1xf32>} : () -> tensor<1x2x1x1xf32>
+  %0 = "tosa.transpose"(%arg0, %nhwcToNchw) : (tensor<1x4x4x2xf32>, tensor<4xi32>) -> tensor<1x2x4x4xf32>
+  %1 = "tosa.add"(%0, %bias) : (tensor<1x2x4x4xf32>, tensor<1x2x1x1xf32>) -> tensor<1x2x4x4xf32>
+  %2 = "tosa.transpose"(%1, %nchwToNhwc) : (tensor<1x2x4x4xf32>, tensor<4xi32>) -> tensor<1x4x4x2xf32>
+  return %2 : tensor<1x4x4x2xf32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @fold_weight_transpose() -> tensor<2x1x1x3xf32> {
+// CHECK:           %[[WEIGHT:.*]] = "tosa.const"() {value = dense<{{\[\[\[}}[1.000000e+00, 2.000000e+00, 3.000000e+00]]], {{\[\[}}[4.000000e+00, 5.000000e+00, 6.000000e+00]]]]> : tensor<2x1x1x3xf32>} : () -> tensor<2x1x1x3xf32>
+// CHECK-NOT:       tosa.transpose
+// CHECK:           return %[[WEIGHT]] : tensor<2x1x1x3xf32>
+func.func @fold_weight_transpose() -> tensor<2x1x1x3xf32> {
+  %nchwToNhwc = "tosa.const"() {value = dense<[0, 2, 3, 1]> : tensor<4xi32>} : () -> tensor<4xi32>
+  %weight = "tosa.const"() {value = dense<[[[[1.0]], [[2.0]], [[3.0]]], [[[4.0]], [[5.0]], [[6.0]]]]> : tensor<2x3x1x1xf32>} : () -> tensor<2x3x1x1xf32>
+  %0 = "tosa.transpose"(%weight, %nchwToNhwc) : (tensor<2x3x1x1xf32>, tensor<4xi32>) -> tensor<2x1x1x3xf32>
+  return %0 : tensor<2x1x1x3xf32>
+}
+
+// -----
+
+// CHECK-LABEL:   func.func @cancel_through_concat(
+// CHECK-SAME:                                     %[[ARG0:.*]]: tensor<1x4x4x2xf32>,
+// CHECK-SAME:                                     %[[ARG1:.*]]: tensor<1x4x4x3xf32>) -> tensor<1x4x4x5xf32> {
+// CHECK-NOT:       tosa.transpose
+// CHECK:           %[[CAT:.*]] = "tosa.concat"(%[[ARG0]], %[[ARG1]]) {axis = 3 : i64} : (tensor<1x4x4x2xf32>, tensor<1x4x4x3xf32>) -> tensor<1x4x4x5xf32>
+// CHECK-NOT:       tosa.transpose
+// CHECK:           return %[[CAT]] : tensor<1x4x4x5xf32>
+func.func @cancel_through_concat(%arg0: tensor<1x4x4x2xf32>, %arg1: tensor<1x4x4x3xf32>) -> tensor<1x4x4x5xf32> {
+  %nhwcToNchw = "tosa.const"() {value = dense<[0, 3, 1, 2]> : tensor<4xi32>} : () -> tensor<4xi32>
+  %nchwToNhwc = "tosa.const"() {value = dense<[0, 2, 3, 1]> : tensor<4xi32>} : () -> tensor<4xi32>
+  %0 = "tosa.transpose"(%arg0, %nhwcToNchw) : (tensor<1x4x4x2xf32>, tensor<4xi32>) -> tensor<1x2x4x4xf32>
+  %1 = "tosa.transpose"(%arg1, %nhwcToNchw) : (tensor<1x4x4x3xf32>, tensor<4xi32>) -> tensor<1x3x4x4xf32>
+  %2 = "tosa.concat"(%0, %1) {axis = 1 : i64} : (tensor<1x2x4x4xf32>, tensor<1x3x4x4xf32>) -> tensor<1x5x4x4xf32>
+  %3 = "tosa.transpose"(%2, %nchwToNhwc) : (tensor<1x5x4x4xf32>, tensor<4xi32>) -> tensor<1x4x4x5xf32>
+  return %3 : tensor<1x4x4x5xf32>
+}
+
+// -----
+
+// A constant operand that is itself transposed is used untransposed, not
+// transposed a second time.
+
+// CHECK-LABEL:   func.func @sink_through_transposed_const(
+// CHECK-SAME:                                             %[[ARG:.*]]: tensor<1x2x3x1xf32>) -> tensor<1x2x3x1xf32> {
+// CHECK:           %[[CST:.*]] = "tosa.const"() {value = dense<{{\[\[\[}}[1.000000e+00], [2.000000e+00], [3.000000e+00]], {{\[\[}}4.000000e+00], [5.000000e+00], [6.000000e+00]]]]> : tensor<1x2x3x1xf32>} : () -> tensor<1x2x3x1xf32>
+// CHECK:           %[[ADD:.*]] = "tosa.add"(%[[ARG]], %[[CST]]) : (tensor<1x2x3x1xf32>, tensor<1x2x3x1xf32>) -> tensor<1x2x3x1xf32>
+// CHECK-NOT:       tosa.transpose
+// CHECK:           return %[[ADD]] : tensor<1x2x3x1xf32>
+func.func @sink_through_transposed_const(%arg0: tensor<1x2x3x1xf32>) -> tensor<1x2x3x1xf32> {
+  %nhwcToNchw = "tosa.const"() {value = dense<[0, 3, 1, 2]> : tensor<4xi32>} : () -> tensor<4xi32>
+  %nchwToNhwc = "tosa.const"() {value = dense<[0, 2, 3, 1]> : tensor<4xi32>} : () -> tensor<4xi32>
+  %cst = "tosa.const"() {value = dense<[[[[1.0], [2.0], [3.0]], [[4.0], [5.0], [6.0]]]]> : tensor<1x2x3x1xf32>} : () -> tensor<1x2x3x1xf32>
+  %0 = "tosa.transpose"(%arg0, %nhwcToNchw) : (tensor<1x2x3x1xf32>, tensor<4xi32>) -> tensor<1x1x2x3xf32>
+  %1 = "tosa.transpose"(%cst, %nhwcToNchw) : (tensor<1x2x3x1xf32>, tensor<4xi32>) -> tensor<1x1x2x3xf32>
+  %2 = "tosa.add"(%0, %1) : (tensor<1x1x2x3xf32>, tensor<1x1x2x3xf32>) -> tensor<1x1x2x3xf32>
+  %3 = "tosa.transpose"(%2, %nchwToNhwc) : (tensor<1x1x2x3xf32>, tensor<4xi32>) -> tensor<1x2x3x1xf32>
+  return %3 : tensor<1x2x3x1xf32>
+}
+
+// -----
+
+// Operands transposed by different permutations are left alone.
+
+// CHECK-LABEL:   func.func @no_sink_mismatched_perms(
+// CHECK:           "tosa.transpose"
+// CHECK:           "tosa.transpose"
+// CHECK:           "tosa.add"
+func.func @no_sink_mismatched_perms(%arg0: tensor<2x2x2x2xf32>, %arg1: tensor<2x2x2x2xf32>) -> tensor<2x2x2x2xf32> {
+  %nhwcToNchw = "tosa.const"() {value = dense<[0, 3, 1, 2]> : tensor<4xi32>} : () -> tensor<4xi32>
+  %nchwToNhwc = "tosa.const"() {value = dense<[0, 2, 3, 1]> : tensor<4xi32>} : () -> tensor<4xi32>
+  %0 = "tosa.transpose"(%arg0, %nhwcToNchw) : (tensor<2x2x2x2xf32>, tensor<4xi32>) -> tensor<2x2x2x2xf32>
+  %1 = "tosa.transpose"(%arg1, %nchwToNhwc) : (tensor<2x2x2x2xf32>, tensor<4xi32>) -> tensor<2x2x2x2xf32>
+  %2 = "tosa.add"(%0, %1) : (tensor<2x2x2x2xf32>, tensor<2x2x2x2xf32>) -> tensor<2x2x2x2xf32>
+  return %2 : tensor<2x2x2x2xf32>
+}
+
+// -----
+
+// A transpose with other users is not sunk, since that would add a transpose.
+
+// CHECK-LABEL:   func.func @no_sink_multi_use(
+// CHECK-SAME:                                 %[[ARG:.*]]: tensor<1x4x4x8xf32>) -> (tensor<1x8x4x4xf32>, tensor<1x8x4x4xf32>) {
+// CHECK:           %[[T:.*]] = "tosa.transpose"(%[[ARG]]
+// CHECK:           %[[CLAMP:.*]] = "tosa.clamp"(%[[T]])
+// CHECK:           return %[[CLAMP]], %[[T]]
+func.func @no_sink_multi_use(%arg0: tensor<1x4x4x8xf32>) -> (tensor<1x8x4x4xf32>, tensor<1x8x4x4xf32>) {
+  %nhwcToNchw = "tosa.const"() {value = dense<[0, 3, 1, 2]> : tensor<4xi32>} : () -> tensor<4xi32>
+  %0 = "tosa.transpose"(%arg0, %nhwcToNchw) : (tensor<1x4x4x8xf32>, tensor<4xi32>) -> tensor<1x8x4x4xf32>
+  %1 = "tosa.clamp"(%0) {max_fp = 3.40282347E+38 : f32, max_int = 2147483647 : i64, min_fp = 0.000000e+00 : f32, min_int = 0 : i64} : (tensor<1x8x4x4xf32>) -> tensor<1x8x4x4xf32>
+  return %1, %0 : tensor<1x8x4x4xf32>, tensor<1x8x4x4xf32>
+}
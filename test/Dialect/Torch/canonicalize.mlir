@@ -1263,6 +1263,36 @@ func.func @torch.aten.Float.Tensor(%arg0: !torch.float) -> !torch.float {
   return %scalar : !torch.float
 }
 
+// CHECK-LABEL:   func.func @torch.aten.Int.Tensor$literal() -> !torch.int {
+// CHECK:           %[[INT3:.*]] = torch.constant.int 3
+// CHECK:           return %[[INT3]] : !torch.int
+func.func @torch.aten.Int.Tensor$literal() -> !torch.int {
+  %tensor = torch.vtensor.literal(dense<3> : tensor<1xsi64>) : !torch.vtensor<[1],si64>
+  %scalar = torch.aten.Int.Tensor %tensor : !torch.vtensor<[1],si64> -> !torch.int
+  return %scalar : !torch.int
+}
+
+// CHECK-LABEL:   func.func @torch.aten.Float.Tensor$literal() -> !torch.float {
+// CHECK:           %[[FLOAT:.*]] = torch.constant.float 2.500000e-01
+// CHECK:           return %[[FLOAT]] : !torch.float
+func.func @torch.aten.Float.Tensor$literal() -> !torch.float {
+  %tensor = torch.vtensor.literal(dense<2.500000e-01> : tensor<1xf32>) : !torch.vtensor<[1],f32>
+  %scalar = torch.aten.Float.Tensor %tensor : !torch.vtensor<[1],f32> -> !torch.float
+  return %scalar : !torch.float
+}
+
+// CHECK-LABEL:   func.func @torch.quantized.linear$refine_sizes(
+// CHECK:           %[[LINEAR:.*]] = torch.quantized.linear {{.*}} -> !torch.vtensor<[4,8],!torch.qint8>
+// CHECK:           %[[CAST:.*]] = torch.tensor_static_info_cast %[[LINEAR]] : !torch.vtensor<[4,8],!torch.qint8> to !torch.vtensor<*,!torch.qint8>
+// CHECK:           return %[[CAST]] : !torch.vtensor<*,!torch.qint8>
+func.func @torch.quantized.linear$refine_sizes(%x: !torch.vtensor<[4,16],!torch.qint8>, %w: !torch.vtensor<[8,16],!torch.qint8>) -> !torch.vtensor<*,!torch.qint8> {
+  %scale = torch.constant.float 1.000000e-01
+  %int0 = torch.constant.int 0
+  %params = torch.linear_params.create %w : !torch.vtensor<[8,16],!torch.qint8>
+  %0 = torch.quantized.linear %x, %params, %scale, %int0 : !torch.vtensor<[4,16],!torch.qint8>, !torch.LinearParams, !torch.float, !torch.int -> !torch.vtensor<*,!torch.qint8>
+  return %0 : !torch.vtensor<*,!torch.qint8>
+}
+
 // CHECK-LABEL:   func.func @torch.aten.squeeze$zero_rank(
 // CHECK-SAME:            %[[ARG:.*]]: !torch.tensor<[],f32>) -> !torch.tensor<[],f32> {
 // CHECK-NEXT:      return %[[ARG]] : !torch.tensor<[],f32>
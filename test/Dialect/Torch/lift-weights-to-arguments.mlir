@@ -0,0 +1,69 @@
+// RUN: torch-mlir-opt -torch-lift-weights-to-arguments='min-elements=4' -split-input-file %s | FileCheck %s
+
+// Test case: Large weights are lifted, small ones are kept.
+
+// CHECK-LABEL: module attributes {torch.weight_arguments = {forward = ["linear.weight"]}} {
+// CHECK-NOT:     @"linear.weight"
+// CHECK:         torch.global_slot "private" @"linear.bias" : !torch.tensor
+torch.global_slot "private" @"linear.weight" : !torch.tensor
+torch.global_slot "private" @"linear.bias" : !torch.tensor
+
+// CHECK-LABEL:   torch.global_slot.module_initializer {
+// CHECK:           %[[BIAS:.*]] = torch.tensor.literal(dense<0.000000e+00> : tensor<2xf32>) : !torch.tensor<[2],f32>
+// CHECK:           torch.initialize.global_slots [
+// CHECK-NEXT:        @"linear.bias"(%[[BIAS]] : !torch.tensor<[2],f32>)
+// CHECK-NEXT:      ]
+torch.global_slot.module_initializer {
+  %0 = torch.tensor.literal(dense<1.0> : tensor<2x3xf32>) : !torch.tensor<[2,3],f32>
+  %1 = torch.tensor.literal(dense<0.0> : tensor<2xf32>) : !torch.tensor<[2],f32>
+  torch.initialize.global_slots [
+    @"linear.weight"(%0 : !torch.tensor<[2,3],f32>)
+    @"linear.bias"(%1 : !torch.tensor<[2],f32>)
+  ]
+}
+
+// CHECK-LABEL:   func.func @forward(
+// CHECK-SAME:        %[[X:.*]]: !torch.tensor,
+// CHECK-SAME:        %[[W:.*]]: !torch.tensor {torch.type_bound = !torch.vtensor<[2,3],f32>}) -> !torch.tensor {
+// CHECK:           %[[B:.*]] = torch.global_slot.get @"linear.bias" : !torch.tensor
+// CHECK:           %[[RET:.*]] = torch.aten.linear %[[X]], %[[W]], %[[B]]
+// CHECK:           return %[[RET]] : !torch.tensor
+func.func @forward(%arg0: !torch.tensor) -> !torch.tensor {
+  %0 = torch.global_slot.get @"linear.weight" : !torch.tensor
+  %1 = torch.global_slot.get @"linear.bias" : !torch.tensor
+  %2 = torch.aten.linear %arg0, %0, %1 : !torch.tensor, !torch.tensor, !torch.tensor -> !torch.tensor
+  return %2 : !torch.tensor
+}
+
+// -----
+
+// Test case: Slots that are set, or read outside of a public function, are
+// not lifted.
+
+// CHECK-LABEL: module {
+// CHECK:         torch.global_slot "private" @set : !torch.tensor
+// CHECK:         torch.global_slot "private" @private_read : !torch.tensor
+torch.global_slot "private" @set : !torch.tensor
+torch.global_slot "private" @private_read : !torch.tensor
+
+torch.global_slot.module_initializer {
+  %0 = torch.tensor.literal(dense<1.0> : tensor<8xf32>) : !torch.tensor<[8],f32>
+  %1 = torch.tensor.literal(dense<1.0> : tensor<8xf32>) : !torch.tensor<[8],f32>
+  torch.initialize.global_slots [
+    @set(%0 : !torch.tensor<[8],f32>)
+    @private_read(%1 : !torch.tensor<[8],f32>)
+  ]
+}
+
+// CHECK-LABEL:   func.func @forward(
+// CHECK-SAME:        %{{.*}}: !torch.tensor) -> !torch.tensor {
+func.func @forward(%arg0: !torch.tensor) -> !torch.tensor {
+  torch.global_slot.set @set = %arg0 : !torch.tensor
+  %0 = call @helper() : () -> !torch.tensor
+  return %0 : !torch.tensor
+}
+
+func.func private @helper() -> !torch.tensor {
+  %0 = torch.global_slot.get @private_read : !torch.tensor
+  return %0 : !torch.tensor
+}
@@ -346,3 +346,20 @@ func.func @torch.aten.tensor$specified_dtype(%t: !torch.list<list<float>>) -> !t
   %ret = torch.aten.tensor %t, %int4, %none, %false : !torch.list<list<float>>, !torch.int, !torch.none, !torch.bool -> !torch.tensor
   return %ret : !torch.tensor
 }
+
+// -----
+// CHECK-LABEL:   func.func @torch.aten.quantize_per_tensor(
+// CHECK:           %[[Q:.*]] = torch.aten.quantize_per_tensor {{.*}} -> !torch.vtensor<*,!torch.quint8>
+// CHECK:           %[[LINEAR:.*]] = torch.quantized.linear %[[Q]], {{.*}} -> !torch.vtensor<*,!torch.quint8>
+// CHECK:           %[[TANH:.*]] = torch.aten.tanh %[[LINEAR]] : !torch.vtensor<*,!torch.quint8> -> !torch.vtensor<*,!torch.quint8>
+// CHECK:           %[[CAST:.*]] = torch.tensor_static_info_cast %[[TANH]] : !torch.vtensor<*,!torch.quint8> to !torch.vtensor
+// CHECK:           return %[[CAST]] : !torch.vtensor
+func.func @torch.aten.quantize_per_tensor(%x: !torch.vtensor<*,f32>, %params: !torch.LinearParams) -> !torch.vtensor {
+  %scale = torch.constant.float 1.000000e-01
+  %int10 = torch.constant.int 10
+  %int13 = torch.constant.int 13
+  %0 = torch.aten.quantize_per_tensor %x, %scale, %int10, %int13 : !torch.vtensor<*,f32>, !torch.float, !torch.int, !torch.int -> !torch.vtensor
+  %1 = torch.quantized.linear %0, %params, %scale, %int10 : !torch.vtensor, !torch.LinearParams, !torch.float, !torch.int -> !torch.vtensor
+  %2 = torch.aten.tanh %1 : !torch.vtensor -> !torch.vtensor
+  return %2 : !torch.vtensor
+}
@@ -65,6 +65,15 @@ func.func @unable_to_update_terminator(%arg0: !torch.vtensor<[],f32>) -> !torch.
 
 // -----
 
+// Converting a quantized tensor would drop its scale and zero point, so it is
+// rejected at the function boundary.
+// expected-error @+1 {{failed to legalize operation 'func.func'}}
+func.func @quantized_tensor_argument(%arg0: !torch.vtensor<[4],!torch.qint8>) -> !torch.vtensor<[4],!torch.qint8> {
+  return %arg0 : !torch.vtensor<[4],!torch.qint8>
+}
+
+// -----
+
 // There was a bug in func-bufferize pass which caused terminators without
 // ReturnLike and BranchOpInterface traits (e.g. scf.condition) to always
 // fail to legalize even if bufferization doesn't needed.
@@ -0,0 +1,70 @@
+// RUN: torch-mlir-opt %s -refback-elide-insert-slice-copies -split-input-file | FileCheck %s
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+
+// The bufferized form of `torch.aten.cat` of two computed tensors along dim 0.
+// CHECK-LABEL:   func.func @cat(
+// CHECK-SAME:                   %[[LHS:.*]]: memref<2x3xf32>, %[[RHS:.*]]: memref<4x3xf32>) -> memref<6x3xf32> {
+// CHECK:           %[[RESULT:.*]] = memref.alloc() : memref<6x3xf32>
+// CHECK:           %[[LHS_VIEW:.*]] = memref.subview %[[RESULT]][0, 0] [2, 3] [1, 1]
+// CHECK:           linalg.generic {{.*}} ins(%[[LHS]] : memref<2x3xf32>) outs(%[[LHS_VIEW]] :
+// CHECK:           %[[RHS_VIEW:.*]] = memref.subview %[[RESULT]][2, 0] [4, 3] [1, 1]
+// CHECK:           linalg.generic {{.*}} ins(%[[RHS]] : memref<4x3xf32>) outs(%[[RHS_VIEW]] :
+// CHECK-NOT:       memref.copy
+// CHECK:           return %[[RESULT]] : memref<6x3xf32>
+func.func @cat(%arg0: memref<2x3xf32>, %arg1: memref<4x3xf32>) -> memref<6x3xf32> {
+  %0 = memref.alloc() : memref<2x3xf32>
+  linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]} ins(%arg0 : memref<2x3xf32>) outs(%0 : memref<2x3xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    %neg = arith.negf %in : f32
+    linalg.yield %neg : f32
+  }
+  %1 = memref.alloc() : memref<4x3xf32>
+  linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]} ins(%arg1 : memref<4x3xf32>) outs(%1 : memref<4x3xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    %neg = arith.negf %in : f32
+    linalg.yield %neg : f32
+  }
+  %2 = memref.alloc() : memref<6x3xf32>
+  %3 = memref.alloc() : memref<6x3xf32>
+  memref.copy %2, %3 : memref<6x3xf32> to memref<6x3xf32>
+  %subview = memref.subview %3[0, 0] [2, 3] [1, 1] : memref<6x3xf32> to memref<2x3xf32, strided<[3, 1]>>
+  memref.copy %0, %subview : memref<2x3xf32> to memref<2x3xf32, strided<[3, 1]>>
+  %4 = memref.alloc() : memref<6x3xf32>
+  memref.copy %3, %4 : memref<6x3xf32> to memref<6x3xf32>
+  %subview_0 = memref.subview %4[2, 0] [4, 3] [1, 1] : memref<6x3xf32> to memref<4x3xf32, strided<[3, 1], offset: 6>>
+  memref.copy %1, %subview_0 : memref<4x3xf32> to memref<4x3xf32, strided<[3, 1], offset: 6>>
+  return %4 : memref<6x3xf32>
+}
+
+// -----
+
+// The source is read after the copy, so the copy has to stay.
+// CHECK-LABEL:   func.func @source_read_after_copy(
+// CHECK:           memref.copy
+func.func @source_read_after_copy(%arg0: memref<4xf32>) -> (memref<4xf32>, memref<4xf32>) {
+  %0 = memref.alloc() : memref<4xf32>
+  %1 = memref.alloc() : memref<4xf32>
+  memref.copy %0, %1 : memref<4xf32> to memref<4xf32>
+  memref.copy %arg0, %1 : memref<4xf32> to memref<4xf32>
+  return %0, %1 : memref<4xf32>, memref<4xf32>
+}
+
+// -----
+
+// The source is read after the copy through a reshaped view of it, so the
+// copy has to stay.
+// CHECK-LABEL:   func.func @source_view_read_after_copy(
+// CHECK:           %[[SRC:.*]] = memref.alloc() : memref<2x2xf32>
+// CHECK:           %[[DST:.*]] = memref.alloc() : memref<2x2xf32>
+// CHECK:           memref.copy %[[SRC]], %[[DST]]
+func.func @source_view_read_after_copy(%arg0: memref<2x2xf32>) -> (memref<4xf32>, memref<2x2xf32>) {
+  %0 = memref.alloc() : memref<2x2xf32>
+  %collapsed = memref.collapse_shape %0 [[0, 1]] : memref<2x2xf32> into memref<4xf32>
+  %1 = memref.alloc() : memref<2x2xf32>
+  memref.copy %0, %1 : memref<2x2xf32> to memref<2x2xf32>
+  memref.copy %arg0, %1 : memref<2x2xf32> to memref<2x2xf32>
+  %2 = memref.alloc() : memref<4xf32>
+  memref.copy %collapsed, %2 : memref<4xf32> to memref<4xf32>
+  return %2, %1 : memref<4xf32>, memref<2x2xf32>
+}
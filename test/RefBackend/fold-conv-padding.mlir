@@ -0,0 +1,99 @@
+// RUN: torch-mlir-opt %s -refback-fold-conv-padding -split-input-file -verify-diagnostics | FileCheck %s
+
+// The interior is computed by the named op on the unpadded input, and the one
+// element wide border by bounds-checked generics.
+// CHECK-LABEL:   func.func @conv_nchw(
+// CHECK-SAME:            %[[INPUT:.*]]: tensor<1x3x8x8xf32>, %[[WEIGHT:.*]]: tensor<4x3x3x3xf32>, %[[INIT:.*]]: tensor<1x4x8x8xf32>) -> tensor<1x4x8x8xf32> {
+// CHECK-NOT:       tensor.pad
+// CHECK:           %[[INTERIOR_INIT:.*]] = tensor.extract_slice %[[INIT]][0, 0, 1, 1] [1, 4, 6, 6] [1, 1, 1, 1]
+// CHECK:           %[[INTERIOR:.*]] = linalg.conv_2d_nchw_fchw {{.*}} ins(%{{.*}}, %[[WEIGHT]] : tensor<1x3x8x8xf32>, tensor<4x3x3x3xf32>) outs(%[[INTERIOR_INIT]] : tensor<1x4x6x6xf32>)
+// CHECK:           %[[WITH_INTERIOR:.*]] = tensor.insert_slice %[[INTERIOR]] into %[[INIT]][0, 0, 1, 1] [1, 4, 6, 6] [1, 1, 1, 1]
+// CHECK:           %[[TOP_INIT:.*]] = tensor.extract_slice %[[WITH_INTERIOR]][0, 0, 0, 0] [1, 4, 1, 8] [1, 1, 1, 1]
+// CHECK:           %[[TOP:.*]] = linalg.generic {{.*}} iterator_types = ["parallel", "parallel", "parallel", "parallel", "reduction", "reduction", "reduction"]} ins(%[[WEIGHT]] : tensor<4x3x3x3xf32>) outs(%[[TOP_INIT]] : tensor<1x4x1x8xf32>)
+// CHECK:             %[[X:.*]] = tensor.extract %[[INPUT]]
+// CHECK:             arith.select %{{.*}}, %[[X]], %{{.*}} : f32
+// CHECK:             arith.mulf
+// CHECK:             arith.addf
+// CHECK:           %[[WITH_TOP:.*]] = tensor.insert_slice %[[TOP]] into %[[WITH_INTERIOR]][0, 0, 0, 0] [1, 4, 1, 8] [1, 1, 1, 1]
+// CHECK:           %[[WITH_BOTTOM:.*]] = tensor.insert_slice %{{.*}} into %[[WITH_TOP]][0, 0, 7, 0] [1, 4, 1, 8] [1, 1, 1, 1]
+// CHECK:           %[[WITH_LEFT:.*]] = tensor.insert_slice %{{.*}} into %[[WITH_BOTTOM]][0, 0, 1, 0] [1, 4, 6, 1] [1, 1, 1, 1]
+// CHECK:           %[[RESULT:.*]] = tensor.insert_slice %{{.*}} into %[[WITH_LEFT]][0, 0, 1, 7] [1, 4, 6, 1] [1, 1, 1, 1]
+// CHECK:           return %[[RESULT]] : tensor<1x4x8x8xf32>
+func.func @conv_nchw(
+// CHECK-SAME:            %[[INPUT:.*]]: tensor<1x3x8x8xf32>, %[[WEIGHT:.*]]: tensor<4x3x3x3xf32>, %[[INIT:.*]]: tensor<1x4x8x8xf32>) -> tensor<1x4x8x8xf32> {
+// CHECK-NOT:       tensor.pad
+// CHECK:           %[[CONV:.*]] = linalg.generic {{.*}} iterator_types = ["parallel", "parallel", "parallel", "parallel", "reduction", "reduction", "reduction"]} ins(%[[WEIGHT]] : tensor<4x3x3x3xf32>) outs(%[[INIT]] : tensor<1x4x8x8xf32>)
+// CHECK:             %[[X:.*]] = tensor.extract %[[INPUT]]
+// CHECK:             arith.select %{{.*}}, %[[X]], %{{.*}} : f32
+// CHECK:             arith.mulf
+// CHECK:             arith.addf
+// CHECK:           return %[[CONV]] : tensor<1x4x8x8xf32>
+func.func @conv_nchw(%input: tensor<1x3x8x8xf32>, %weight: tensor<4x3x3x3xf32>, %init: tensor<1x4x8x8xf32>) -> tensor<1x4x8x8xf32> {
+  %cst = arith.constant 0.000000e+00 : f32
+  %padded = tensor.pad %input low[0, 0, 1, 1] high[0, 0, 1, 1] {
+  ^bb0(%arg0: index, %arg1: index, %arg2: index, %arg3: index):
+    tensor.yield %cst : f32
+  } : tensor<1x3x8x8xf32> to tensor<1x3x10x10xf32>
+  %0 = linalg.conv_2d_nchw_fchw {dilations = dense<1> : vector<2xi64>, strides = dense<1> : vector<2xi64>} ins(%padded, %weight : tensor<1x3x10x10xf32>, tensor<4x3x3x3xf32>) outs(%init : tensor<1x4x8x8xf32>) -> tensor<1x4x8x8xf32>
+  return %0 : tensor<1x4x8x8xf32>
+}
+
+// -----
+
+// Padding with a non-zero value is left alone.
+// CHECK-LABEL:   func.func @conv_nonzero_pad(
+// CHECK:           tensor.pad
+// CHECK:           linalg.conv_2d_nchw_fchw
+func.func @conv_nonzero_pad(%input: tensor<1x3x8x8xf32>, %weight: tensor<4x3x3x3xf32>, %init: tensor<1x4x8x8xf32>) -> tensor<1x4x8x8xf32> {
+  %cst = arith.constant 1.000000e+00 : f32
+  %padded = tensor.pad %input low[0, 0, 1, 1] high[0, 0, 1, 1] {
+  ^bb0(%arg0: index, %arg1: index, %arg2: index, %arg3: index):
+    tensor.yield %cst : f32
+  } : tensor<1x3x8x8xf32> to tensor<1x3x10x10xf32>
+  %0 = linalg.conv_2d_nchw_fchw {dilations = dense<1> : vector<2xi64>, strides = dense<1> : vector<2xi64>} ins(%padded, %weight : tensor<1x3x10x10xf32>, tensor<4x3x3x3xf32>) outs(%init : tensor<1x4x8x8xf32>) -> tensor<1x4x8x8xf32>
+  return %0 : tensor<1x4x8x8xf32>
+}
+
+// -----
+
+// With a stride of 2, the bottom row and the right column of the output only
+// read the unpadded input, so there is no border generic for them.
+// CHECK-LABEL:   func.func @conv_nhwc_strided(
+// CHECK-SAME:            %[[INPUT:.*]]: tensor<1x8x8x3xf32>, %[[WEIGHT:.*]]: tensor<3x3x3x4xf32>, %[[INIT:.*]]: tensor<1x4x4x4xf32>) -> tensor<1x4x4x4xf32> {
+// CHECK-NOT:       tensor.pad
+// CHECK:           %[[INTERIOR_INPUT:.*]] = tensor.extract_slice %[[INPUT]][0, 1, 1, 0] [1, 7, 7, 3] [1, 1, 1, 1] : tensor<1x8x8x3xf32> to tensor<1x7x7x3xf32>
+// CHECK:           %[[INTERIOR_INIT:.*]] = tensor.extract_slice %[[INIT]][0, 1, 1, 0] [1, 3, 3, 4] [1, 1, 1, 1] : tensor<1x4x4x4xf32> to tensor<1x3x3x4xf32>
+// CHECK:           %[[INTERIOR:.*]] = linalg.conv_2d_nhwc_hwcf {{.*}} ins(%[[INTERIOR_INPUT]], %[[WEIGHT]] : tensor<1x7x7x3xf32>, tensor<3x3x3x4xf32>) outs(%[[INTERIOR_INIT]] : tensor<1x3x3x4xf32>)
+// CHECK:           %[[WITH_INTERIOR:.*]] = tensor.insert_slice %[[INTERIOR]] into %[[INIT]][0, 1, 1, 0] [1, 3, 3, 4] [1, 1, 1, 1]
+// CHECK:           %[[TOP:.*]] = linalg.generic {{.*}} ins(%[[WEIGHT]] : tensor<3x3x3x4xf32>) outs(%{{.*}} : tensor<1x1x4x4xf32>)
+// CHECK:             tensor.extract %[[INPUT]]
+// CHECK:           %[[WITH_TOP:.*]] = tensor.insert_slice %[[TOP]] into %[[WITH_INTERIOR]][0, 0, 0, 0] [1, 1, 4, 4] [1, 1, 1, 1]
+// CHECK:           %[[LEFT:.*]] = linalg.generic {{.*}} ins(%[[WEIGHT]] : tensor<3x3x3x4xf32>) outs(%{{.*}} : tensor<1x3x1x4xf32>)
+// CHECK:           %[[RESULT:.*]] = tensor.insert_slice %[[LEFT]] into %[[WITH_TOP]][0, 1, 0, 0] [1, 3, 1, 4] [1, 1, 1, 1]
+// CHECK-NOT:       linalg.generic
+// CHECK:           return %[[RESULT]] : tensor<1x4x4x4xf32>
+func.func @conv_nhwc_strided(%input: tensor<1x8x8x3xf32>, %weight: tensor<3x3x3x4xf32>, %init: tensor<1x4x4x4xf32>) -> tensor<1x4x4x4xf32> {
+  %cst = arith.constant 0.000000e+00 : f32
+  %padded = tensor.pad %input low[0, 1, 1, 0] high[0, 1, 1, 0] {
+  ^bb0(%arg0: index, %arg1: index, %arg2: index, %arg3: index):
+    tensor.yield %cst : f32
+  } : tensor<1x8x8x3xf32> to tensor<1x10x10x3xf32>
+  %0 = linalg.conv_2d_nhwc_hwcf {dilations = dense<1> : vector<2xi64>, strides = dense<2> : vector<2xi64>} ins(%padded, %weight : tensor<1x10x10x3xf32>, tensor<3x3x3x4xf32>) outs(%init : tensor<1x4x4x4xf32>) -> tensor<1x4x4x4xf32>
+  return %0 : tensor<1x4x4x4xf32>
+}
+
+// -----
+
+// Dynamic shapes are left alone.
+// CHECK-LABEL:   func.func @conv_dynamic(
+// CHECK:           tensor.pad
+// CHECK:           linalg.conv_2d_nchw_fchw
+func.func @conv_dynamic(%input: tensor<?x3x8x8xf32>, %weight: tensor<4x3x3x3xf32>, %init: tensor<?x4x8x8xf32>) -> tensor<?x4x8x8xf32> {
+  %cst = arith.constant 0.000000e+00 : f32
+  %padded = tensor.pad %input low[0, 0, 1, 1] high[0, 0, 1, 1] {
+  ^bb0(%arg0: index, %arg1: index, %arg2: index, %arg3: index):
+    tensor.yield %cst : f32
+  } : tensor<?x3x8x8xf32> to tensor<?x3x10x10xf32>
+  %0 = linalg.conv_2d_nchw_fchw {dilations = dense<1> : vector<2xi64>, strides = dense<1> : vector<2xi64>} ins(%padded, %weight : tensor<?x3x10x10xf32>, tensor<4x3x3x3xf32>) outs(%init : tensor<?x4x8x8xf32>) -> tensor<?x4x8x8xf32>
+  return %0 : tensor<?x4x8x8xf32>
+}
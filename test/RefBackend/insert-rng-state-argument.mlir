@@ -0,0 +1,39 @@
+// RUN: torch-mlir-opt %s -refback-insert-rng-state-argument -split-input-file -verify-diagnostics | FileCheck %s
+
+// CHECK-LABEL:   module attributes {refback.rng_state} {
+// CHECK-NOT:       memref.global
+// CHECK-LABEL:     func.func @forward(
+// CHECK-SAME:                         %[[ARG:.*]]: memref<2xf32>, %[[STATE:.*]]: memref<i64>) -> i64 {
+// CHECK:             %[[SEED:.*]] = memref.load %[[STATE]][] : memref<i64>
+// CHECK:             %[[NEXT_SEED:.*]] = arith.muli %[[SEED]], %{{.*}} : i64
+// CHECK:             memref.store %[[NEXT_SEED]], %[[STATE]][] : memref<i64>
+// CHECK-NOT:         memref.get_global
+// CHECK:             return %[[NEXT_SEED]] : i64
+// CHECK-LABEL:     func.func @no_rng(
+// CHECK-SAME:                        %{{.*}}: memref<i64>) {
+module {
+  memref.global "private" @global_seed : memref<i64> = dense<0>
+  func.func @forward(%arg0: memref<2xf32>) -> i64 {
+    %c127_i64 = arith.constant 127 : i64
+    %0 = memref.get_global @global_seed : memref<i64>
+    %1 = memref.load %0[] : memref<i64>
+    %2 = arith.muli %1, %c127_i64 : i64
+    %3 = memref.get_global @global_seed : memref<i64>
+    memref.store %2, %3[] : memref<i64>
+    return %2 : i64
+  }
+  func.func @no_rng() {
+    return
+  }
+}
+
+// -----
+
+// Modules without RNG are left alone.
+// CHECK-LABEL:   module {
+// CHECK:           func.func @forward(%{{.*}}: memref<2xf32>) -> memref<2xf32>
+module {
+  func.func @forward(%arg0: memref<2xf32>) -> memref<2xf32> {
+    return %arg0 : memref<2xf32>
+  }
+}
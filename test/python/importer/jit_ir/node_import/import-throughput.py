@@ -0,0 +1,60 @@
+# -*- Python -*-
+# This file is licensed under a pytorch-style license
+# See LICENSE.pytorch for license information.
+
+# Measures how fast the node importer turns a large TorchScript graph into
+# MLIR. Run it directly with a larger `--num-layers` to benchmark; under lit
+# it uses a small graph and only checks that the import succeeds.
+
+import argparse
+import time
+
+import torch
+from torch_mlir.dialects.torch.importer.jit_ir import ModuleBuilder
+
+# RUN: %PYTHON %s | FileCheck %s
+
+# CHECK: import-throughput: {{[0-9]+}} nodes in {{[0-9.]+}} s ({{[0-9.]+}} nodes/sec)
+
+
+def create_graph(num_layers: int):
+    def f(x, w, b):
+        # Tracing unrolls the loop, producing a long straight-line graph that
+        # only uses a handful of distinct schemas and types, which is the
+        # common shape of imported models.
+        for _ in range(num_layers):
+            x = torch.nn.functional.linear(x, w, b)
+            x = torch.relu(x)
+            x = x + 1.0
+        return x
+
+    example = torch.ones(4, 4)
+    return torch.jit.trace(f, (example, example, torch.ones(4)))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Benchmark the TorchScript node importer.")
+    parser.add_argument("--num-layers", type=int, default=100,
+                        help="number of unrolled layers in the graph")
+    parser.add_argument("--repeat", type=int, default=3,
+                        help="number of imports to time; the best is reported")
+    args = parser.parse_args()
+
+    graph_function = create_graph(args.num_layers)
+    num_nodes = sum(1 for _ in graph_function.graph.nodes())
+
+    best = float("inf")
+    for _ in range(args.repeat):
+        mb = ModuleBuilder()
+        start = time.perf_counter()
+        mb.import_function(graph_function)
+        best = min(best, time.perf_counter() - start)
+        assert mb.module.operation.verify()
+
+    print(f"import-throughput: {num_nodes} nodes in {best:.4f} s "
+          f"({num_nodes / best:.1f} nodes/sec)")
+
+
+if __name__ == "__main__":
+    main()